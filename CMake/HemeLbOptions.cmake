@@ -21,6 +21,7 @@ pass_option(HEMELB HEMELB_BUILD_COLLOIDS "Build the colloids option" OFF)
 # pass_option(HEMELB HEMELB_DEBUGGER_IMPLEMENTATION "Which implementation to use for the debugger" none)
 # mark_as_advanced(HEMELB_DEBUGGER_IMPLEMENTATION)
 pass_option(HEMELB HEMELB_VALIDATE_GEOMETRY "Validate geometry" OFF)
+pass_option(HEMELB HEMELB_VALIDATE_GEOMETRY_FULL "Validate geometry by comparing every block on all ranks, not by checksum" OFF)
 pass_option(HEMELB HEMELB_USE_ALL_WARNINGS_GNU "Show all compiler warnings on development builds (gnu-style-compilers)" ON)
 pass_option(HEMELB HEMELB_DEPENDENCIES_SET_RPATH "Set runtime RPATH" ON)
 
@@ -30,6 +31,12 @@ else()
   set(_default_sse3_flag OFF)
 endif()
 pass_option(HEMELB HEMELB_USE_SSE3 "Use SSE3 intrinsics" ${_default_sse3_flag})
+pass_option(HEMELB HEMELB_USE_BATCHED_COLLISION "Collide bulk fluid sites in SIMD batches" OFF)
+pass_option(HEMELB HEMELB_USE_FUSED_MRT "Apply the MRT collision as one precomputed Q x Q operator" OFF)
+pass_option(HEMELB HEMELB_USE_OPENMP "Use OpenMP threads within each MPI process" OFF)
+pass_option(HEMELB HEMELB_USE_INDEXED_HALO_RECEIVE "Receive halo distributions straight into place using MPI derived datatypes" OFF)
+pass_option(HEMELB HEMELB_USE_PERSISTENT_HALO_COMMS "Exchange halo distributions with persistent MPI requests" OFF)
+pass_option(HEMELB HEMELB_USE_COMPACT_STREAMING_INDICES "Store the streaming index tables as 32-bit offsets" OFF)
 pass_option(HEMELB HEMELB_USE_VELOCITY_WEIGHTS_FILE "Use Velocity weights file" OFF)
 
 pass_option(HEMELB HEMELB_SEPARATE_CONCERNS "Communicate for each concern separately" OFF)
@@ -78,6 +85,18 @@ pass_cachevar(HEMELB HEMELB_ALLTOALL_IMPLEMENTATION Separated
 pass_cachevar_choice(HEMELB HEMELB_STENCIL "FourPoint"
   STRING "HemeLB stencil type"
   TwoPoint ThreePoint FourPoint CosineApprox)
+pass_cachevar_choice(HEMELB HEMELB_STREAMING_PATTERN "AB"
+  STRING "Distribution storage: two arrays swapped each step (AB) or a single array updated in place (AA)"
+  AB AA)
+pass_cachevar_choice(HEMELB HEMELB_DISTRIBUTION_LAYOUT "AoS"
+  STRING "Order of the distributions in memory: by site (AoS), by direction (SoA) or by direction within blocks of 8 sites (AoSoA)"
+  AoS SoA AoSoA)
+pass_cachevar_choice(HEMELB HEMELB_DISTRIBUTION_PRECISION "double"
+  STRING "Type the distributions are stored and communicated as (collisions are always computed in double)"
+  double float)
+pass_cachevar_choice(HEMELB HEMELB_SITE_ORDERING "Blocks"
+  STRING "Order to number each process's fluid sites in, within each collision type: as read (Blocks), or along a Morton or Hilbert curve"
+  Blocks Morton Hilbert)
 
 #
 # Specify the variables requiring forwarding
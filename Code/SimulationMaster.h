@@ -48,6 +48,13 @@ namespace hemelb
       int GetProcessorCount();
 
       void RunSimulation();
+      /**
+       * Run up to the given number of time steps and return the rate
+       * achieved over all ranks, in millions of lattice site updates
+       * per second. Nothing is reported afterwards; this is for
+       * comparing variants (see TraitsRegistry.h).
+       */
+      double TimeSteps(LatticeTimeStep steps);
       lb::SimulationState const& GetState() const
       {
         return *simulationState;
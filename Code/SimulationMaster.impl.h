@@ -7,6 +7,7 @@
 
 #include "SimulationMaster.h"
 
+#include <chrono>
 #include <map>
 #include <limits>
 #include <cstdlib>
@@ -17,6 +18,7 @@
 #include "extraction/PropertyActor.h"
 #include "extraction/LbDataSourceIterator.h"
 #include "io/writers/XdrFileWriter.h"
+#include "util/Threading.h"
 #include "util/utilityFunctions.h"
 #include "geometry/Domain.h"
 #include "log/Logger.h"
@@ -54,9 +56,13 @@ namespace hemelb
         log::Logger::Log<log::Info, log::Singleton>("Reading configuration from %s", fileManager->GetInputFile().c_str());
         // Convert XML to configuration
         simConfig = configuration::SimConfig::New(fileManager->GetInputFile());
+        if (auto const& cacheDir = options.GetDecompositionCacheDir())
+            simConfig->SetDecompositionCacheDir(std::filesystem::absolute(*cacheDir));
         // Use it to initialise self
         auto builder = configuration::SimBuilder(*simConfig);
         log::Logger::Log<log::Info, log::Singleton>("Beginning Initialisation.");
+        log::Logger::Log<log::Info, log::Singleton>("Using %d MPI processes with %d threads each.",
+                                                    GetProcessorCount(), util::GetThreadCount());
         builder(*this);
     }
 
@@ -147,11 +153,32 @@ namespace hemelb
     Finalise();
   }
 
+  template<class TRAITS>
+  double SimulationMaster<TRAITS>::TimeSteps(LatticeTimeStep steps)
+  {
+    ioComms.Barrier();
+    auto const start = std::chrono::steady_clock::now();
+    LatticeTimeStep done = 0;
+    while (done < steps && simulationState->GetTimeStep() <= simulationState->GetTotalTimeSteps()
+        && !simulationState->IsTerminating())
+    {
+      DoTimeStep();
+      ++done;
+    }
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+    // The slowest rank sets the pace.
+    double const seconds = ioComms.AllReduce(elapsed.count(), MPI_MAX);
+    if (done == 0)
+      return 0.0;
+    return double(domainData->GetTotalFluidSites()) * done / seconds / 1e6;
+  }
+
   template<class TRAITS>
   void SimulationMaster<TRAITS>::Finalise()
   {
     timings[reporting::Timers::total].Stop();
     timings.Reduce();
+    timings.ReduceCounters();
     if (IsCurrentProcTheIOProc())
     {
       reporter->FillDictionary();
@@ -6,6 +6,7 @@
 #ifndef HEMELB_TRAITS_H
 #define HEMELB_TRAITS_H
 
+#include "geometry/DistributionLayout.h"
 #include "lb/Lattices.h"
 #include "lb/Kernels.h"
 #include "lb/Streamers.h"
@@ -22,7 +23,8 @@ namespace hemelb
         template<class> class WALL_BOUNDARY = lb::DefaultWallStreamer,
         template<class> class INLET_BOUNDARY = lb::DefaultInletStreamer,
         template<class> class OUTLET_BOUNDARY = lb::DefaultOutletStreamer,
-        typename STENCIL = redblood::stencil::DefaultStencil
+        typename STENCIL = redblood::stencil::DefaultStencil,
+        typename LAYOUT = geometry::DefaultLayout
     >
     struct Traits
     {
@@ -36,6 +38,7 @@ namespace hemelb
         using WallInletBoundary = typename lb::CombineWallAndIoletStreamers<WallBoundary, InletBoundary>::type;
         using WallOutletBoundary = typename lb::CombineWallAndIoletStreamers<WallBoundary, OutletBoundary>::type;
         using Stencil = STENCIL;
+        using Layout = LAYOUT;
     };
 }
 
@@ -0,0 +1,204 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_TRAITSREGISTRY_H
+#define HEMELB_TRAITSREGISTRY_H
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "SimulationMaster.h"
+#include "configuration/CommandLine.h"
+#include "configuration/SimConfig.h"
+#include "log/Logger.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb
+{
+    /**
+     * One of the combinations of Traits compiled into the executable,
+     * which the XML configuration can choose between at run time with
+     * `<simulation><variant value="name" /></simulation>`.
+     *
+     * They all use the lattice, kernel and boundary conditions chosen
+     * with CMake, as changing those would change the results, and
+     * differ only in how the simulation is carried out.
+     */
+    struct TraitsVariant
+    {
+        std::string name;
+        // Can the configured boundary conditions run with this variant?
+        bool usable;
+        std::function<void(configuration::CommandLine&, const net::IOCommunicator&)> run;
+        // Time the given number of steps, returning the rate in MLUPS.
+        std::function<double(configuration::CommandLine&, const net::IOCommunicator&, LatticeTimeStep)> measure;
+    };
+
+    namespace detail
+    {
+        template<typename LAYOUT>
+        using LayoutTraits = Traits<lb::DefaultLattice, lb::DefaultKernel, lb::Normal, lb::DefaultStreamer,
+                                    lb::DefaultWallStreamer, lb::DefaultInletStreamer, lb::DefaultOutletStreamer,
+                                    redblood::stencil::DefaultStencil, LAYOUT>;
+
+        // Mirrors the check in LBM::InitCollisions, so that an unusable
+        // variant is never built.
+        template<typename TRAITS>
+        constexpr bool usable_traits = TRAITS::Layout::layout.IsSiteContiguous()
+                || (lb::any_layout_streamer<typename TRAITS::Streamer>
+                    && lb::any_layout_streamer<typename TRAITS::WallBoundary>
+                    && lb::any_layout_streamer<typename TRAITS::InletBoundary>
+                    && lb::any_layout_streamer<typename TRAITS::OutletBoundary>
+                    && lb::any_layout_streamer<typename TRAITS::WallInletBoundary>
+                    && lb::any_layout_streamer<typename TRAITS::WallOutletBoundary>);
+
+        template<typename TRAITS>
+        TraitsVariant MakeTraitsVariant(std::string name)
+        {
+            TraitsVariant ans{std::move(name), usable_traits<TRAITS>, nullptr, nullptr};
+            if constexpr (usable_traits<TRAITS>)
+            {
+                ans.run = [](configuration::CommandLine& options, const net::IOCommunicator& comms) {
+                    SimulationMaster<TRAITS> master(options, comms);
+                    master.RunSimulation();
+                };
+                ans.measure = [](configuration::CommandLine& options, const net::IOCommunicator& comms,
+                                 LatticeTimeStep steps) {
+                    SimulationMaster<TRAITS> master(options, comms);
+                    return master.TimeSteps(steps);
+                };
+            }
+            return ans;
+        }
+    }
+
+    /// All the variants; "default" is the Traits chosen with CMake.
+    inline std::vector<TraitsVariant> const& GetTraitsVariants()
+    {
+        static std::vector<TraitsVariant> const variants{
+            detail::MakeTraitsVariant<Traits<>>("default"),
+            detail::MakeTraitsVariant<detail::LayoutTraits<geometry::layouts::AoS>>("AoS"),
+            detail::MakeTraitsVariant<detail::LayoutTraits<geometry::layouts::SoA>>("SoA"),
+            detail::MakeTraitsVariant<detail::LayoutTraits<geometry::layouts::AoSoA<8>>>("AoSoA"),
+        };
+        return variants;
+    }
+
+    inline TraitsVariant const& GetTraitsVariant(std::string const& name)
+    {
+        for (auto const& v: GetTraitsVariants())
+            if (v.name == name)
+            {
+                if (!v.usable)
+                    throw (Exception() << "Variant '" << name
+                        << "' is not supported by the chosen boundary conditions");
+                return v;
+            }
+
+        Exception e;
+        e << "Unknown variant '" << name << "'; choose \"autotune\" or one of:";
+        for (auto const& v: GetTraitsVariants())
+            e << " " << v.name;
+        throw e;
+    }
+
+    namespace detail
+    {
+        /**
+         * Create a new directory beside the output directory, named
+         * after it with "_autotune" (and a number, if that is taken)
+         * appended, for the trial simulations. Existing paths are never
+         * reused, as they may belong to the user. Collective.
+         */
+        inline std::filesystem::path MakeAutotuneDir(configuration::CommandLine const& options,
+                                                     const net::IOCommunicator& comms)
+        {
+            namespace fs = std::filesystem;
+            std::string dir;
+            if (comms.OnIORank())
+            {
+                for (int i = 0; dir.empty(); ++i)
+                {
+                    fs::path candidate = fs::absolute(options.GetOutputDir());
+                    candidate += "_autotune";
+                    if (i > 0)
+                        candidate += std::to_string(i);
+                    // create_directory is false if it already exists.
+                    if (fs::create_directory(candidate))
+                        dir = candidate.string();
+                }
+            }
+            comms.Broadcast(dir, comms.GetIORank());
+            return dir;
+        }
+    }
+
+    /**
+     * Time each usable variant for a number of steps, from the start of
+     * the simulation, and return the name of the fastest. The trials
+     * run with the given options except that each writes its output to
+     * its own subdirectory of autotuneDir.
+     */
+    inline std::string AutotuneTraitsVariant(configuration::CommandLine const& options,
+                                             const net::IOCommunicator& comms,
+                                             std::filesystem::path const& autotuneDir,
+                                             LatticeTimeStep steps)
+    {
+        std::string best;
+        double bestMlups = 0.0;
+        for (auto const& v: GetTraitsVariants())
+        {
+            // The default is one of the others under another name.
+            if (!v.usable || v.name == "default")
+                continue;
+
+            auto trialOptions = options.WithOption("-out", (autotuneDir / v.name).string());
+            double const mlups = v.measure(trialOptions, comms, steps);
+            log::Logger::Log<log::Info, log::Singleton>("Autotune: variant %s ran %d steps at %.2f MLUPS",
+                                                        v.name.c_str(), int(steps), mlups);
+            if (best.empty() || mlups > bestMlups)
+            {
+                best = v.name;
+                bestMlups = mlups;
+            }
+        }
+        log::Logger::Log<log::Info, log::Singleton>("Autotune: running with variant %s", best.c_str());
+        return best;
+    }
+
+    /**
+     * Run the simulation with the variant the XML configuration asks
+     * for. When autotuning, the trials and the real run share one
+     * domain decomposition: the configured cache if there is one, or
+     * else one kept in the autotuning directory, which is removed once
+     * the simulation is done.
+     */
+    inline void RunConfiguredSimulation(configuration::CommandLine& options, const net::IOCommunicator& comms)
+    {
+        auto const config = configuration::SimConfig::New(options.GetInputFile());
+        std::string name = config->GetTraitsVariant();
+        if (name != "autotune")
+        {
+            GetTraitsVariant(name).run(options, comms);
+            return;
+        }
+
+        auto const autotuneDir = detail::MakeAutotuneDir(options, comms);
+        auto runOptions = options;
+        if (!options.GetDecompositionCacheDir() && !config->GetDecompositionCacheDir())
+            runOptions = options.WithOption("-decomposition_cache", (autotuneDir / "decomposition").string());
+
+        name = AutotuneTraitsVariant(runOptions, comms, autotuneDir, config->GetAutotuneSteps());
+        GetTraitsVariant(name).run(runOptions, comms);
+
+        comms.Barrier();
+        if (comms.OnIORank())
+            std::filesystem::remove_all(autotuneDir);
+    }
+}
+
+#endif
@@ -30,3 +30,18 @@ int main(int count, char** v){
   return b;
 }" HAVE_XDRUINTXX_T)
 
+
+# The batched collision needs the parallelism TS's SIMD types; without
+# them, turn it off here so that the build info is truthful.
+if (HEMELB_USE_BATCHED_COLLISION)
+  CHECK_CXX_SOURCE_COMPILES("
+#include <experimental/simd>
+int main() {
+  std::experimental::native_simd<double> x = 1.0;
+  return x[0] == 1.0 ? 0 : 1;
+}" HAVE_EXPERIMENTAL_SIMD)
+  if (NOT HAVE_EXPERIMENTAL_SIMD)
+    message(WARNING "HEMELB_USE_BATCHED_COLLISION needs <experimental/simd>, which the compiler does not provide; turning it OFF")
+    set(HEMELB_USE_BATCHED_COLLISION OFF CACHE BOOL "Collide bulk fluid sites in SIMD batches" FORCE)
+  endif()
+endif()
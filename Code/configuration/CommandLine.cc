@@ -41,6 +41,10 @@ namespace hemelb::configuration
         {
           outputDir = paramValue;
         }
+        else if (paramName == "-decomposition_cache")
+        {
+          decompositionCacheDir = paramValue;
+        }
         else if (paramName == "-debug")
         {
             if (paramValue == "0") {
@@ -65,12 +69,29 @@ namespace hemelb::configuration
 
     }
 
+    CommandLine CommandLine::WithOption(std::string const& paramName, std::string const& paramValue) const
+    {
+      auto args = argv;
+      for (size_t ii = 1; ii < args.size(); ii += 2)
+      {
+        if (args[ii] == paramName)
+        {
+          args[ii + 1] = paramValue;
+          return CommandLine(args);
+        }
+      }
+      args.push_back(paramName);
+      args.push_back(paramValue);
+      return CommandLine(args);
+    }
+
     std::string CommandLine::GetUsage()
     {
         return "Correct usage: hemelb [-<Parameter Name> <Parameter Value>]* \n"
                "Parameter name and significance:\n"
                "\t-in\tPath to the configuration xml file (required)\n"
                "\t-out\tPath to the output folder (default is 'results' in same directory as the input file)\n"
+               "\t-decomposition_cache\tPath to a directory to cache the domain decomposition in (overrides the XML file)\n"
                "\t-debug\tFlag (0 or 1) to enable the hemelb debugger (default: 0)\n";
     }
 
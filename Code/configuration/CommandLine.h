@@ -9,6 +9,7 @@
 #include <vector>
 #include <string>
 #include <filesystem>
+#include <optional>
 
 #include "Exception.h"
 
@@ -19,12 +20,15 @@ namespace hemelb::configuration
      * Arguments should be:
      * - -in input xml configuration file (required)
      * - -out output folder (default "results")
+     * - -decomposition_cache directory to cache the domain decomposition
+     *   in, overriding the XML configuration (optional)
      */
     class CommandLine
     {
     private:
         std::filesystem::path inputFile; //! local or full path to input file
         std::filesystem::path outputDir; //! local or full path to output directory
+        std::optional<std::filesystem::path> decompositionCacheDir; //! overrides the XML configuration's
         bool debugMode = false; //! Use debugger
         std::vector<std::string> argv; //! command line arguments
 
@@ -69,6 +73,14 @@ namespace hemelb::configuration
             return inputFile;
         }
 
+        /**
+         * @return The directory given to cache the domain decomposition in, if any.
+         */
+        [[nodiscard]] inline std::optional<std::filesystem::path> const& GetDecompositionCacheDir() const
+        {
+            return decompositionCacheDir;
+        }
+
         /**
          * @return Whether the user requested a debug mode.
          */
@@ -92,6 +104,13 @@ namespace hemelb::configuration
         {
             return argv;
         }
+
+        /**
+         * A copy of these options with the given parameter set to a
+         * new value (or added, if it was not given), e.g. to run with
+         * another output directory.
+         */
+        [[nodiscard]] CommandLine WithOption(std::string const& paramName, std::string const& paramValue) const;
     };
 }
 
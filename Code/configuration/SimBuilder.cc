@@ -43,13 +43,14 @@ namespace hemelb::configuration {
         geometry::GeometryReader reader(lat_info,
                                         timings,
                                         ioComms);
-        return reader.LoadAndDecompose(config.GetDataFilePath());
+        return reader.LoadAndDecompose(config.GetDataFilePath(), config.GetDecompositionCacheDir());
     }
 
     lb::LbmParameters SimBuilder::BuildLbmParams() const {
         auto&& i = config.sim_info;
         lb::LbmParameters ans(i.time.step_s, i.space.step_m, i.fluid.density_kgm3, i.fluid.viscosity_Pas);
         ans.StressType = i.stress_type;
+        ans.RheologyTableTolerance = i.fluid.rheology_table_tolerance;
         return ans;
     }
 
@@ -6,6 +6,7 @@
 #ifndef HEMELB_CONFIGURATION_SIMBUILDER_H
 #define HEMELB_CONFIGURATION_SIMBUILDER_H
 
+#include "build_info.h"
 #include "configuration/SimConfig.h"
 #include "extraction/LbDataSourceIterator.h"
 #include "extraction/PropertyActor.h"
@@ -143,9 +144,13 @@ namespace hemelb::configuration {
         log::Logger::Log<log::Info, log::Singleton>("Initialising domain.");
         control.domainData = std::make_shared<geometry::Domain>(lat_info,
                                                                 readGeometryData,
-                                                                ioComms);
+                                                                ioComms,
+                                                                traitsType::Layout::layout);
         log::Logger::Log<log::Info, log::Singleton>("Initialising field data.");
-        control.fieldData = std::make_shared<geometry::FieldData>(control.domainData);
+        control.fieldData = std::make_shared<geometry::FieldData>(
+                control.domainData,
+                build_info::STREAMING_PATTERN == "AA" ? geometry::StreamingPattern::AA : geometry::StreamingPattern::AB
+        );
         things_to_report.push_back(control.domainData.get());
         timings[reporting::Timers::latDatInitialise].Stop();
 
@@ -168,6 +168,25 @@ namespace hemelb::configuration
                 [](io::xml::Element const& el) {
                     return GetDimensionalValue<PhysicalPressure>(el, "mmHg");
                 }).value_or(0);
+
+        // Optional element (default = 0, i.e. don't tabulate)
+        // <rheology_table_tolerance value="float" units="dimensionless" />
+        sim_info.fluid.rheology_table_tolerance = simEl.GetChildOrNull("rheology_table_tolerance").transform(
+                [](io::xml::Element const& el) {
+                    return GetDimensionalValue<double>(el, "dimensionless");
+                }).value_or(0);
+
+        // Optional element (default = "default", i.e. as configured with CMake)
+        // <variant value="string" />
+        sim_info.variant.name = simEl.GetChildOrNull("variant").transform(
+                [](io::xml::Element const& el) {
+                    return std::string(el.GetAttributeOrThrow("value"));
+                }).value_or("default");
+
+        // Optional element (default = 200)
+        // <autotune_steps value="unsigned" units="lattice" />
+        sim_info.variant.autotune_steps = GetDimensionalValueWithDefault<std::uint64_t>(
+                simEl, "autotune_steps", "lattice", 200);
     }
 
     void SimConfig::DoIOForGeometry(const io::xml::Element geometryEl)
@@ -175,8 +194,11 @@ namespace hemelb::configuration
       // Required element
       // <geometry>
       //  <datafile path="relative path to GMY" />
+      //  <decomposition_cache path="relative path to directory" /> (optional)
       // </geometry>
       dataFilePath = RelPathToFullPath(geometryEl.GetChildOrThrow("datafile").GetAttributeOrThrow("path"));
+      if (auto cacheEl = geometryEl.GetChildOrNull("decomposition_cache"))
+        decompositionCacheDir = RelPathToFullPath(cacheEl.GetAttributeOrThrow("path"));
     }
 
     /**
@@ -7,6 +7,7 @@
 #define HEMELB_CONFIGURATION_SIMCONFIG_H
 
 #include <optional>
+#include <string>
 #include <variant>
 #include <vector>
 
@@ -122,6 +123,13 @@ namespace hemelb::configuration
         PhysicalDensity density_kgm3;
         PhysicalDynamicViscosity viscosity_Pas;
         PhysicalPressure reference_pressure_mmHg;
+        double rheology_table_tolerance;
+    };
+
+    // Which of the built-in Traits to run with (see TraitsRegistry.h).
+    struct VariantInfo {
+        std::string name;
+        std::uint64_t autotune_steps;
     };
 
     struct GlobalSimInfo {
@@ -129,6 +137,7 @@ namespace hemelb::configuration
         TimeInfo time;
         SpaceInfo space;
         FluidInfo fluid;
+        VariantInfo variant;
     };
 
     struct FlowExtensionConfig {
@@ -288,6 +297,16 @@ namespace hemelb::configuration
         {
           return dataFilePath;
         }
+        // Directory to cache the domain decomposition in, if any.
+        const std::optional<path>& GetDecompositionCacheDir() const
+        {
+          return decompositionCacheDir;
+        }
+        // E.g. from the command line, which takes precedence over the XML.
+        void SetDecompositionCacheDir(path const& dir)
+        {
+          decompositionCacheDir = dir;
+        }
         LatticeTimeStep GetTotalTimeSteps() const
         {
           return sim_info.time.total_steps;
@@ -308,6 +327,14 @@ namespace hemelb::configuration
         {
           return sim_info.space.geometry_origin_m;
         }
+        const std::string& GetTraitsVariant() const
+        {
+          return sim_info.variant.name;
+        }
+        LatticeTimeStep GetAutotuneSteps() const
+        {
+          return sim_info.variant.autotune_steps;
+        }
         unsigned int PropertyOutputCount() const
         {
           return propertyOutputs.size();
@@ -441,6 +468,7 @@ namespace hemelb::configuration
     private:
         path xmlFilePath;
         path dataFilePath;
+        std::optional<path> decompositionCacheDir;
 
         std::vector<extraction::PropertyOutputFile> propertyOutputs;
         /**
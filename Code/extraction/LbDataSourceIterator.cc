@@ -5,8 +5,24 @@
 
 #include "extraction/LbDataSourceIterator.h"
 
+#include <type_traits>
+
 namespace hemelb::extraction
 {
+    namespace
+    {
+      // The values can only be handed out in place if they are stored
+      // as distribn_t.
+      template<typename T>
+      const distribn_t* InPlace(const T* f)
+      {
+        if constexpr (std::is_same_v<T, distribn_t>)
+          return f;
+        else
+          return nullptr;
+      }
+    }
+
     LbDataSourceIterator::LbDataSourceIterator(const lb::MacroscopicPropertyCache& propertyCache,
                                                const geometry::FieldData& data, int rank_,
                                                std::shared_ptr<util::UnitConverter> converter) :
@@ -75,8 +91,22 @@ namespace hemelb::extraction
 
     const distribn_t* LbDataSourceIterator::GetDistribution() const
     {
-      auto site = data.GetSite(position);
-      return site.GetFOld(data.GetDomain().GetLatticeInfo().GetNumVectors());
+      if (data.GetStreamingPattern() == geometry::StreamingPattern::AA)
+      {
+        distributionBuffer.resize(GetNumVectors());
+        data.GetStreamedDistributions(position, distributionBuffer.data());
+        return distributionBuffer.data();
+      }
+      auto const& dom = data.GetDomain();
+      if (DISTRIBUTIONS_STORED_IN_FULL && dom.GetDistributionLayout().IsSiteContiguous())
+      {
+        auto site = data.GetSite(position);
+        return InPlace(site.GetFOld(dom.GetLatticeInfo().GetNumVectors()));
+      }
+      distributionBuffer.resize(GetNumVectors());
+      for (Direction i = 0; i < GetNumVectors(); ++i)
+        distributionBuffer[i] = *data.GetFOld(dom.GetDistributionIndex(position, i));
+      return distributionBuffer.data();
     }
 
     void LbDataSourceIterator::Reset()
@@ -91,6 +91,11 @@ namespace hemelb::extraction
 
         /**
          * Returns a pointer to the velocity distribution of a site.
+         *
+         * With the AA streaming pattern the distributions from the start
+         * of the step no longer exist, so those streamed by the step are
+         * returned instead (copied, as they may not be contiguous). The
+         * pointer is only valid until the next call.
          * @return pointer to a velocity distribution
          */
         [[nodiscard]] const distribn_t* GetDistribution() const override;
@@ -164,6 +169,10 @@ namespace hemelb::extraction
          * Iteration variable for tracking progress through all the local fluid sites.
          */
         site_t position;
+        /**
+         * Space to gather a site's distributions when they are not contiguous.
+         */
+        mutable std::vector<distribn_t> distributionBuffer;
     };
 }
 
@@ -146,15 +146,14 @@ namespace hemelb::extraction {
 			      << " but should be read at " << index;
 	}
 
-	distribn_t* f_old_p = latDat->GetFOld(iSite * NUMVECTORS);
-	distribn_t* f_new_p = latDat->GetFNew(iSite * NUMVECTORS);
 	// distField is read on IO rank and checked to be equal to
 	// NUMVECTORS so we use that instead of broadcasting and
 	// storing.
 	for (auto i = 0U; i < NUMVECTORS; i++) {
 	  distribn_t field_val;
 	  dataReader.read(field_val);
-	  f_new_p[i] = f_old_p[i] = field_val;
+	  auto const idx = dom.GetDistributionIndex(iSite, i);
+	  *latDat->GetFNew(idx) = *latDat->GetFOld(idx) = field_val;
 	}
       }
 
@@ -0,0 +1,164 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H
+#define HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H
+
+#include <bit>
+
+#include "build_info.h"
+#include "Exception.h"
+#include "units.h"
+
+namespace hemelb::geometry
+{
+    /**
+     * Where, in the fOld/fNew arrays, the distribution of a local fluid
+     * site in a given direction lives. Whatever the layout, the local
+     * sites' distributions come first (possibly with some padding),
+     * then the single "rubbish" slot, then the distributions shared
+     * with neighbouring processes.
+     *
+     * The three layouts are all described by
+     *
+     *   index = (site >> shift) * blockStride + direction * directionStride + (site & mask)
+     *
+     * so that no branching is needed to find an index.
+     */
+    class DistributionLayout
+    {
+    public:
+        enum class Kind {
+            // Array of structures: all Q values of a site are adjacent.
+            AoS,
+            // Structure of arrays: the values for one direction are
+            // adjacent for all sites.
+            SoA,
+            // Array of structures of arrays: sites are grouped into
+            // blocks of Width(), which are stored SoA internally.
+            AoSoA
+        };
+
+        // Sites are padded to a multiple of this for SoA, so each
+        // direction starts on a fresh cache line.
+        static constexpr site_t SOA_PADDING = 8;
+
+        constexpr DistributionLayout() = default;
+        constexpr explicit DistributionLayout(Kind k, unsigned width = 1) : kind(k), width(width) {
+        }
+
+        //! Work out the strides for the given number of local sites
+        //! and lattice vectors.
+        void Initialise(site_t localSites, unsigned numVectors)
+        {
+            switch (kind) {
+                case Kind::AoS:
+                    shift = 0;
+                    mask = 0;
+                    blockStride = numVectors;
+                    directionStride = 1;
+                    storageSize = localSites * numVectors;
+                    break;
+                case Kind::SoA: {
+                    auto const padded = (localSites + SOA_PADDING - 1) / SOA_PADDING * SOA_PADDING;
+                    // site >> 63 is zero for any valid site and site & ~0 is the site.
+                    shift = 63;
+                    mask = ~site_t(0);
+                    blockStride = 0;
+                    directionStride = padded;
+                    storageSize = padded * numVectors;
+                    break;
+                }
+                case Kind::AoSoA: {
+                    if (!std::has_single_bit(width))
+                        throw (Exception() << "AoSoA block width must be a power of two, not " << width);
+                    auto const blocks = (localSites + width - 1) / width;
+                    shift = std::countr_zero(width);
+                    mask = site_t(width) - 1;
+                    blockStride = site_t(width) * numVectors;
+                    directionStride = width;
+                    storageSize = blocks * blockStride;
+                    break;
+                }
+            }
+        }
+
+        inline site_t Index(site_t site, Direction direction) const
+        {
+            return (site >> shift) * blockStride + direction * directionStride + (site & mask);
+        }
+
+        //! Number of slots taken by the local sites, including any
+        //! padding; the rubbish slot is at this index.
+        inline site_t GetStorageSize() const
+        {
+            return storageSize;
+        }
+
+        //! Are the Q values of a site adjacent in memory (i.e. can be
+        //! viewed as a span)?
+        constexpr bool IsSiteContiguous() const
+        {
+            return kind == Kind::AoS;
+        }
+
+        inline Kind GetKind() const
+        {
+            return kind;
+        }
+
+        inline unsigned GetWidth() const
+        {
+            return width;
+        }
+
+    private:
+        Kind kind = Kind::AoS;
+        unsigned width = 1;
+        int shift = 0;
+        site_t mask = 0;
+        site_t blockStride = 0;
+        site_t directionStride = 1;
+        site_t storageSize = 0;
+    };
+
+    // Tag types to choose the layout in the Traits.
+    namespace layouts
+    {
+        struct AoS
+        {
+            static constexpr DistributionLayout layout{DistributionLayout::Kind::AoS};
+        };
+        struct SoA
+        {
+            static constexpr DistributionLayout layout{DistributionLayout::Kind::SoA};
+        };
+        template <unsigned WIDTH>
+        struct AoSoA
+        {
+            static_assert(std::has_single_bit(WIDTH), "AoSoA block width must be a power of two");
+            static constexpr DistributionLayout layout{DistributionLayout::Kind::AoSoA, WIDTH};
+        };
+
+        namespace detail {
+            constexpr auto get_default_layout() {
+                constexpr auto LAYOUT = build_info::DISTRIBUTION_LAYOUT;
+                if constexpr (LAYOUT == "AoS") {
+                    return AoS{};
+                } else if constexpr (LAYOUT == "SoA") {
+                    return SoA{};
+                } else if constexpr (LAYOUT == "AoSoA") {
+                    // Eight doubles fill a cache line and an AVX-512 register.
+                    return AoSoA<8>{};
+                } else {
+                    throw (Exception() << "Configured with invalid DISTRIBUTION_LAYOUT");
+                }
+            }
+        }
+    }
+    using DefaultLayout = decltype(layouts::detail::get_default_layout());
+}
+
+#endif // HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H
@@ -3,6 +3,11 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <algorithm>
+#include <limits>
+#include <span>
+
+#include "build_info.h"
 #include "log/Logger.h"
 #include "geometry/BlockTraverser.h"
 #include "geometry/Domain.h"
@@ -24,8 +29,10 @@ namespace hemelb::geometry
         }
 
         Domain::Domain(const lb::LatticeInfo& latticeInfo,
-                       GmyReadResult& readResult, const net::IOCommunicator& comms_) :
-                latticeInfo(latticeInfo), shared_counts(comms_, 0),
+                       GmyReadResult& readResult, const net::IOCommunicator& comms_,
+                       DistributionLayout layout, SiteOrdering ordering) :
+                latticeInfo(latticeInfo), distributionLayout(layout), siteOrdering(ordering),
+                shared_counts(comms_, 0),
                 neighbouringData(new neighbouring::NeighbouringDomain(latticeInfo)),
                 rank_for_site_store(std::move(readResult.block_store)),
                 comms(comms_)
@@ -306,14 +313,26 @@ namespace hemelb::geometry
                 MidDomainCollisionCount(collisionType) = midDomainBlockNumbers[collisionType].size();
                 DomainEdgeCollisionCount(collisionType) = domainEdgeBlockNumbers[collisionType].size();
             }
+            // The order to number the sites of one collision type in. The
+            // ranges are kept, so that the LB can still update them one
+            // type at a time; every index table is built from this
+            // numbering afterwards.
+            auto siteOrder = [this](std::vector<site_t> const& blockNumbers,
+                                    std::vector<site_t> const& siteNumbers) {
+                std::vector<util::Vector3D<site_t>> coords(blockNumbers.size());
+                for (std::size_t i = 0; i < coords.size(); ++i)
+                    coords[i] = GetGlobalCoords(blockNumbers[i], GetSiteCoordsFromSiteId(siteNumbers[i]));
+                return OrderSites(coords, siteOrdering);
+            };
+
             // Data about local sites.
             SiteRankIndex rank_index = {comms.Rank(), 0};
             auto& localFluidSites = rank_index[1];
             // Data about contiguous local sites. First midDomain stuff, then domainEdge.
             for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; collisionType++)
             {
-                for (unsigned indexInType = 0; indexInType < GetMidDomainCollisionCount(collisionType);
-                     indexInType++)
+                for (site_t indexInType: siteOrder(midDomainBlockNumbers[collisionType],
+                                                   midDomainSiteNumbers[collisionType]))
                 {
                     siteData.push_back(midDomainSiteData[collisionType][indexInType]);
                     wallNormalAtSite.emplace_back(midDomainWallNormals[collisionType][indexInType]);
@@ -334,8 +353,8 @@ namespace hemelb::geometry
 
             for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; collisionType++)
             {
-                for (unsigned indexInType = 0; indexInType < GetDomainEdgeCollisionCount(collisionType);
-                     indexInType++)
+                for (site_t indexInType: siteOrder(domainEdgeBlockNumbers[collisionType],
+                                                   domainEdgeSiteNumbers[collisionType]))
                 {
                     siteData.push_back(domainEdgeSiteData[collisionType][indexInType]);
                     wallNormalAtSite.emplace_back(domainEdgeWallNormals[collisionType][indexInType]);
@@ -404,6 +423,11 @@ namespace hemelb::geometry
         void Domain::InitialiseNeighbourLookups()
         {
             log::Logger::Log<log::Info, log::Singleton>("Initialising neighbour lookups");
+            distributionLayout.Initialise(GetLocalFluidSiteCount(), latticeInfo.GetNumVectors());
+            // The streaming tables index the whole distribution array:
+            // the local sites, the rubbish slot and the shared ones.
+            CheckStreamingIndexRange<streaming_index_t>(distributionLayout.GetStorageSize() + 1 + totalSharedFs,
+                                                        comms.Rank());
             // Allocate the index in which to put the distribution functions received from the other
             // process.
             //auto sharedDistributionLocationForEachProc = std::vector<std::vector<site_t> >(comms.Size());
@@ -413,13 +437,15 @@ namespace hemelb::geometry
             {
                 // Pointing to a few things, but not setting any variables.
                 // FirstSharedF points to start of shared_fs.
-                neighbouringProc.FirstSharedDistribution = GetLocalFluidSiteCount()
-                                                                         * latticeInfo.GetNumVectors() + 1 + totalSharedDistributionsSoFar;
+                neighbouringProc.FirstSharedDistribution = distributionLayout.GetStorageSize()
+                                                                         + 1 + totalSharedDistributionsSoFar;
                 totalSharedDistributionsSoFar += neighbouringProc.SharedDistributionCount;
             }
             auto sharedDistributionLocationForEachProc = InitialiseNeighbourLookup();
             InitialisePointToPointComms(sharedDistributionLocationForEachProc);
             InitialiseReceiveLookup(sharedDistributionLocationForEachProc);
+            if constexpr (build_info::USE_INDEXED_HALO_RECEIVE)
+                InitialiseSharedDistributionTypes();
         }
 
         auto Domain::InitialiseNeighbourLookup() -> proc2neighdata
@@ -446,7 +472,7 @@ namespace hemelb::geometry
                     auto currentLocationCoords = lowest_site_in_block + siteTraverser.GetCurrentLocation();
                     // Set neighbour location for the distribution component at the centre of
                     // this site.
-                    SetNeighbourLocation(localIndex, 0, localIndex * latticeInfo.GetNumVectors() + 0);
+                    SetNeighbourLocation(localIndex, 0, GetDistributionIndex(localIndex, 0));
                     for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); direction++)
                     {
                         // Work out positions of neighbours.
@@ -456,7 +482,7 @@ namespace hemelb::geometry
                             // Set the neighbour location to the rubbish site.
                             SetNeighbourLocation(localIndex,
                                                  direction,
-                                                 GetLocalFluidSiteCount() * latticeInfo.GetNumVectors());
+                                                 distributionLayout.GetStorageSize());
                             continue;
                         }
                         // Get the id of the processor which the neighbouring site lies on.
@@ -466,7 +492,7 @@ namespace hemelb::geometry
                             // initialize f_id to the rubbish site.
                             SetNeighbourLocation(localIndex,
                                                  direction,
-                                                 GetLocalFluidSiteCount() * latticeInfo.GetNumVectors());
+                                                 distributionLayout.GetStorageSize());
                             continue;
                         }
                         else
@@ -482,7 +508,7 @@ namespace hemelb::geometry
                             site_t contigSiteId = GetContiguousSiteId(neighbourCoords);
                             SetNeighbourLocation(localIndex,
                                                  direction,
-                                                 contigSiteId * latticeInfo.GetNumVectors() + direction);
+                                                 GetDistributionIndex(contigSiteId, direction));
                             continue;
                         }
                         else
@@ -549,7 +575,7 @@ namespace hemelb::geometry
         {
             proc_t localRank = comms.Rank();
             streamingIndicesForReceivedDistributions.resize(totalSharedFs);
-            site_t f_count = GetLocalFluidSiteCount() * latticeInfo.GetNumVectors();
+            site_t f_count = distributionLayout.GetStorageSize();
             site_t sharedSitesSeen = 0;
             for (auto& neighbouringProc: neighbouringProcs) {
                 for (site_t sharedDistributionId = 0;
@@ -570,8 +596,8 @@ namespace hemelb::geometry
                     SetNeighbourLocation(contigSiteId, (unsigned int) ( (l)), ++f_count);
                     // Set the place where we put the received distribution functions, which is
                     // f_new[number of fluid site that sends, inverse direction].
-                    streamingIndicesForReceivedDistributions[sharedSitesSeen] = contigSiteId
-                                                                                * latticeInfo.GetNumVectors() + latticeInfo.GetInverseIndex(l);
+                    streamingIndicesForReceivedDistributions[sharedSitesSeen] =
+                            GetDistributionIndex(contigSiteId, latticeInfo.GetInverseIndex(l));
                     ++sharedSitesSeen;
                 }
 
@@ -579,6 +605,38 @@ namespace hemelb::geometry
 
         }
 
+        void Domain::InitialiseSharedDistributionTypes()
+        {
+            auto freeType = [](MPI_Datatype* type) {
+                int finalized;
+                HEMELB_MPI_CALL(MPI_Finalized, (&finalized));
+                if (!finalized)
+                    HEMELB_MPI_CALL(MPI_Type_free, (type));
+                delete type;
+            };
+
+            // Displacements are in bytes, from the start of the array,
+            // to stay clear of int overflow on large domains.
+            const MPI_Aint elementSize = sizeof(distribn_storage_t);
+            const site_t firstShared = neighbouringProcs.empty() ? 0 : neighbouringProcs[0].FirstSharedDistribution;
+            sharedDistributionTypes.clear();
+            for (auto const& proc: neighbouringProcs)
+            {
+                auto indices = std::span(streamingIndicesForReceivedDistributions)
+                        .subspan(proc.FirstSharedDistribution - firstShared, proc.SharedDistributionCount);
+                std::vector<MPI_Aint> displacements(indices.size());
+                std::transform(indices.begin(), indices.end(), displacements.begin(),
+                               [&](site_t i) { return MPI_Aint(i) * elementSize; });
+
+                auto type = std::shared_ptr<MPI_Datatype>(new MPI_Datatype(MPI_DATATYPE_NULL), freeType);
+                HEMELB_MPI_CALL(MPI_Type_create_hindexed_block,
+                                ((int) displacements.size(), 1, displacements.data(),
+                                 net::MpiDataType<distribn_storage_t>(), type.get()));
+                HEMELB_MPI_CALL(MPI_Type_commit, (type.get()));
+                sharedDistributionTypes.push_back(std::move(type));
+            }
+        }
+
     SiteRankIndex Domain::GetRankIndexFromGlobalCoords(const util::Vector3D<site_t> &globalSiteCoords) const {
         // Block identifiers (i, j, k) of the site (site_i, site_j, site_k)
         Vec16 blockCoords, localSiteCoords;
@@ -6,6 +6,8 @@
 #ifndef HEMELB_GEOMETRY_DOMAIN_H
 #define HEMELB_GEOMETRY_DOMAIN_H
 
+#include <concepts>
+#include <limits>
 #include <memory>
 #include <map>
 #include <vector>
@@ -13,10 +15,13 @@
 #include <boost/container/flat_map.hpp>
 
 #include "constants.h"
+#include "Exception.h"
 #include "units.h"
 #include "geometry/Block.h"
+#include "geometry/DistributionLayout.h"
 #include "geometry/NeighbouringProcessor.h"
 #include "geometry/Site.h"
+#include "geometry/SiteOrdering.h"
 #include "geometry/SiteDataBare.h"
 #include "lb/lattices/LatticeInfo.h"
 #include "reporting/Reportable.h"
@@ -36,6 +41,22 @@ namespace hemelb::net {
 namespace hemelb::reporting {
     class Dict;
 }
+
+namespace hemelb::geometry
+{
+    // Check that a rank's distribution array, of distributionCount
+    // entries (the local sites, the rubbish slot and the shared ones),
+    // can be indexed by streaming tables of Index: streaming_index_t
+    // is 32 bits with HEMELB_USE_COMPACT_STREAMING_INDICES.
+    template<std::integral Index>
+    void CheckStreamingIndexRange(site_t distributionCount, proc_t rank)
+    {
+        if (distributionCount - 1 > site_t(std::numeric_limits<Index>::max()))
+            throw (Exception() << "Rank " << rank << " has " << distributionCount
+                   << " distributions, too many to index with HEMELB_USE_COMPACT_STREAMING_INDICES;"
+                   << " use more processes or turn it off");
+    }
+}
 namespace hemelb::tests::helpers {
     // Friend class to access all of domain_type's internals in tests
     class LatticeDataAccess;
@@ -64,7 +85,9 @@ namespace hemelb::geometry
         friend class Site; //! Let the inner classes have access to site-related data that's otherwise private.
 
         Domain(const lb::LatticeInfo& latticeInfo, GmyReadResult& readResult,
-               const net::IOCommunicator& comms);
+               const net::IOCommunicator& comms,
+               DistributionLayout layout = DistributionLayout{},
+               SiteOrdering ordering = GetDefaultSiteOrdering());
 
         ~Domain() noexcept override;
 
@@ -173,6 +196,24 @@ namespace hemelb::geometry
             return blocks[GetBlockOctIndexFromBlockCoords(blockCoords)];
         }
 
+        /**
+         * Get the arrangement of the distributions in memory.
+         * @return
+         */
+        inline const DistributionLayout& GetDistributionLayout() const
+        {
+          return distributionLayout;
+        }
+
+        /**
+         * Get the index into the distribution arrays of the given local
+         * site's distribution in the given direction.
+         */
+        inline site_t GetDistributionIndex(site_t siteIndex, Direction direction) const
+        {
+          return distributionLayout.Index(siteIndex, direction);
+        }
+
         /**
          * Get the number of fluid sites local to this proc.
          * @return
@@ -383,6 +424,7 @@ namespace hemelb::geometry
         void InitialisePointToPointComms(
                 proc2neighdata& sharedFLocationForEachProc);
         void InitialiseReceiveLookup(proc2neighdata const& sharedFLocationForEachProc);
+        void InitialiseSharedDistributionTypes();
 
         sitedata_t GetSiteData(site_t iSiteI, site_t iSiteJ, site_t iSiteK) const;
 
@@ -396,7 +438,7 @@ namespace hemelb::geometry
         inline void SetNeighbourLocation(const site_t siteIndex, const unsigned int direction,
                                          const site_t distributionIndex)
         {
-          neighbourIndices[siteIndex * latticeInfo.GetNumVectors() + direction] = distributionIndex;
+          neighbourIndices[siteIndex * latticeInfo.GetNumVectors() + direction] = streaming_index_t(distributionIndex);
         }
 
         Vec16 GetBlockIJK(site_t block) const;
@@ -428,7 +470,7 @@ namespace hemelb::geometry
          * site in the geometry.
          */
         template<typename LatticeType>
-        site_t GetStreamedIndex(site_t iSiteIndex, unsigned int iDirectionIndex) const
+        streaming_index_t GetStreamedIndex(site_t iSiteIndex, unsigned int iDirectionIndex) const
         {
           return neighbourIndices[iSiteIndex * LatticeType::NUMVECTORS + iDirectionIndex];
         }
@@ -493,6 +535,8 @@ namespace hemelb::geometry
          * Basic lattice variables.
          */
         const lb::LatticeInfo& latticeInfo;
+        DistributionLayout distributionLayout; //! Where each site's distributions are stored.
+        SiteOrdering siteOrdering = SiteOrdering::Blocks; //! The order the sites of each collision type are numbered in.
         Vec16 blockCounts;
         U16 blockSize;
         util::Vector3D<site_t> sites;
@@ -523,8 +567,13 @@ namespace hemelb::geometry
         std::vector<site_t> fluidSitesOnEachProcessor; //! Array containing numbers of fluid sites on each processor.
         site_t totalFluidSites; //! The total number of fluid sites in the geometry.
         util::Vector3D<site_t> globalSiteMins, globalSiteMaxes; //! The minimal and maximal coordinates of any fluid sites.
-        std::vector<site_t> neighbourIndices; //! Data about neighbouring fluid sites.
-        std::vector<site_t> streamingIndicesForReceivedDistributions; //! The indices to stream to for distributions received from other processors.
+        std::vector<streaming_index_t> neighbourIndices; //! Data about neighbouring fluid sites.
+        std::vector<streaming_index_t> streamingIndicesForReceivedDistributions; //! The indices to stream to for distributions received from other processors.
+        //! With HEMELB_USE_INDEXED_HALO_RECEIVE, for each neighbouring
+        //! processor, an MPI datatype that picks the slots its shared
+        //! distributions stream to out of a whole distribution array,
+        //! so they can be received (and, for the AA pattern, sent) in place.
+        std::vector<std::shared_ptr<MPI_Datatype>> sharedDistributionTypes;
         std::shared_ptr<neighbouring::NeighbouringDomain> neighbouringData;
         std::unique_ptr<octree::DistributedStore> rank_for_site_store;
         const net::IOCommunicator& comms;
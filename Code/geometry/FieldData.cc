@@ -5,41 +5,151 @@
 
 #include "geometry/FieldData.h"
 
+#include <algorithm>
+
+#include "build_info.h"
 #include "geometry/NeighbouringProcessor.h"
 #include "geometry/neighbouring/NeighbouringDomain.h"
 #include "lb/lattices/LatticeInfo.h"
 #include "net/net.h"
 
 namespace hemelb::geometry {
-    FieldData::FieldData(std::shared_ptr <domain_type> d) :
+    FieldData::FieldData(std::shared_ptr <domain_type> d, StreamingPattern pattern) :
             m_domain{d},
             m_currentDistributions(CalcDistSize(*d)),
-            m_nextDistributions(CalcDistSize(*d)),
+            m_pattern{pattern},
             m_force(d->GetLocalFluidSiteCount()),
             m_neighbouringFields{std::make_unique<neighbouring::NeighbouringFieldData>(d->neighbouringData)} {
-
+        if (m_pattern == StreamingPattern::AA) {
+            if (!build_info::USE_INDEXED_HALO_RECEIVE)
+                m_haloBuffer.resize(d->totalSharedFs);
+        } else {
+            m_nextDistributions.resize(CalcDistSize(*d));
+        }
     }
 
     std::size_t FieldData::CalcDistSize(Domain const &d) {
-        return d.GetLocalFluidSiteCount() * d.latticeInfo.GetNumVectors() + 1 + d.totalSharedFs;
+        return d.GetDistributionLayout().GetStorageSize() + 1 + d.totalSharedFs;
     }
 
-    void FieldData::SendAndReceive(net::Net *net) {
+    template <typename Comms>
+    void FieldData::RequestHaloExchange(Comms &comms) {
+        if constexpr (build_info::USE_INDEXED_HALO_RECEIVE) {
+            // The shared distributions go straight between the slots
+            // they are streamed to (on the receiving side, and on the
+            // sending side after an even AA step) and the contiguous
+            // shared area, as described by the domain's datatypes.
+            auto const &dom = GetDomain();
+            for (std::size_t i = 0; i < dom.neighbouringProcs.size(); ++i) {
+                auto const &proc = dom.neighbouringProcs[i];
+                auto const type = *dom.sharedDistributionTypes[i];
+                if (m_pattern == StreamingPattern::AA && !m_oddStep) {
+                    comms.template RequestReceive<distribn_storage_t>(GetFOld(proc.FirstSharedDistribution),
+                                                                      (int) proc.SharedDistributionCount,
+                                                                      proc.Rank);
+                    comms.RequestSendDatatype(m_currentDistributions.data(), proc.Rank, type);
+                } else {
+                    // After an odd AA step, as with AB, nothing on this
+                    // process writes to the slots being received into.
+                    comms.RequestReceiveDatatype(GetFNew(0), proc.Rank, type);
+                    comms.template RequestSend<distribn_storage_t>(GetFNew(proc.FirstSharedDistribution),
+                                                                   (int) proc.SharedDistributionCount,
+                                                                   proc.Rank);
+                }
+            }
+            return;
+        }
+
+        if (m_pattern == StreamingPattern::AA) {
+            // On even steps the sites leave their outgoing distributions
+            // in their own slots; these are gathered into the halo buffer
+            // by PrepareSends and the neighbours' arrive directly in the
+            // shared area, where the odd step will look for them. On odd
+            // steps the streamers write straight into the shared area and
+            // what arrives must be scattered by CopyReceived.
+            auto const &dom = GetDomain();
+            for (auto const &proc: dom.neighbouringProcs) {
+                auto halo = &m_haloBuffer[proc.FirstSharedDistribution
+                                          - dom.neighbouringProcs[0].FirstSharedDistribution];
+                if (m_oddStep) {
+                    comms.template RequestReceive<distribn_storage_t>(halo, (int) proc.SharedDistributionCount, proc.Rank);
+                    comms.template RequestSend<distribn_storage_t>(GetFNew(proc.FirstSharedDistribution),
+                                                                   (int) proc.SharedDistributionCount,
+                                                                   proc.Rank);
+                } else {
+                    comms.template RequestReceive<distribn_storage_t>(GetFOld(proc.FirstSharedDistribution),
+                                                                      (int) proc.SharedDistributionCount,
+                                                                      proc.Rank);
+                    comms.template RequestSend<distribn_storage_t>(halo, (int) proc.SharedDistributionCount, proc.Rank);
+                }
+            }
+            return;
+        }
+
         for (auto const &proc: GetDomain().neighbouringProcs) {
             // Request the receive into the appropriate bit of FOld.
-            net->RequestReceive<distribn_t>(GetFOld(proc.FirstSharedDistribution),
-                                            (int) proc.SharedDistributionCount,
-                                            proc.Rank);
+            comms.template RequestReceive<distribn_storage_t>(GetFOld(proc.FirstSharedDistribution),
+                                                              (int) proc.SharedDistributionCount,
+                                                              proc.Rank);
             // Request the send from the right bit of FNew.
-            net->RequestSend<distribn_t>(GetFNew(proc.FirstSharedDistribution),
-                                         (int) proc.SharedDistributionCount,
-                                         proc.Rank);
+            comms.template RequestSend<distribn_storage_t>(GetFNew(proc.FirstSharedDistribution),
+                                                           (int) proc.SharedDistributionCount,
+                                                           proc.Rank);
 
         }
     }
 
+    void FieldData::SendAndReceive(net::Net *net) {
+        if constexpr (build_info::USE_PERSISTENT_HALO_COMMS) {
+            // The exchange is the same every other step, so reuse the
+            // requests made for this arrangement of the arrays.
+            auto const *current = m_currentDistributions.data();
+            auto const *next = m_nextDistributions.data();
+            auto found = std::find_if(m_persistentHalos.begin(), m_persistentHalos.end(),
+                                      [&](PersistentHalo const &halo) {
+                                          return halo.current == current && halo.next == next
+                                                 && halo.oddStep == m_oddStep;
+                                      });
+            if (found == m_persistentHalos.end()) {
+                if (m_persistentHalos.size() == 2)
+                    m_persistentHalos.erase(m_persistentHalos.begin());
+                auto requests = std::make_unique<net::PersistentRequests>(net->GetCommunicator());
+                RequestHaloExchange(*requests);
+                m_persistentHalos.push_back({current, next, m_oddStep, std::move(requests)});
+                found = m_persistentHalos.end() - 1;
+            }
+            net->RequestPersistent(*found->requests);
+        } else {
+            RequestHaloExchange(*net);
+        }
+    }
+
+    void FieldData::PrepareSends() {
+        if (build_info::USE_INDEXED_HALO_RECEIVE || m_pattern != StreamingPattern::AA || m_oddStep)
+            return;
+
+        // The value for shared slot i was written to the slot it would
+        // have been received into if it had come the other way.
+        auto const &dom = GetDomain();
+        for (site_t i = 0; i < dom.totalSharedFs; i++) {
+            m_haloBuffer[i] = m_currentDistributions[dom.streamingIndicesForReceivedDistributions[i]];
+        }
+    }
+
     void FieldData::CopyReceived() {
+        if (build_info::USE_INDEXED_HALO_RECEIVE)
+            return;
+
         auto const &dom = GetDomain();
+        if (m_pattern == StreamingPattern::AA) {
+            if (m_oddStep) {
+                for (site_t i = 0; i < dom.totalSharedFs; i++) {
+                    m_currentDistributions[dom.streamingIndicesForReceivedDistributions[i]] = m_haloBuffer[i];
+                }
+            }
+            return;
+        }
+
         // Copy the distribution functions received from the neighbouring
         // processors into the destination buffer "f_new".
         for (site_t i = 0; i < dom.totalSharedFs; i++) {
@@ -48,4 +158,29 @@ namespace hemelb::geometry {
         }
     }
 
-}
\ No newline at end of file
+    void FieldData::GetStreamedDistributions(site_t siteIndex, distribn_t* out) const {
+        auto const &dom = GetDomain();
+        auto const Q = dom.GetLatticeInfo().GetNumVectors();
+
+        if (m_pattern == StreamingPattern::AB || m_oddStep) {
+            for (Direction i = 0; i < Q; ++i) {
+                out[i] = *GetFNew(dom.GetDistributionIndex(siteIndex, i));
+            }
+            return;
+        }
+
+        // After an even AA step, a population heading into this site is
+        // still in the upstream neighbour, in the slot of the reversed
+        // direction - unless it was bounced back into this site by a
+        // wall or iolet.
+        auto const site = GetSite(siteIndex);
+        for (Direction i = 0; i < Q; ++i) {
+            auto const inv = dom.GetLatticeInfo().GetInverseIndex(i);
+            if (site.HasWall(inv) || site.HasIolet(inv)) {
+                out[i] = m_currentDistributions[dom.GetDistributionIndex(siteIndex, i)];
+            } else {
+                out[i] = m_currentDistributions[dom.neighbourIndices[siteIndex * Q + inv]];
+            }
+        }
+    }
+}
@@ -16,6 +16,7 @@
 #include "geometry/Domain.h"
 #include "geometry/Site.h"
 #include "geometry/neighbouring/NeighbouringDomain.h"
+#include "net/PersistentRequests.h"
 #include "util/Vector3D.h"
 
 namespace hemelb::net { class Net; }
@@ -23,6 +24,21 @@ namespace hemelb::tests::helpers { class LatticeDataAccess; }
 
 namespace hemelb::geometry {
 
+    // How the distributions are stored between time steps.
+    enum class StreamingPattern {
+        // Two arrays, fOld and fNew, swapped at the end of every step.
+        AB,
+        // A single array updated in place (Bailey et al. 2009). Steps
+        // alternate between an even step, which reads a site's own
+        // slots and writes the post-collision values back to the same
+        // site in the slot of the reversed direction, and an odd step,
+        // which reads from and writes to the neighbours' slots. After
+        // an odd step the array is in the same layout as fOld after an
+        // AB step. This halves both the memory footprint and the
+        // memory traffic of the distributions.
+        AA
+    };
+
     // Hold field data across a geometry, as described by a domain_type.
     class FieldData {
     public:
@@ -32,18 +48,34 @@ namespace hemelb::geometry {
     protected:
         std::shared_ptr <domain_type> m_domain;
         // For now just, list our fields.
-        std::vector <distribn_t> m_currentDistributions; //! The distribution values at the start of the current time step.
-        std::vector <distribn_t> m_nextDistributions; //! The distribution values for the next time step.
+        std::vector <distribn_storage_t> m_currentDistributions; //! The distribution values at the start of the current time step.
+        std::vector <distribn_storage_t> m_nextDistributions; //! The distribution values for the next time step.
+        StreamingPattern m_pattern = StreamingPattern::AB;
+        bool m_oddStep = false; //! Only meaningful for the AA pattern.
+        //! With the AA pattern, the shared distributions go in both
+        //! directions through this buffer on alternate steps.
+        std::vector <distribn_storage_t> m_haloBuffer;
         std::vector <LatticeForceVector> m_force; //! Holds the force vector at a fluid site
 
         std::unique_ptr <neighbouring::NeighbouringFieldData> m_neighbouringFields;
 
+        //! With HEMELB_USE_PERSISTENT_HALO_COMMS, the halo exchange for
+        //! each arrangement of the arrays it has been made with (the
+        //! two alternate between steps).
+        struct PersistentHalo {
+            distribn_storage_t const *current;
+            distribn_storage_t const *next;
+            bool oddStep;
+            std::unique_ptr <net::PersistentRequests> requests;
+        };
+        std::vector <PersistentHalo> m_persistentHalos;
+
         static std::size_t CalcDistSize(Domain const &d);
 
     public:
         FieldData() = default;
 
-        FieldData(std::shared_ptr <domain_type> d);
+        FieldData(std::shared_ptr <domain_type> d, StreamingPattern pattern = StreamingPattern::AB);
 
         // Access the domain
         inline domain_type const &GetDomain() const {
@@ -54,6 +86,15 @@ namespace hemelb::geometry {
             return *m_domain.get();
         }
 
+        inline StreamingPattern GetStreamingPattern() const {
+            return m_pattern;
+        }
+
+        //! Is the current step an odd one of the AA pattern?
+        inline bool IsOddStep() const {
+            return m_oddStep;
+        }
+
         inline neighbouring::NeighbouringFieldData &GetNeighbouringData() {
             return *m_neighbouringFields;
         }
@@ -114,7 +155,7 @@ namespace hemelb::geometry {
          * @return
          */
         // Method should remain protected, intent is to access this information via Site
-        inline distribn_t *GetFOld(site_t distributionIndex) {
+        inline distribn_storage_t *GetFOld(site_t distributionIndex) {
             return &m_currentDistributions[distributionIndex];
         }
 
@@ -126,7 +167,7 @@ namespace hemelb::geometry {
          * @return
          */
         // Method should remain protected, intent is to access this information via Site
-        inline const distribn_t *GetFOld(site_t distributionIndex) const {
+        inline const distribn_storage_t *GetFOld(site_t distributionIndex) const {
             return &m_currentDistributions[distributionIndex];
         }
 
@@ -135,14 +176,18 @@ namespace hemelb::geometry {
          * @param distributionIndex
          * @return
          */
-        inline distribn_t *GetFNew(site_t distributionIndex) {
-            return &m_nextDistributions[distributionIndex];
+        inline distribn_storage_t *GetFNew(site_t distributionIndex) {
+            return &NextDistributions()[distributionIndex];
         }
 
+        // The span overloads of GetFNew may only be used when the
+        // distribution layout keeps a site's values together; otherwise
+        // use ReadFNew.
         template <typename LatticeType>
         auto GetFNew(site_t site_idx) {
             constexpr auto Q = LatticeType::NUMVECTORS;
-            return MutDistSpan<Q>{&m_nextDistributions[site_idx * Q], Q};
+            HASSERT(m_domain->GetDistributionLayout().IsSiteContiguous());
+            return std::span<distribn_storage_t, Q>{&NextDistributions()[m_domain->GetDistributionIndex(site_idx, 0)], Q};
         }
 
         /**
@@ -151,19 +196,41 @@ namespace hemelb::geometry {
          * @param distributionIndex
          * @return
          */
-        inline const distribn_t *GetFNew(site_t distributionIndex) const {
-            return &m_nextDistributions[distributionIndex];
+        inline const distribn_storage_t *GetFNew(site_t distributionIndex) const {
+            return &NextDistributions()[distributionIndex];
         }
 
         template <typename LatticeType>
         auto GetFNew(site_t site_idx) const {
             constexpr auto Q = LatticeType::NUMVECTORS;
-            return ConstDistSpan<Q>{&m_nextDistributions[site_idx * Q], Q};
+            HASSERT(m_domain->GetDistributionLayout().IsSiteContiguous());
+            return std::span<const distribn_storage_t, Q>{&NextDistributions()[m_domain->GetDistributionIndex(site_idx, 0)], Q};
         }
 
-        //! Swap the fOld and fNew arrays around.
+        //! A site's fNew values as distribn_t: in place if that is how
+        //! they are stored and the layout keeps them together, otherwise
+        //! copied into buffer.
+        template <typename LatticeType>
+        ConstDistSpan<LatticeType::NUMVECTORS> ReadFNew(site_t site_idx,
+                                                        std::span<distribn_t, LatticeType::NUMVECTORS> buffer) const {
+            if constexpr (DISTRIBUTIONS_STORED_IN_FULL) {
+                if (m_domain->GetDistributionLayout().IsSiteContiguous())
+                    return GetFNew<LatticeType>(site_idx);
+            }
+            auto const& next = NextDistributions();
+            for (Direction i = 0; i < LatticeType::NUMVECTORS; ++i)
+                buffer[i] = next[m_domain->GetDistributionIndex(site_idx, i)];
+            return buffer;
+        }
+
+        //! Swap the fOld and fNew arrays around (for the AA pattern,
+        //! where they are the same array, move on to the next step).
         inline void SwapOldAndNew() {
-            m_currentDistributions.swap(m_nextDistributions);
+            if (m_pattern == StreamingPattern::AA) {
+                m_oddStep = !m_oddStep;
+            } else {
+                m_currentDistributions.swap(m_nextDistributions);
+            }
         }
 
         //! Reset forces to some constant value
@@ -209,8 +276,33 @@ namespace hemelb::geometry {
 
         void SendAndReceive(net::Net *net);
 
+        //! Fill any send buffers that are not written to directly by
+        //! the streamers. Must be called after the domain edge sites
+        //! have been updated and before the sends are made.
+        void PrepareSends();
+
         void CopyReceived();
 
+        //! Copy the distributions that the step just completed has
+        //! streamed to a site (i.e. those the next step will collide)
+        //! into out, whatever the streaming pattern.
+        void GetStreamedDistributions(site_t siteIndex, distribn_t* out) const;
+
+    private:
+        // Request this step's halo exchange from comms, which is either
+        // a Net or a net::PersistentRequests.
+        template <typename Comms>
+        void RequestHaloExchange(Comms &comms);
+
+        // With the AA pattern there is no separate fNew.
+        inline std::vector <distribn_storage_t> &NextDistributions() {
+            return m_pattern == StreamingPattern::AA ? m_currentDistributions : m_nextDistributions;
+        }
+
+        inline std::vector <distribn_storage_t> const &NextDistributions() const {
+            return m_pattern == StreamingPattern::AA ? m_currentDistributions : m_nextDistributions;
+        }
+
     };
 }
 #endif // once
\ No newline at end of file
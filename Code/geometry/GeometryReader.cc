@@ -4,8 +4,12 @@
 // license in the file LICENSE.
 
 #include <cmath>
+#include <cstring>
+#include <exception>
 #include <list>
+#include <map>
 #include <algorithm>
+#include <numeric>
 #include <utility>
 #include <zlib.h>
 
@@ -66,6 +70,9 @@ namespace hemelb::geometry
     using WallNormalAvailabilityValidator = EnumValidator<gmy::WallNormalAvailability,
             gmy::WallNormalAvailability::NOT_AVAILABLE,
             gmy::WallNormalAvailability::AVAILABLE>;
+    using CodecValidator = EnumValidator<gmy::Codec,
+            gmy::Codec::NONE,
+            gmy::Codec::ZLIB>;
 
     GeometryReader::GeometryReader(const lb::LatticeInfo& latticeInfo,
                                    reporting::Timers &atimings, net::IOCommunicator ioComm) :
@@ -77,7 +84,8 @@ namespace hemelb::geometry
     {
     }
 
-    GmyReadResult GeometryReader::LoadAndDecompose(const std::string& dataFilePath)
+    GmyReadResult GeometryReader::LoadAndDecompose(const std::string& dataFilePath,
+                                                   const std::optional<std::filesystem::path>& decompositionCacheDir)
     {
         timings[reporting::Timers::fileRead].Start();
 
@@ -95,6 +103,13 @@ namespace hemelb::geometry
         ReadHeader(geometry.GetBlockCount());
         timings[reporting::Timers::fileRead].Stop();
 
+        std::optional<decomposition::DecompositionCache> cache;
+        if (decompositionCacheDir) {
+            cache.emplace(*decompositionCacheDir, dataFilePath, headerChecksum,
+                          latticeInfo.GetNumVectors(), computeComms);
+            computeDataChecksum = true;
+        }
+
         {
             timings[reporting::Timers::initialDecomposition].Start();
             principalProcForEachBlock.resize(geometry.GetBlockCount());
@@ -134,16 +149,21 @@ namespace hemelb::geometry
             timings[reporting::Timers::initialDecomposition].Stop();
         }
 
+        if (cache) {
+            if (auto cached = cache->Load(); cached && UseCachedDecomposition(geometry, *cached)) {
+                ReportPeakMemory();
+                return geometry;
+            }
+        }
+
         timings[reporting::Timers::fileRead].Start();
-        {
-          std::vector<U64> blocks_wanted;
-          blocks_wanted.reserve((2*nFluidBlocks) / computeComms.Size());
-          for (U64 i = 0; i < nFluidBlocks; ++i) {
-            if (procForBlockOct[i] == computeComms.Rank())
-              blocks_wanted.push_back(i);
-          }
-          ReadInBlocksWithHalo(geometry, blocks_wanted);
+        std::vector<U64> blocks_wanted;
+        blocks_wanted.reserve((2*nFluidBlocks) / computeComms.Size());
+        for (U64 i = 0; i < nFluidBlocks; ++i) {
+          if (procForBlockOct[i] == computeComms.Rank())
+            blocks_wanted.push_back(i);
         }
+        ReadInBlocksWithHalo(geometry, blocks_wanted);
         if constexpr (build_info::VALIDATE_GEOMETRY) {
             ValidateGeometry(geometry);
         }
@@ -155,7 +175,7 @@ namespace hemelb::geometry
         // Having done an initial decomposition of the geometry, and read in the data, we optimise the
         // domain decomposition.
         log::Logger::Log<log::Debug, log::OnePerCore>("Beginning domain decomposition optimisation");
-        OptimiseDomainDecomposition(geometry, principalProcForEachBlock);
+        OptimiseDomainDecomposition(geometry, blocks_wanted, cache);
         log::Logger::Log<log::Debug, log::OnePerCore>("Ending domain decomposition optimisation");
 
         if constexpr (build_info::VALIDATE_GEOMETRY) {
@@ -165,9 +185,24 @@ namespace hemelb::geometry
 
         timings[reporting::Timers::domainDecomposition].Stop();
 
+        ReportPeakMemory();
         return geometry;
     }
 
+    void GeometryReader::ReportPeakMemory() const
+    {
+        long const peak = util::PeakMemoryUsage();
+        log::Logger::Log<log::Debug, log::OnePerCore>("Peak memory after decomposition %li kB", peak);
+
+        auto const minPeak = computeComms.AllReduce(peak, MPI_MIN);
+        auto const maxPeak = computeComms.AllReduce(peak, MPI_MAX);
+        auto const totalPeak = computeComms.AllReduce(peak, MPI_SUM);
+        log::Logger::Log<log::Info, log::Singleton>(
+            "Peak memory per rank during decomposition: min %li kB, mean %li kB, max %li kB",
+            minPeak, totalPeak / computeComms.Size(), maxPeak
+        );
+    }
+
     std::vector<char> GeometryReader::ReadAllProcesses(std::size_t start, unsigned nBytes)
     {
         // result
@@ -189,6 +224,8 @@ namespace hemelb::geometry
     {
       std::vector<char> preambleBuffer = ReadAllProcesses(0, gmy::PreambleLength);
 
+      headerChecksum = crc32(0, reinterpret_cast<const Bytef*>(preambleBuffer.data()), gmy::PreambleLength);
+
       // Create an Xdr translator based on the read-in data.
       auto preambleReader = io::XdrMemReader(preambleBuffer.data(),
                                                            gmy::PreambleLength);
@@ -215,12 +252,14 @@ namespace hemelb::geometry
             << " Actual: " << gmyMagicNumber;
       }
 
-      if (version != gmy::VersionNumber)
+      if (version != gmy::VersionNumber && version != gmy::VersionNumberV5)
       {
         throw Exception() << "Version number incorrect."
             << " Supported: " << unsigned(gmy::VersionNumber)
+            << " and " << unsigned(gmy::VersionNumberV5)
             << " Input: " << version;
       }
+      gmyVersion = version;
 
       // Variables we'll read.
       // We use temporary vars here, as they must be the same size as the type in the file
@@ -239,9 +278,10 @@ namespace hemelb::geometry
       read_check(blocksZ);
       read_check(blockSize);
 
-      // Read the padding unsigned int.
+      // Read the padding unsigned int, which for version 5 is the codec.
       unsigned paddingValue;
       preambleReader.read(paddingValue);
+      codec = gmyVersion == gmy::VersionNumberV5 ? CodecValidator::Run(paddingValue) : gmy::Codec::ZLIB;
 
       return {Vec16(blocksX, blocksY, blocksZ), U16(blockSize)};
     }
@@ -250,22 +290,48 @@ namespace hemelb::geometry
      * Read the header section, with minimal information about each block.
      *
      * Results are placed in the member arrays fluidSitesPerBlock,
-     * bytesPerCompressedBlock and bytesPerUncompressedBlock.
+     * bytesPerCompressedBlock, bytesPerUncompressedBlock and
+     * blockOffsets.
      */
     void GeometryReader::ReadHeader(site_t blockCount)
     {
       site_t headerByteCount = GetHeaderLength(blockCount);
       std::vector<char> headerBuffer = ReadAllProcesses(gmy::PreambleLength, headerByteCount);
-
-      // Create a Xdr translation object to translate from binary
-      auto preambleReader = io::XdrMemReader(headerBuffer.data(),
-                                             headerByteCount);
+      headerChecksum = crc32(headerChecksum, reinterpret_cast<const Bytef*>(headerBuffer.data()), headerByteCount);
 
       fluidSitesOnEachBlock.reserve(blockCount);
       bytesPerCompressedBlock.reserve(blockCount);
       bytesPerUncompressedBlock.reserve(blockCount);
+      blockOffsets.reserve(blockCount);
+      std::size_t const dataStart = gmy::PreambleLength + headerByteCount;
+
+      if (gmyVersion == gmy::VersionNumberV5) {
+        // The offsets are given; check the blocks are in order, as
+        // we stream through the file.
+        std::size_t previousEnd = dataStart;
+        for (site_t block = 0; block < blockCount; block++)
+        {
+          gmy::BlockIndexRecordV5 record;
+          std::memcpy(&record, &headerBuffer[block * gmy::HeaderRecordLengthV5], sizeof(record));
+          gmy::LittleEndian(record);
+          if (record.offset < previousEnd)
+            throw Exception() << "Malformed GMY file, block " << block << " overlaps the one before";
+          previousEnd = record.offset + record.compressedBytes;
+
+          fluidSitesOnEachBlock.push_back(record.fluidSites);
+          bytesPerCompressedBlock.push_back(record.compressedBytes);
+          bytesPerUncompressedBlock.push_back(record.uncompressedBytes);
+          blockOffsets.push_back(record.offset);
+        }
+        return;
+      }
+
+      // Create a Xdr translation object to translate from binary
+      auto preambleReader = io::XdrMemReader(headerBuffer.data(),
+                                             headerByteCount);
 
       // Read in all the data.
+      std::size_t offset = dataStart;
       for (site_t block = 0; block < blockCount; block++)
       {
         unsigned int sites, bytes, uncompressedBytes;
@@ -276,6 +342,9 @@ namespace hemelb::geometry
         fluidSitesOnEachBlock.push_back(sites);
         bytesPerCompressedBlock.push_back(bytes);
         bytesPerUncompressedBlock.push_back(uncompressedBytes);
+        // Blocks follow one another
+        blockOffsets.push_back(offset);
+        offset += bytes;
       }
     }
 
@@ -301,53 +370,146 @@ namespace hemelb::geometry
     }
 
 
-    // Return a map from block gmy index to compressed data, for
-    // those blocks that where the predicate returns true
-    template <std::predicate<std::size_t> PredT>
-    auto GeometryReader::ReadCompressedBlockData(GmyReadResult const& geometry, PredT&& want) -> block_cache {
-        // Strategy: read the entire file once and filter out those
-        // blocks we want.
+    // Call f(i) for each i in [0, n), spread over the OpenMP
+    // threads. An exception thrown by any call is rethrown here.
+    template <typename F>
+    void ParallelForEach(std::size_t n, F&& f) {
+        std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (std::size_t i = 0; i < n; ++i) {
+            try {
+                f(i);
+            } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
 
+    // Stream the blocks from the file, passing those for which the
+    // predicate is true of their GMY index to process, one chunk at a
+    // time.
+    template <std::predicate<std::size_t> PredT,
+              std::invocable<std::vector<GeometryReader::CompressedBlock> const&> ProcessT>
+    void GeometryReader::StreamCompressedBlockData(GmyReadResult const& geometry, PredT&& want, ProcessT&& process) {
+        // Strategy: the node leaders read the blocks wanted by any
+        // rank on their node and every rank filters out those it
+        // wants.
+        //
+        // A version 4 file must be read in its entirety, since a
+        // block's position is only known from the sizes of all the
+        // blocks before it; so must any file whose data is to be
+        // checksummed. Then the leaders read the whole file
+        // collectively. A version 5 file gives each block's position,
+        // so otherwise each leader reads only its node's blocks,
+        // independently.
+        //
         // Going to read the file in large chunks (but note using
-        // whole blocks) and only on the node leaders (using
-        // collective MPI IO). Going to use the node communicator to
-        // set up a shared memory allocation to hold this and then
-        // filter in parallel.
+        // whole blocks). Going to use the node communicator to set up
+        // a shared memory allocation to hold this and then filter in
+        // parallel.
+        //
+        // The buffer is in two halves: while every rank on the node
+        // works on the chunk in one half, the leader reads the next
+        // chunk into the other.
         constexpr auto MiB = std::size_t(1) << 20;
         constexpr std::size_t MAX_GMY_BUFFER_SIZE = 64U * MiB;
 
-        log::Logger::Log<log::Info, log::Singleton>("Streaming geometry data and caching required blocks.");
+        log::Logger::Log<log::Info, log::Singleton>("Streaming geometry data and parsing required blocks.");
         log::Logger::Log<log::Debug, log::Singleton>("Maximum buffer size %lu B", MAX_GMY_BUFFER_SIZE);
 
-        block_cache ans;
-
         // Work out where blocks live in the gmy **file**
         std::size_t const nBlocksGmy = bytesPerCompressedBlock.size();
         log::Logger::Log<log::Debug, log::Singleton>("Number of GMY blocks %lu", nBlocksGmy);
-        std::size_t const dataStart = gmy::PreambleLength + GetHeaderLength(geometry.GetBlockCount());
-
-        // N + 1 elements, elem i holds the start of block i, elem i+1 holds the end
-        auto const blockBoundsGmy = [&] () {
-            std::vector<std::size_t> ans(nBlocksGmy + 1);
-            ans[0] = dataStart;
-            std::inclusive_scan(
-                bytesPerCompressedBlock.begin(), bytesPerCompressedBlock.end(),
-                ans.begin() + 1, std::plus<std::size_t>(), dataStart
-            );
-            return ans;
-        }();
+        auto block_start = [&](std::size_t i) -> std::size_t {
+            return blockOffsets[i];
+        };
+        auto block_end = [&](std::size_t i) -> std::size_t {
+            return blockOffsets[i] + bytesPerCompressedBlock[i];
+        };
+
+        auto&& nodeComm = computeComms.GetNodeComm();
+
+        // The predicate may only be asked about each block once, in order.
+        std::vector<bool> wanted(nBlocksGmy);
+        for (std::size_t i = 0; i < nBlocksGmy; ++i)
+            wanted[i] = want(i);
+
+        bool const readAll = gmyVersion != gmy::VersionNumberV5 || computeDataChecksum;
+        std::vector<std::size_t> toRead;
+        if (readAll) {
+            toRead.resize(nBlocksGmy);
+            std::iota(toRead.begin(), toRead.end(), 0);
+        } else {
+            std::vector<U64> nodeWants((nBlocksGmy + 63) / 64, 0);
+            for (std::size_t i = 0; i < nBlocksGmy; ++i)
+                if (wanted[i])
+                    nodeWants[i / 64] |= U64(1) << (i % 64);
+            nodeWants = nodeComm.AllReduce(nodeWants, MPI_BOR);
+            for (std::size_t i = 0; i < nBlocksGmy; ++i)
+                if (nodeWants[i / 64] >> (i % 64) & 1)
+                    toRead.push_back(i);
+        }
+        log::Logger::Log<log::Debug, log::Singleton>("Reading %lu of the GMY blocks", toRead.size());
+
+        // Runs of consecutive blocks are read in one go, including
+        // any gaps between them. Size each half of the buffer to hold
+        // them all, up to the maximum, but at least the largest block.
+        auto continues_run = [&](std::size_t k) {
+            return k > 0 && toRead[k - 1] + 1 == toRead[k];
+        };
+        std::size_t chunk_buf_size = 1;
+        {
+            std::size_t totalBytes = 0;
+            for (std::size_t k = 0; k < toRead.size(); ++k) {
+                auto const b = toRead[k];
+                totalBytes += continues_run(k) ? block_end(b) - block_end(b - 1) : bytesPerCompressedBlock[b];
+                chunk_buf_size = std::max<std::size_t>(chunk_buf_size, bytesPerCompressedBlock[b]);
+            }
+            chunk_buf_size = std::max(chunk_buf_size, std::min(totalBytes, MAX_GMY_BUFFER_SIZE / 2));
+        }
+
+        // Split the blocks to read into chunks that fit in half the
+        // buffer. Chunk c is toRead[chunkStarts[c], chunkStarts[c+1])
+        // and the k-th block to read is at bufferPos[k] in its
+        // chunk's half.
+        std::vector<std::size_t> chunkStarts{0};
+        std::vector<std::size_t> bufferPos(toRead.size());
+        std::vector<std::size_t> chunkBytes;
+        std::size_t used = 0;
+        for (std::size_t k = 0; k < toRead.size(); ++k) {
+          auto const b = toRead[k];
+          bool const newChunk = k == chunkStarts.back();
+          std::size_t start = used;
+          if (!newChunk && continues_run(k))
+            start += block_start(b) - block_end(b - 1);
+          if (!newChunk && start + bytesPerCompressedBlock[b] > chunk_buf_size) {
+            chunkBytes.push_back(used);
+            chunkStarts.push_back(k);
+            start = 0;
+          }
+          bufferPos[k] = start;
+          used = start + bytesPerCompressedBlock[b];
+        }
+        if (!toRead.empty()) {
+          chunkBytes.push_back(used);
+          chunkStarts.push_back(toRead.size());
+        }
+        std::size_t const nChunks = chunkStarts.size() - 1;
 
         log::Logger::Log<log::Debug, log::Singleton>("Setup node level shared memory");
 
         MPI_Win win;
         char* local_buf = nullptr;
 
-        // Full size of buffer across node communicator
-        auto total_buf_size = std::min(blockBoundsGmy[nBlocksGmy] - blockBoundsGmy[0],
-                                       MAX_GMY_BUFFER_SIZE);
-
-        auto&& nodeComm = computeComms.GetNodeComm();
-        auto local_buf_size = (total_buf_size - 1) / nodeComm.Size() + 1;
+        auto local_buf_size = (2 * chunk_buf_size - 1) / nodeComm.Size() + 1;
 
         // Need contiguous memory.
         // Note local_buf has pointer into that process's "bit" of memory
@@ -356,57 +518,93 @@ namespace hemelb::geometry
         );
         // Get the whole thing's start address
         char* buf = local_buf - nodeComm.Rank() * local_buf_size;
+        auto chunk_buf = [&](std::size_t c) {
+            return buf + (c % 2) * chunk_buf_size;
+        };
 
         // Open a passive access epoch to the shared buffer
         net::MpiCall{MPI_Win_lock_all}(MPI_MODE_NOCHECK, win);
 
-        // Get to work reading chunks
-        std::size_t const* blockBoundsGmy_end = &*blockBoundsGmy.end();
-        for (std::size_t i_first_block = 0; i_first_block < nBlocksGmy; /* end of loop */) {
-          // Given we know which block we're starting at, figure out
-          // the most whole blocks we can fit in the buffer.
-          auto first_block_ptr = &blockBoundsGmy[i_first_block];
-          auto max_read_pos = *first_block_ptr + total_buf_size;
-          // upper bound gives the first elem after max_read_pos or _end if none
-          auto end_ptr = std::upper_bound(first_block_ptr, blockBoundsGmy_end, max_read_pos) - 1;
-          std::size_t n_blocks = end_ptr - first_block_ptr;
-          auto read_size = *end_ptr - *first_block_ptr;
-          log::Logger::Log<log::Debug, log::Singleton>("Reading blocks from %lu count %lu", i_first_block, n_blocks);
-
-          // Only read on node leader
+        // Only the leaders read: the whole file is one run per chunk,
+        // read collectively on the leaders comm; otherwise each run is
+        // read independently.
+        auto start_read = [&](std::size_t c) {
+          std::vector<MPI_Request> reqs;
           if (computeComms.AmNodeLeader()) {
-            auto sp = std::span<char>(buf, read_size);
-            // Collective on leaders comm
-            file.ReadAtAll(*first_block_ptr, sp);
+            log::Logger::Log<log::Debug, log::Singleton>("Reading blocks from %lu count %lu",
+                                                         toRead[chunkStarts[c]], chunkStarts[c + 1] - chunkStarts[c]);
+            for (auto k = chunkStarts[c]; k < chunkStarts[c + 1]; ) {
+              auto last = k + 1;
+              while (last < chunkStarts[c + 1] && continues_run(last))
+                ++last;
+              auto sp = std::span<char>(chunk_buf(c) + bufferPos[k],
+                                        block_end(toRead[last - 1]) - block_start(toRead[k]));
+              reqs.push_back(readAll ? file.IReadAtAll(block_start(toRead[k]), sp)
+                                     : file.IReadAt(block_start(toRead[k]), sp));
+              k = last;
+            }
           }
-          // Need to wait for leader to read
+          return reqs;
+        };
+        // Everyone on the node waits for the leader to finish
+        // reading, which also means everyone has finished with the
+        // chunk that was in that half of the buffer before.
+        auto finish_read = [&](std::vector<MPI_Request>& reqs) {
+          timings[reporting::Timers::readBlock].Start();
+          net::MpiCall{MPI_Waitall}(int(reqs.size()), reqs.data(), MPI_STATUSES_IGNORE);
+          timings[reporting::Timers::readBlock].Stop();
+          timings[reporting::Timers::readNet].Start();
           nodeComm.Barrier();
           // Sync the memory
           net::MpiCall{MPI_Win_sync}(win);
+          timings[reporting::Timers::readNet].Stop();
+        };
+
+        uLong checksum = crc32(0, Z_NULL, 0);
+        std::vector<CompressedBlock> chunk_blocks;
 
-          // Now we've read a chunk of the file. Go through it,
-          // copying out the blocks we want.
-          for (std::size_t i = 0; i < n_blocks; ++i) {
-            auto block_gmy = i_first_block + i;
-            if (want(block_gmy)) {
-              // Recall std::map::operator[] will create the element.
-              auto& block_data = ans[block_gmy];
-              block_data.resize(bytesPerCompressedBlock[block_gmy]);
-
-              auto buf_pos = blockBoundsGmy[block_gmy] - blockBoundsGmy[i_first_block];
-              std::memcpy(block_data.data(), &buf[buf_pos], bytesPerCompressedBlock[block_gmy]);
+        std::vector<MPI_Request> reqs;
+        if (nChunks > 0) {
+          reqs = start_read(0);
+          finish_read(reqs);
+        }
+        for (std::size_t c = 0; c < nChunks; ++c) {
+          if (c + 1 < nChunks)
+            reqs = start_read(c + 1);
+
+          // Now we've got a chunk of the file. Go through it,
+          // picking out the blocks we want.
+          char const* chunk = chunk_buf(c);
+          if (computeDataChecksum && computeComms.AmNodeLeader())
+            checksum = crc32(checksum, reinterpret_cast<const Bytef*>(chunk), chunkBytes[c]);
+
+          chunk_blocks.clear();
+          for (auto k = chunkStarts[c]; k < chunkStarts[c + 1]; ++k) {
+            auto const block_gmy = toRead[k];
+            if (wanted[block_gmy]) {
+              chunk_blocks.push_back({
+                  site_t(block_gmy),
+                  {chunk + bufferPos[k], bytesPerCompressedBlock[block_gmy]}
+              });
             }
           }
+          process(chunk_blocks);
 
-          i_first_block += n_blocks;
+          if (c + 1 < nChunks)
+            finish_read(reqs);
         }
         // Close the access epoch
         net::MpiCall{MPI_Win_unlock_all}(win);
         // and free the window & buffer
         net::MpiCall{MPI_Win_free}(&win);
 
-        log::Logger::Log<log::Debug, log::Singleton>("Finished caching blocks");
-        return ans;
+        if (computeDataChecksum) {
+          // Every leader read the whole file
+          nodeComm.Broadcast(checksum, 0);
+          dataChecksum = checksum;
+        }
+
+        log::Logger::Log<log::Debug, log::Singleton>("Finished streaming blocks");
     }
 
     /**
@@ -422,11 +620,13 @@ namespace hemelb::geometry
      * - Collectively read the file, filtering blocks to ranks that
      *   want them.
      *
-     * - Deserialise those blocks into the geometry.
+     * - Deserialise those blocks into the geometry, a chunk at a time
+     *   as the next chunk is read.
      */
     void GeometryReader::ReadInBlocksWithHalo(GmyReadResult& geometry,
                                               const std::vector<U64>& blocksWanted)
     {
+      timings[reporting::Timers::readBlocksAll].Start();
       // Create a list of which blocks to read in.
       timings[reporting::Timers::readBlocksPrelim].Start();
 
@@ -448,8 +648,9 @@ namespace hemelb::geometry
       // only have to test one value at a time and bump the iterator
       // forward when it matches.
       std::sort(wanted_gmys.begin(), wanted_gmys.end());
+      timings[reporting::Timers::readBlocksPrelim].Stop();
 
-      auto compressed_block_data = ReadCompressedBlockData(
+      StreamCompressedBlockData(
           geometry,
           [lower=wanted_gmys.cbegin(), upper=wanted_gmys.cend()] (std::size_t gmy) mutable {
             if (lower != upper && *lower == gmy) {
@@ -458,53 +659,75 @@ namespace hemelb::geometry
             } else {
               return false;
             }
+          },
+          [&](std::vector<CompressedBlock> const& blocks) {
+            DeserialiseBlocks(geometry, blocks);
           }
       );
+      timings[reporting::Timers::readBlocksAll].Stop();
+    }
 
-      for (auto& [gmy_idx, data]: compressed_block_data) {
-        DeserialiseBlock(geometry, data, gmy_idx);
+    void GeometryReader::DeserialiseBlocks(GmyReadResult& geometry, std::vector<CompressedBlock> const& blocks)
+    {
+      // Decompress them all, then parse them all, so each phase can
+      // be timed as a whole.
+      std::vector<std::vector<char>> uncompressed(blocks.size());
+      // Uncompressed blocks are parsed straight from the read buffer.
+      auto block_data = [&](std::size_t i) -> std::span<char const> {
+        return codec == gmy::Codec::NONE ? blocks[i].data : std::span<char const>(uncompressed[i]);
+      };
+      if (codec != gmy::Codec::NONE) {
+        timings[reporting::Timers::unzip].Start();
+        ParallelForEach(blocks.size(), [&](std::size_t i) {
+          uncompressed[i] = DecompressBlockData(blocks[i].data, bytesPerUncompressedBlock[blocks[i].gmy]);
+        });
+        timings[reporting::Timers::unzip].Stop();
       }
-    }
 
-    void GeometryReader::DeserialiseBlock(
-        GmyReadResult& geometry, std::vector<char> const& compressedBlockData,
-        site_t block_gmy
-    ) {
-        timings[reporting::Timers::readParse].Start();
-        // Create an Xdr interpreter.
-        auto blockData = DecompressBlockData(compressedBlockData,
-                                             bytesPerUncompressedBlock[block_gmy]);
-        io::XdrMemReader lReader(&blockData.front(), blockData.size());
+      timings[reporting::Timers::readParse].Start();
+      // Each block's sites are a separate vector, so threads don't
+      // interfere.
+      ParallelForEach(blocks.size(), [&](std::size_t i) {
+        if (gmyVersion == gmy::VersionNumberV5) {
+          ParseBlock(geometry, blocks[i].gmy, block_data(i));
+        } else {
+          io::XdrMemReader lReader(uncompressed[i].data(), uncompressed[i].size());
+          ParseBlock(geometry, blocks[i].gmy, lReader);
+        }
+      });
+      timings[reporting::Timers::readParse].Stop();
 
-        ParseBlock(geometry, block_gmy, lReader);
+      // If validating, check that we've read in as many sites as anticipated.
+      if constexpr (build_info::VALIDATE_GEOMETRY) {
+        for (auto const& block: blocks)
+          ValidateBlock(geometry, block.gmy);
+      }
+    }
 
-        // If debug-level logging, check that we've read in as many sites as anticipated.
-        if constexpr (build_info::VALIDATE_GEOMETRY) {
-          // Count the sites read,
-          site_t numSitesRead = 0;
-          for (site_t site = 0; site < geometry.GetSitesPerBlock(); ++site)
-          {
-            if (geometry.Blocks[block_gmy].Sites[site].targetProcessor != SITE_OR_BLOCK_SOLID)
-            {
-              ++numSitesRead;
-            }
-          }
-          // Compare with the sites we expected to read.
-          if (numSitesRead != fluidSitesOnEachBlock[block_gmy])
-          {
-            log::Logger::Log<log::Error, log::OnePerCore>("Was expecting %i fluid sites on block %i but actually read %i",
-                                                          fluidSitesOnEachBlock[block_gmy],
-                                                          block_gmy,
-                                                          numSitesRead);
-          }
+    void GeometryReader::ValidateBlock(GmyReadResult const& geometry, site_t block_gmy) const
+    {
+      // Count the sites read,
+      site_t numSitesRead = 0;
+      for (site_t site = 0; site < geometry.GetSitesPerBlock(); ++site)
+      {
+        if (geometry.Blocks[block_gmy].Sites[site].targetProcessor != SITE_OR_BLOCK_SOLID)
+        {
+          ++numSitesRead;
         }
-      timings[reporting::Timers::readParse].Stop();
+      }
+      // Compare with the sites we expected to read.
+      if (numSitesRead != fluidSitesOnEachBlock[block_gmy])
+      {
+        log::Logger::Log<log::Error, log::OnePerCore>("Was expecting %i fluid sites on block %i but actually read %i",
+                                                      fluidSitesOnEachBlock[block_gmy],
+                                                      block_gmy,
+                                                      numSitesRead);
+      }
     }
 
-    std::vector<char> GeometryReader::DecompressBlockData(const std::vector<char>& compressed,
-                                                          const unsigned int uncompressedBytes)
+    std::vector<char> GeometryReader::DecompressBlockData(std::span<char const> compressed,
+                                                          const unsigned int uncompressedBytes) const
     {
-      timings[reporting::Timers::unzip].Start();
       // For zlib return codes.
       int ret;
 
@@ -517,7 +740,7 @@ namespace hemelb::geometry
       stream.zfree = Z_NULL;
       stream.opaque = Z_NULL;
       stream.avail_in = compressed.size();
-      stream.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(&compressed.front()));
+      stream.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(compressed.data()));
 
       ret = inflateInit(&stream);
       if (ret != Z_OK)
@@ -535,12 +758,11 @@ namespace hemelb::geometry
       if (ret != Z_OK)
         throw Exception() << "Decompression error for block";
 
-      timings[reporting::Timers::unzip].Stop();
       return uncompressed;
     }
 
     void GeometryReader::ParseBlock(GmyReadResult& geometry, const site_t block,
-                                    io::XdrReader& reader)
+                                    io::XdrReader& reader) const
     {
       // We start by clearing the sites on the block. We read the blocks twice (once before
       // optimisation and once after), so there can be sites on the block from the previous read.
@@ -553,7 +775,7 @@ namespace hemelb::geometry
       }
     }
 
-    GeometrySite GeometryReader::ParseSite(io::XdrReader& reader)
+    GeometrySite GeometryReader::ParseSite(io::XdrReader& reader) const
     {
       // Read the site type
       unsigned readSiteType;
@@ -610,19 +832,7 @@ namespace hemelb::geometry
           link.distanceToIntersection = distance;
         }
 
-        // Now, attempt to match the direction read from the local neighbourhood to one in the
-        // lattice being used for simulation. If a match is found, assign the link to the read
-        // site.
-        for (Direction usedLatticeDirection = 1; usedLatticeDirection < latticeInfo.GetNumVectors();
-            usedLatticeDirection++)
-        {
-          if (latticeInfo.GetVector(usedLatticeDirection) == dir)
-          {
-            // If this link direction is necessary to the lattice in use, keep the link data.
-            readInSite.links[usedLatticeDirection - 1] = link;
-            break;
-          }
-        }
+        SetLink(readInSite, dir, link);
       }
 
       auto normalAvailable = [&]() {
@@ -630,16 +840,7 @@ namespace hemelb::geometry
         reader.read(normalAvailable);
         return WallNormalAvailabilityValidator::Run(normalAvailable);
       }();
-      readInSite.wallNormalAvailable = (normalAvailable == gmy::WallNormalAvailability::AVAILABLE);
-
-      if (readInSite.wallNormalAvailable != isGmyWallSite)
-      {
-        std::string msg = isGmyWallSite ?
-          "wall fluid site without" :
-          "bulk fluid site with";
-        throw Exception() << "Malformed GMY file, " << msg
-            << " a defined wall normal currently not allowed.";
-      }
+      SetWallNormalAvailable(readInSite, normalAvailable, isGmyWallSite);
 
       if (readInSite.wallNormalAvailable)
       {
@@ -651,11 +852,343 @@ namespace hemelb::geometry
       return readInSite;
     }
 
+    void GeometryReader::ParseBlock(GmyReadResult& geometry, const site_t block,
+                                    std::span<char const> data) const
+    {
+      auto& sites = geometry.Blocks[block].Sites;
+      sites.clear();
+      sites.reserve(geometry.GetSitesPerBlock());
+
+      // Version 5 records are fixed size, so each is a copy.
+      std::size_t pos = 0;
+      auto check_space = [&](std::size_t n) {
+        if (pos + n > data.size())
+          throw Exception() << "Malformed GMY file, block " << block << " is too short";
+      };
+      for (site_t localSiteIndex = 0; localSiteIndex < geometry.GetSitesPerBlock();
+          ++localSiteIndex)
+      {
+        std::uint32_t siteType;
+        check_space(sizeof(siteType));
+        std::memcpy(&siteType, &data[pos], sizeof(siteType));
+        if (SiteTypeValidator::Run(gmy::LittleEndian(siteType)) == gmy::SiteType::SOLID) {
+          sites.emplace_back(false);
+          pos += sizeof(siteType);
+          continue;
+        }
+
+        gmy::FluidSiteRecordV5 record;
+        check_space(sizeof(record));
+        std::memcpy(&record, &data[pos], sizeof(record));
+        gmy::LittleEndian(record);
+        sites.push_back(ParseSite(record));
+        pos += sizeof(record);
+      }
+    }
+
+    GeometrySite GeometryReader::ParseSite(gmy::FluidSiteRecordV5 const& record) const
+    {
+      GeometrySite readInSite(true);
+      readInSite.links.resize(latticeInfo.GetNumVectors() - 1);
+
+      bool isGmyWallSite = false;
+      for (std::size_t i = 0; i < gmy::NumberOfDisplacements; ++i)
+      {
+        auto const& recordLink = record.links[i];
+        GeometrySiteLink link;
+        link.type = CutTypeValidator::Run(recordLink.cutType);
+        if (link.type == gmy::CutType::WALL)
+        {
+          isGmyWallSite = true;
+          link.distanceToIntersection = recordLink.distance;
+        }
+        else if (link.type != gmy::CutType::NONE)
+        {
+          link.ioletId = recordLink.ioletId;
+          link.distanceToIntersection = recordLink.distance;
+        }
+        SetLink(readInSite, gmy::Neighbourhood[i], link);
+      }
+
+      SetWallNormalAvailable(readInSite, WallNormalAvailabilityValidator::Run(record.wallNormalAvailable),
+                             isGmyWallSite);
+      if (readInSite.wallNormalAvailable)
+      {
+        for (int d = 0; d < 3; ++d)
+          readInSite.wallNormal[d] = record.wallNormal[d];
+      }
+      return readInSite;
+    }
+
+    void GeometryReader::SetLink(GeometrySite& site, gmy::Displacement const& dir,
+                                 GeometrySiteLink const& link) const
+    {
+      // Now, attempt to match the direction read from the local neighbourhood to one in the
+      // lattice being used for simulation. If a match is found, assign the link to the read
+      // site.
+      for (Direction usedLatticeDirection = 1; usedLatticeDirection < latticeInfo.GetNumVectors();
+          usedLatticeDirection++)
+      {
+        if (latticeInfo.GetVector(usedLatticeDirection) == dir)
+        {
+          // If this link direction is necessary to the lattice in use, keep the link data.
+          site.links[usedLatticeDirection - 1] = link;
+          break;
+        }
+      }
+    }
+
+    void GeometryReader::SetWallNormalAvailable(GeometrySite& site, gmy::WallNormalAvailability available,
+                                                bool isGmyWallSite) const
+    {
+      site.wallNormalAvailable = (available == gmy::WallNormalAvailability::AVAILABLE);
+
+      if (site.wallNormalAvailable != isGmyWallSite)
+      {
+        std::string msg = isGmyWallSite ?
+          "wall fluid site without" :
+          "bulk fluid site with";
+        throw Exception() << "Malformed GMY file, " << msg
+            << " a defined wall normal currently not allowed.";
+      }
+    }
+
     /**
      * This function is only called if in geometry-validation mode.
      * @param geometry
      */
     void GeometryReader::ValidateGeometry(const GmyReadResult& geometry)
+    {
+      if constexpr (build_info::VALIDATE_GEOMETRY_FULL) {
+        ValidateGeometryFully(geometry);
+      } else {
+        ValidateGeometryByHash(geometry);
+      }
+    }
+
+    /**
+     * Each block has a directory process (its octree index modulo the
+     * number of processes). Every process holding a copy of the block
+     * sends the directory a checksum of its copy, a mask of the fluid
+     * sites and a mask of the sites it has been assigned. The directory
+     * reports fluid sites assigned to no process or to more than one,
+     * and solid sites assigned to any; only if the checksums differ, has
+     * the copies sent to the lowest process holding the block to be
+     * compared site by site. So the work and communication are in
+     * proportion to the blocks each process holds.
+     */
+    std::size_t GeometryReader::ValidateGeometryByHash(const GmyReadResult& geometry)
+    {
+      log::Logger::Log<log::Debug, log::OnePerCore>("Validating the GlobalLatticeData by checksum");
+
+      auto const SPB = geometry.GetSitesPerBlock();
+      auto const NV = latticeInfo.GetNumVectors();
+      auto const myRank = computeComms.Rank();
+      constexpr auto UMAX = std::numeric_limits<unsigned>::max();
+      auto&& tree = geometry.block_store->GetTree();
+      std::size_t problems = 0;
+
+      auto gmy_index = [&](U64 block_oct) {
+        return geometry.GetBlockIdFromBlockCoordinates(tree.GetLeafCoords(block_oct));
+      };
+      // What every copy of a block must agree on: whether each site
+      // is fluid and, if so, the type of each of its links.
+      auto site_data = [&](U64 block_oct) {
+        std::vector<U64> ans(SPB * NV);
+        auto const& sites = geometry.Blocks[gmy_index(block_oct)].Sites;
+        for (site_t i = 0; i < SPB; ++i) {
+          ans[i * NV] = sites[i].isFluid;
+          for (Direction d = 1; d < NV; ++d)
+            ans[i * NV + d] = sites[i].isFluid ? unsigned(sites[i].links[d - 1].type) : UMAX;
+        }
+        return ans;
+      };
+
+      // Send the directories a record for each block held: the
+      // block, the checksum of this copy and the masks of fluid and
+      // assigned sites.
+      site_t const maskWords = (SPB + 63) / 64;
+      site_t const recordLength = 2 + 2 * maskWords;
+      std::map<int, std::vector<U64>> toDirectory;
+      for (U64 block_oct = 0; block_oct < nFluidBlocks; ++block_oct) {
+        auto const& sites = geometry.Blocks[gmy_index(block_oct)].Sites;
+        if (sites.empty())
+          continue;
+
+        auto const data = site_data(block_oct);
+        auto& record = toDirectory[block_oct % computeComms.Size()];
+        record.push_back(block_oct);
+        record.push_back(crc32(0, reinterpret_cast<const Bytef*>(data.data()), data.size() * sizeof(U64)));
+        auto const fluid = record.size();
+        auto const mask = fluid + maskWords;
+        record.resize(mask + maskWords, 0);
+        for (site_t i = 0; i < SPB; ++i) {
+          if (sites[i].isFluid)
+            record[fluid + i / 64] |= U64(1) << (i % 64);
+          if (sites[i].targetProcessor == myRank)
+            record[mask + i / 64] |= U64(1) << (i % 64);
+        }
+      }
+
+      struct Copy {
+        int rank;
+        U64 checksum;
+        std::vector<U64> fluid;
+        std::vector<U64> mask;
+      };
+      std::map<U64, std::vector<Copy>> copiesOfBlock;
+      {
+        net::sparse_exchange<U64> xchg(computeComms, 445);
+        for (auto const& [dest, records]: toDirectory)
+          xchg.send(to_span(records), dest);
+
+        std::vector<U64> rbuf;
+        xchg.receive(
+            [&](int src, int count) {
+              rbuf.resize(count);
+              return rbuf.data();
+            },
+            [&](int src, U64* buf) {
+              for (auto rec = buf; rec < buf + rbuf.size(); rec += recordLength)
+                copiesOfBlock[rec[0]].push_back({src, rec[1],
+                                                 std::vector<U64>(rec + 2, rec + 2 + maskWords),
+                                                 std::vector<U64>(rec + 2 + maskWords, rec + recordLength)});
+            }
+        );
+      }
+
+      auto bit = [](std::vector<U64> const& mask, site_t i) {
+        return bool(mask[i / 64] >> (i % 64) & 1);
+      };
+      // As the directory, check the copies of each block agree and
+      // ask the holders of any that don't to send their copies to
+      // the lowest of them. Every process with a site holds its
+      // block, so each fluid site must be in exactly one mask.
+      std::map<int, std::vector<U64>> mismatches;
+      std::vector<proc_t> assignedProc(SPB);
+      for (auto const& [block_oct, copies]: copiesOfBlock) {
+        std::fill(assignedProc.begin(), assignedProc.end(), UNKNOWN_PROCESS);
+        for (auto const& copy: copies)
+          for (site_t i = 0; i < SPB; ++i) {
+            if (!bit(copy.mask, i))
+              continue;
+            if (assignedProc[i] != UNKNOWN_PROCESS) {
+              log::Logger::Log<log::Critical, log::OnePerCore>(
+                  "Site %li of block %li believed to be on %i but process %i thinks it has it",
+                  i, gmy_index(block_oct), assignedProc[i], copy.rank
+              );
+              ++problems;
+            }
+            assignedProc[i] = copy.rank;
+          }
+        // If the copies differ, the fluid state is reported below.
+        auto const& fluid = copies.front().fluid;
+        for (site_t i = 0; i < SPB; ++i) {
+          if (bit(fluid, i) && assignedProc[i] == UNKNOWN_PROCESS) {
+            log::Logger::Log<log::Critical, log::OnePerCore>(
+                "Fluid site %li of block %li is not on any process", i, gmy_index(block_oct)
+            );
+            ++problems;
+          } else if (!bit(fluid, i) && assignedProc[i] != UNKNOWN_PROCESS) {
+            log::Logger::Log<log::Critical, log::OnePerCore>(
+                "Solid site %li of block %li believed to be on %i", i, gmy_index(block_oct), assignedProc[i]
+            );
+            ++problems;
+          }
+        }
+
+        auto const differs = std::any_of(copies.begin(), copies.end(), [&](Copy const& c) {
+          return c.checksum != copies.front().checksum;
+        });
+        if (differs) {
+          auto const reference = std::min_element(copies.begin(), copies.end(), [](Copy const& a, Copy const& b) {
+            return a.rank < b.rank;
+          })->rank;
+          for (auto const& copy: copies) {
+            mismatches[copy.rank].push_back(block_oct);
+            mismatches[copy.rank].push_back(reference);
+          }
+        }
+      }
+
+      std::vector<std::pair<U64, int>> toCompare;
+      {
+        net::sparse_exchange<U64> xchg(computeComms, 446);
+        for (auto const& [dest, pairs]: mismatches)
+          xchg.send(to_span(pairs), dest);
+
+        std::vector<U64> rbuf;
+        xchg.receive(
+            [&](int src, int count) {
+              rbuf.resize(count);
+              return rbuf.data();
+            },
+            [&](int src, U64* buf) {
+              for (std::size_t i = 0; i < rbuf.size(); i += 2)
+                toCompare.emplace_back(buf[i], int(buf[i + 1]));
+            }
+        );
+      }
+
+      // Only now send whole copies, and compare them with the
+      // reference copy, in the same way as the full validation.
+      std::map<int, std::vector<U64>> fullCopies;
+      for (auto const& [block_oct, reference]: toCompare) {
+        if (reference == myRank)
+          continue;
+        auto& buf = fullCopies[reference];
+        buf.push_back(block_oct);
+        auto const data = site_data(block_oct);
+        buf.insert(buf.end(), data.begin(), data.end());
+      }
+      {
+        net::sparse_exchange<U64> xchg(computeComms, 447);
+        for (auto const& [dest, copies]: fullCopies)
+          xchg.send(to_span(copies), dest);
+
+        std::vector<U64> rbuf;
+        xchg.receive(
+            [&](int src, int count) {
+              rbuf.resize(count);
+              return rbuf.data();
+            },
+            [&](int src, U64* buf) {
+              for (auto rec = buf; rec < buf + rbuf.size(); rec += 1 + SPB * NV) {
+                auto const block_oct = rec[0];
+                auto const block_gmy = gmy_index(block_oct);
+                auto const mine = site_data(block_oct);
+                auto const theirs = rec + 1;
+                for (site_t site = 0; site < SPB; ++site) {
+                  if (mine[site * NV] != theirs[site * NV]) {
+                    log::Logger::Log<log::Critical, log::OnePerCore>(
+                        "Different fluid state was found for site %li on block %li. Process %i: %li, process %i: %li .",
+                        site, block_gmy, myRank, mine[site * NV], src, theirs[site * NV]
+                    );
+                    ++problems;
+                  }
+                  for (Direction dir = 1; dir < NV; ++dir) {
+                    if (mine[site * NV + dir] != theirs[site * NV + dir]) {
+                      log::Logger::Log<log::Critical, log::OnePerCore>(
+                          "Different link type was found for site %li, link %i on block %li. Process %i: %li, process %i: %li .",
+                          site, dir, block_gmy, myRank, mine[site * NV + dir], src, theirs[site * NV + dir]
+                      );
+                      ++problems;
+                    }
+                  }
+                }
+              }
+            }
+        );
+      }
+      return problems;
+    }
+
+    /**
+     * Compare every block across all processes, with a reduction per
+     * block (HEMELB_VALIDATE_GEOMETRY_FULL). This needs memory and
+     * communication in proportion to the whole geometry.
+     */
+    void GeometryReader::ValidateGeometryFully(const GmyReadResult& geometry)
     {
       log::Logger::Log<log::Debug, log::OnePerCore>("Validating the GlobalLatticeData");
 
@@ -784,12 +1317,14 @@ namespace hemelb::geometry
     }
 
     void GeometryReader::OptimiseDomainDecomposition(GmyReadResult& geometry,
-                                                     const std::vector<proc_t>& procForEachBlock)
+                                                     const std::vector<U64>& myBlocks,
+                                                     const std::optional<decomposition::DecompositionCache>& cache)
     {
       decomposition::OptimisedDecomposition optimiser(timings,
                                                       computeComms,
                                                       geometry,
-                                                      latticeInfo);
+                                                      latticeInfo,
+                                                      myBlocks);
 
       timings[reporting::Timers::reRead].Start();
       log::Logger::Log<log::Debug, log::OnePerCore>("Rereading blocks");
@@ -807,12 +1342,52 @@ namespace hemelb::geometry
                      optimiser.GetArriving(),
                      optimiser.GetLeaving());
       timings[reporting::Timers::moves].Stop();
+
+      if (cache) {
+        // Store all the sites this rank ends up with, in the same
+        // order as the moves lists.
+        SiteVec mySites = optimiser.GetStaying();
+        for (auto const& [_, sites]: optimiser.GetArriving())
+          mySites.insert(mySites.end(), sites.begin(), sites.end());
+        std::sort(mySites.begin(), mySites.end());
+        cache->Save(dataChecksum, mySites);
+      }
+    }
+
+    bool GeometryReader::UseCachedDecomposition(GmyReadResult& geometry,
+                                                decomposition::DecompositionCache::Entry const& cached)
+    {
+      // One read of exactly the blocks we need, instead of the
+      // initial read, ParMETIS and the reread.
+      timings[reporting::Timers::fileRead].Start();
+      RereadBlocks(geometry, cached.sites, {});
+      timings[reporting::Timers::fileRead].Stop();
+
+      // All ranks have the same checksum so agree on this.
+      if (dataChecksum != cached.dataChecksum) {
+        log::Logger::Log<log::Warning, log::Singleton>(
+            "GMY block data does not match the cached decomposition; recomputing it"
+        );
+        for (auto& block: geometry.Blocks)
+          block.Sites.clear();
+        return false;
+      }
+
+      timings[reporting::Timers::moves].Start();
+      ImplementMoves(geometry, cached.sites, {}, {});
+      timings[reporting::Timers::moves].Stop();
+
+      if constexpr (build_info::VALIDATE_GEOMETRY) {
+        log::Logger::Log<log::Info, log::Singleton>("Validating cached decomposition");
+        ValidateGeometry(geometry);
+      }
+      return true;
     }
 
     // The header section of the config file contains a number of records.
     site_t GeometryReader::GetHeaderLength(site_t blockCount) const
     {
-      return gmy::HeaderRecordLength * blockCount;
+      return (gmyVersion == gmy::VersionNumberV5 ? gmy::HeaderRecordLengthV5 : gmy::HeaderRecordLength) * blockCount;
     }
 
     // Iterator to advance through the moves vector to the first move
@@ -6,9 +6,13 @@
 #ifndef HEMELB_GEOMETRY_GEOMETRYREADER_H
 #define HEMELB_GEOMETRY_GEOMETRYREADER_H
 
+#include <filesystem>
+#include <optional>
+#include <span>
 #include <vector>
 #include <string>
 
+#include "io/formats/geometry.h"
 #include "io/readers/XdrReader.h"
 #include "lb/lattices/LatticeInfo.h"
 #include "lb/LbmParameters.h"
@@ -18,6 +22,7 @@
 #include "util/Vector3D.h"
 #include "units.h"
 #include "geometry/GmyReadResult.h"
+#include "geometry/decomposition/DecompositionCache.h"
 #include "geometry/needs/Needs.h"
 
 #include "net/MpiFile.h"
@@ -34,7 +39,17 @@ namespace hemelb::geometry
                        reporting::Timers &timings, net::IOCommunicator ioComm);
         ~GeometryReader();
 
-        GmyReadResult LoadAndDecompose(const std::string& dataFilePath);
+        // If a cache directory is given, the optimised decomposition
+        // is read from there when a matching one exists, skipping
+        // ParMETIS, or written there for next time when not.
+        GmyReadResult LoadAndDecompose(const std::string& dataFilePath,
+                                       const std::optional<std::filesystem::path>& decompositionCacheDir = std::nullopt);
+
+        // Check a geometry this reader has loaded for self-consistency
+        // by exchanging checksums of blocks with only the processes
+        // holding them. Collective. Returns the number of problems
+        // this process found (and logged).
+        std::size_t ValidateGeometryByHash(const GmyReadResult& geometry);
 
     private:
         // Read from the file into a buffer on all processes.
@@ -48,13 +63,18 @@ namespace hemelb::geometry
         // the domain.
         void ReadHeader(site_t blockCount);
 
-        // map from block GMY index to vect of data
-        using block_cache = std::map<U64, std::vector<char>>;
-
-        // Load compressed data from the file if the predicate is true for that block's GMY index.
-        template <std::predicate<std::size_t> PredT>
-        block_cache ReadCompressedBlockData(GmyReadResult const& geometry, PredT&& p);
+        // A block's compressed data, still in the read buffer.
+        struct CompressedBlock {
+            site_t gmy;
+            std::span<char const> data;
+        };
 
+        // Stream the file's block data in chunks. The blocks of each
+        // chunk for which the predicate is true of their GMY index
+        // are passed to process, while the next chunk is being read.
+        template <std::predicate<std::size_t> PredT,
+                  std::invocable<std::vector<CompressedBlock> const&> ProcessT>
+        void StreamCompressedBlockData(GmyReadResult const& geometry, PredT&& want, ProcessT&& process);
 
         // Given a vector of the block OCT ids that we want, add a
         // one-block halo and read those blocks into the
@@ -68,29 +88,63 @@ namespace hemelb::geometry
             const GmyReadResult& geometry, const std::vector<U64>& blocks_wanted
         ) const;
 
-        // Parse a compressed block of data into the geometry at the given GMY index
-        void DeserialiseBlock(GmyReadResult& geometry,
-                              std::vector<char> const& compressed_data, site_t block_gmy);
+        // Decompress and parse blocks into the geometry, spread over
+        // the OpenMP threads.
+        void DeserialiseBlocks(GmyReadResult& geometry, std::vector<CompressedBlock> const& blocks);
 
-        // Decompress the block data
-        std::vector<char> DecompressBlockData(const std::vector<char>& compressed,
-                                              const unsigned int uncompressedBytes);
+        // Check the number of fluid sites parsed for a block
+        void ValidateBlock(GmyReadResult const& geometry, site_t block_gmy) const;
+
+        // Decompress the block data. Safe to call from several threads.
+        std::vector<char> DecompressBlockData(std::span<char const> compressed,
+                                              const unsigned int uncompressedBytes) const;
 
         // Given a reader for a block's data, parse that into the
         // GmyReadResult at the given index.
         void ParseBlock(GmyReadResult& geometry, const site_t block,
-                        io::XdrReader& reader);
+                        io::XdrReader& reader) const;
 
         // Parse the next site from the XDR reader
-        GeometrySite ParseSite(io::XdrReader& reader);
+        GeometrySite ParseSite(io::XdrReader& reader) const;
+
+        // Parse a version 5 block's (uncompressed) data into the
+        // GmyReadResult at the given index.
+        void ParseBlock(GmyReadResult& geometry, const site_t block,
+                        std::span<char const> data) const;
+
+        // Make a site from a version 5 fluid site record
+        GeometrySite ParseSite(io::formats::geometry::FluidSiteRecordV5 const& record) const;
+
+        // Give the site the link, if the lattice has its direction
+        void SetLink(GeometrySite& site, io::formats::geometry::Displacement const& dir,
+                     GeometrySiteLink const& link) const;
+
+        // Record whether the site has a wall normal, checking the
+        // file only gives one for wall sites
+        void SetWallNormalAvailable(GeometrySite& site, io::formats::geometry::WallNormalAvailability available,
+                                    bool isGmyWallSite) const;
 
         // Use the OptimisedDecomposition class to refine a simple,
-        // block-level initial decomposition.
+        // block-level initial decomposition, saving the result to the
+        // cache if there is one. myBlocks are the blocks the initial
+        // decomposition gave this rank.
         void OptimiseDomainDecomposition(GmyReadResult& geometry,
-                                         const std::vector<proc_t>& procForEachBlock);
+                                         const std::vector<U64>& myBlocks,
+                                         const std::optional<decomposition::DecompositionCache>& cache);
+
+        // Read only the blocks needed for a cached decomposition and
+        // implement it. Returns false, having read nothing into the
+        // geometry, if the GMY data does not match the cache.
+        bool UseCachedDecomposition(GmyReadResult& geometry,
+                                    decomposition::DecompositionCache::Entry const& cached);
+
+        // Log the ranks' peak memory use so far. Collective.
+        void ReportPeakMemory() const;
 
         // Check for self-consistency
         void ValidateGeometry(const GmyReadResult& geometry);
+        // ...by comparing every block across all processes (or see ValidateGeometryByHash)
+        void ValidateGeometryFully(const GmyReadResult& geometry);
 
         // Get the length of the header section, given the number of blocks.
         site_t GetHeaderLength(site_t blockCount) const;
@@ -120,6 +174,11 @@ namespace hemelb::geometry
         //! Communicator for all ranks that will need a slice of the geometry
         net::IOCommunicator computeComms;
 
+        //! The GMY format version of the file
+        std::uint32_t gmyVersion = io::formats::geometry::VersionNumber;
+        //! How the file's blocks are compressed
+        io::formats::geometry::Codec codec = io::formats::geometry::Codec::ZLIB;
+
         //! How many blocks with at least one fluid site
         U64 nFluidBlocks;
         //! The number of fluid sites on each block in the file.
@@ -128,11 +187,20 @@ namespace hemelb::geometry
         std::vector<unsigned int> bytesPerCompressedBlock;
         //! The number of bytes each block in the file takes up when uncompressed.
         std::vector<unsigned int> bytesPerUncompressedBlock;
+        //! Where each block's data starts in the file.
+        std::vector<std::size_t> blockOffsets;
         //! The process assigned to each block.
         std::vector<proc_t> principalProcForEachBlock;
         //! The process for fluid-containing blocks in octree order
         std::vector<proc_t> procForBlockOct;
 
+        //! Checksum of the file preamble and header
+        U64 headerChecksum = 0;
+        //! Whether to checksum the block data as it is streamed from the file
+        bool computeDataChecksum = false;
+        //! Checksum of the block data from the last time it was streamed
+        U64 dataChecksum = 0;
+
         //! Timings object for recording the time taken for each step of the domain decomposition.
         hemelb::reporting::Timers &timings;
     };
@@ -66,6 +66,20 @@ namespace hemelb::geometry::octree {
         return oct_to_ijk(levels[n_levels].node_ids[idx]);
     }
 
+    U64 LookupTree::GetSitesBefore(std::size_t leaf_idx) const {
+        auto const path = GetPath(levels[n_levels].node_ids[leaf_idx]).path;
+        // At each level, add the sites under the earlier children of
+        // the node on the path. Children are stored in octree order.
+        U64 ans = 0;
+        for (U16 l = 0; l < n_levels; ++l) {
+            for (auto child: levels[l].child_indices[path[l]]) {
+                if (child != Level::NC && child < path[l + 1])
+                    ans += levels[l + 1].sites_per_node[child];
+            }
+        }
+        return ans;
+    }
+
     constexpr U64 bounds_to_end(Vec16 bounds) {
         return ijk_to_oct(bounds -= Vec16::Ones()) + 1;
     }
@@ -194,6 +194,11 @@ namespace hemelb::geometry::octree
         [[nodiscard]] LeafRange IterLeaves() const;
 
         [[nodiscard]] Vec16 GetLeafCoords(std::size_t) const;
+
+        // The number of fluid sites in the leaves before the given
+        // one, in octree order. Found by walking the path to the leaf,
+        // so no array of partial sums over all leaves is needed.
+        [[nodiscard]] U64 GetSitesBefore(std::size_t leaf_idx) const;
     };
 
     // Iterate over tree leaf nodes in storage order
@@ -8,6 +8,7 @@
 
 #include <span>
 
+#include "hassert.h"
 #include "units.h"
 #include "geometry/SiteData.h"
 #include "util/Vector3D.h"
@@ -185,28 +186,57 @@ namespace hemelb::geometry
          * @return
          */
         template<typename LatticeType>
-        site_t GetStreamedIndex(Direction direction) const
+        streaming_index_t GetStreamedIndex(Direction direction) const
         {
           return m_domain->template GetStreamedIndex<LatticeType>(index, direction);
         }
 
+        /**
+         * Get the index, in the distribution arrays, of this site's
+         * distribution in the given direction.
+         *
+         * @param direction
+         * @return
+         */
+        site_t GetDistributionIndex(Direction direction) const
+        {
+          return m_domain->GetDistributionIndex(index, direction);
+        }
+
+        // Are this site's first n values adjacent in memory, so that
+        // they can be viewed in place? True for every site with the AoS
+        // layout (DistributionLayout::IsSiteContiguous).
+        bool HasContiguousValues(int n) const
+        {
+            return GetDistributionIndex(n - 1) - GetDistributionIndex(0) == n - 1;
+        }
+
+        // The GetFOld overloads view the site's values in place, as
+        // distribn_storage_t, so may only be used when the distribution
+        // layout keeps them together (see HasContiguousValues);
+        // otherwise use GatherFOld or ReadFOld.
         template<typename LatticeType>
         auto GetFOld() const
         {
-            return ConstDistSpan<LatticeType::NUMVECTORS>{m_fieldData->GetFOld(index * LatticeType::NUMVECTORS), LatticeType::NUMVECTORS};
+            HASSERT(HasContiguousValues(LatticeType::NUMVECTORS));
+            return std::span<const distribn_storage_t, LatticeType::NUMVECTORS>{
+                    m_fieldData->GetFOld(GetDistributionIndex(0)), LatticeType::NUMVECTORS
+            };
         }
 
         // Non-templated version of GetFOld, for when you haven't got a lattice type handy
-        const distribn_t* GetFOld(int numvectors) const
+        auto GetFOld(int numvectors) const
         {
-          return m_fieldData->GetFOld(index * numvectors);
+          HASSERT(HasContiguousValues(numvectors));
+          return m_fieldData->GetFOld(GetDistributionIndex(0));
         }
 
         // Note that for const qualified field_type, dists are const too.
         template<typename LatticeType>
         auto GetFOld()
         {
-            auto ptr = m_fieldData->GetFOld(index * LatticeType::NUMVECTORS);
+            HASSERT(HasContiguousValues(LatticeType::NUMVECTORS));
+            auto ptr = m_fieldData->GetFOld(GetDistributionIndex(0));
             // To correctly return the Const/Mut span
             return std::span<
                     typename std::pointer_traits<decltype(ptr)>::element_type,
@@ -217,7 +247,31 @@ namespace hemelb::geometry
         // Non-templated version of GetFOld, for when you haven't got a lattice type handy
         auto GetFOld(int numvectors)
         {
-            return m_fieldData->GetFOld(index * numvectors);
+            HASSERT(HasContiguousValues(numvectors));
+            return m_fieldData->GetFOld(GetDistributionIndex(0));
+        }
+
+        // Copy this site's fOld values into out, whatever the layout.
+        template<typename LatticeType>
+        void GatherFOld(std::span<distribn_t, LatticeType::NUMVECTORS> out) const
+        {
+            for (Direction i = 0; i < LatticeType::NUMVECTORS; ++i)
+                out[i] = *m_fieldData->GetFOld(GetDistributionIndex(i));
+        }
+
+        // This site's fOld values as distribn_t: viewed in place (as
+        // GetFOld) if that is how they are stored, otherwise copied into
+        // buffer.
+        template<typename LatticeType>
+        ConstDistSpan<LatticeType::NUMVECTORS> ReadFOld(std::span<distribn_t, LatticeType::NUMVECTORS> buffer) const
+        {
+            if constexpr (DISTRIBUTIONS_STORED_IN_FULL)
+            {
+                if (HasContiguousValues(LatticeType::NUMVECTORS))
+                    return GetFOld<LatticeType>();
+            }
+            GatherFOld<LatticeType>(buffer);
+            return buffer;
         }
 
         const SiteData& GetSiteData() const
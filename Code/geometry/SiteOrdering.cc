@@ -0,0 +1,85 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "geometry/SiteOrdering.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace hemelb::geometry
+{
+    namespace {
+        // Spread the lowest 21 bits of x out to every third bit.
+        std::uint64_t SpreadBits(std::uint64_t x) {
+            x &= 0x1fffff;
+            x = (x | x << 32) & 0x1f00000000ffff;
+            x = (x | x << 16) & 0x1f0000ff0000ff;
+            x = (x | x << 8) & 0x100f00f00f00f00f;
+            x = (x | x << 4) & 0x10c30c30c30c30c3;
+            x = (x | x << 2) & 0x1249249249249249;
+            return x;
+        }
+
+        // Interleave as for octree::ijk_to_oct: x has the most
+        // significant bit of each triple.
+        std::uint64_t Interleave(std::uint64_t x, std::uint64_t y, std::uint64_t z) {
+            return (SpreadBits(x) << 2) | (SpreadBits(y) << 1) | SpreadBits(z);
+        }
+    }
+
+    std::uint64_t MortonIndex(util::Vector3D<site_t> const& coords) {
+        return Interleave(coords.x(), coords.y(), coords.z());
+    }
+
+    std::uint64_t HilbertIndex(util::Vector3D<site_t> const& coords) {
+        // Skilling's algorithm (AIP Conf. Proc. 707, 381 (2004)): turn
+        // the coordinates into the "transposed" Hilbert index, whose
+        // bits interleaved as for Morton give the index itself.
+        std::uint32_t X[3] = {std::uint32_t(coords.x()), std::uint32_t(coords.y()), std::uint32_t(coords.z())};
+        constexpr std::uint32_t TOP = 1U << (SITE_CURVE_BITS - 1);
+
+        // Inverse undo.
+        for (std::uint32_t Q = TOP; Q > 1; Q >>= 1) {
+            const std::uint32_t P = Q - 1;
+            for (auto& Xi: X) {
+                if (Xi & Q) {
+                    X[0] ^= P;
+                } else {
+                    const std::uint32_t t = (X[0] ^ Xi) & P;
+                    X[0] ^= t;
+                    Xi ^= t;
+                }
+            }
+        }
+
+        // Gray encode.
+        X[1] ^= X[0];
+        X[2] ^= X[1];
+        std::uint32_t t = 0;
+        for (std::uint32_t Q = TOP; Q > 1; Q >>= 1) {
+            if (X[2] & Q)
+                t ^= Q - 1;
+        }
+        for (auto& Xi: X)
+            Xi ^= t;
+
+        return Interleave(X[0], X[1], X[2]);
+    }
+
+    std::vector<site_t> OrderSites(std::span<const util::Vector3D<site_t>> coords, SiteOrdering ordering) {
+        std::vector<site_t> order(coords.size());
+        std::iota(order.begin(), order.end(), site_t(0));
+        if (ordering == SiteOrdering::Blocks)
+            return order;
+
+        auto index = ordering == SiteOrdering::Morton ? &MortonIndex : &HilbertIndex;
+        std::vector<std::uint64_t> keys(coords.size());
+        std::transform(coords.begin(), coords.end(), keys.begin(), index);
+        std::stable_sort(order.begin(), order.end(), [&](site_t a, site_t b) {
+            return keys[a] < keys[b];
+        });
+        return order;
+    }
+}
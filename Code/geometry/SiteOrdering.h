@@ -0,0 +1,68 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_SITEORDERING_H
+#define HEMELB_GEOMETRY_SITEORDERING_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "build_info.h"
+#include "Exception.h"
+#include "units.h"
+#include "util/Vector3D.h"
+
+namespace hemelb::geometry
+{
+    /**
+     * The order in which the local fluid sites are numbered within each
+     * of the ranges (mid-domain or domain-edge, by collision type) that
+     * the LB update goes through. The ranges themselves are unaffected.
+     */
+    enum class SiteOrdering {
+        // As they are read: the blocks in octree (i.e. Morton) order,
+        // then the sites of each block plane by plane.
+        Blocks,
+        // Along a Morton (Z-order) curve through the sites themselves.
+        Morton,
+        // Along a Hilbert curve, which (unlike Morton) only ever steps
+        // to an adjacent site, so neighbours stay closer in memory.
+        Hilbert
+    };
+
+    constexpr SiteOrdering GetDefaultSiteOrdering() {
+        constexpr auto ORDERING = build_info::SITE_ORDERING;
+        if constexpr (ORDERING == "Blocks") {
+            return SiteOrdering::Blocks;
+        } else if constexpr (ORDERING == "Morton") {
+            return SiteOrdering::Morton;
+        } else if constexpr (ORDERING == "Hilbert") {
+            return SiteOrdering::Hilbert;
+        } else {
+            throw (Exception() << "Configured with invalid SITE_ORDERING");
+        }
+    }
+
+    // The curves pass through a cube with sides of 2^SITE_CURVE_BITS
+    // sites, which must contain all the sites' coordinates.
+    inline constexpr unsigned SITE_CURVE_BITS = 21;
+
+    // Position along the Morton curve of the site with these global
+    // coordinates. For blocks of a power-of-two size, this puts blocks
+    // in the same order as the octree.
+    std::uint64_t MortonIndex(util::Vector3D<site_t> const& coords);
+
+    // Position along the Hilbert curve of the site with these global
+    // coordinates.
+    std::uint64_t HilbertIndex(util::Vector3D<site_t> const& coords);
+
+    // The order to number the sites with the given global coordinates
+    // in: a permutation of [0, coords.size()). Sites that are equal
+    // according to the ordering keep their relative order.
+    std::vector<site_t> OrderSites(std::span<const util::Vector3D<site_t>> coords, SiteOrdering ordering);
+}
+
+#endif // HEMELB_GEOMETRY_SITEORDERING_H
@@ -0,0 +1,121 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "geometry/decomposition/BlockDirectory.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#include "Exception.h"
+#include "net/SparseExchange.h"
+#include "util/span.h"
+
+namespace hemelb::geometry::decomposition
+{
+    namespace {
+        // Owner of a block no rank has given an entry for
+        constexpr U64 NO_OWNER = std::numeric_limits<U64>::max();
+    }
+
+    BlockDirectory::BlockDirectory(net::MpiCommunicator c, U64 n,
+                                   std::span<Entry const> mine) :
+        comms(std::move(c)), blockCount(n),
+        blocksPerRank(std::max<U64>(1, (n + comms.Size() - 1) / comms.Size()))
+    {
+        U64 const first = std::min(blockCount, comms.Rank() * blocksPerRank);
+        U64 const last = std::min(blockCount, first + blocksPerRank);
+        entries.resize(last - first, Entry{0, NO_OWNER, 0});
+
+        // Send each entry to its directory rank.
+        std::map<int, std::vector<Entry>> toSend;
+        for (auto const& e: mine) {
+            if (e[0] >= blockCount)
+                throw (Exception() << "Block " << e[0] << " is not in the directory");
+            toSend[GetDirectoryRank(e[0])].push_back(e);
+        }
+
+        net::sparse_exchange<Entry> xchg(comms, 45);
+        for (auto const& [dest, es]: toSend) {
+            xchg.send(to_span(es), dest);
+        }
+        std::map<int, std::vector<Entry>> recv;
+        xchg.receive(
+            [&](int src, int count) {
+                auto& buf = recv[src];
+                buf.resize(count);
+                return buf.data();
+            },
+            [&](int src, Entry* buf) {
+                for (auto const& e: recv[src]) {
+                    entries[e[0] - first] = e;
+                }
+            }
+        );
+    }
+
+    auto BlockDirectory::Lookup(std::span<U64 const> blocks) const -> std::vector<Entry>
+    {
+        U64 const first = std::min(blockCount, comms.Rank() * blocksPerRank);
+
+        // Ask each directory rank for its blocks...
+        std::map<int, std::vector<U64>> requests;
+        for (auto block: blocks) {
+            if (block >= blockCount)
+                throw (Exception() << "Block " << block << " is not in the directory");
+            requests[GetDirectoryRank(block)].push_back(block);
+        }
+
+        net::sparse_exchange<U64> ask(comms, 46);
+        for (auto const& [dest, bs]: requests) {
+            ask.send(to_span(bs), dest);
+        }
+        // ... which answers each rank in the order it asked.
+        std::map<int, std::vector<U64>> asked;
+        std::map<int, std::vector<Entry>> answers;
+        ask.receive(
+            [&](int src, int count) {
+                auto& buf = asked[src];
+                buf.resize(count);
+                return buf.data();
+            },
+            [&](int src, U64* buf) {
+                auto& ans = answers[src];
+                for (auto block: asked[src]) {
+                    auto const& e = entries[block - first];
+                    if (e[1] == NO_OWNER)
+                        throw (Exception() << "No rank owns block " << block);
+                    ans.push_back(e);
+                }
+            }
+        );
+
+        net::sparse_exchange<Entry> answer(comms, 47);
+        for (auto const& [dest, es]: answers) {
+            answer.send(to_span(es), dest);
+        }
+        std::map<int, std::vector<Entry>> replies;
+        answer.receive(
+            [&](int src, int count) {
+                auto& buf = replies[src];
+                buf.resize(count);
+                return buf.data();
+            },
+            [&](int src, Entry* buf) {
+                // no-op
+            }
+        );
+
+        // Put the answers back in the order asked.
+        std::map<int, std::size_t> next;
+        std::vector<Entry> ans;
+        ans.reserve(blocks.size());
+        for (auto block: blocks) {
+            auto const dirRank = GetDirectoryRank(block);
+            ans.push_back(replies[dirRank][next[dirRank]++]);
+        }
+        return ans;
+    }
+}
@@ -0,0 +1,56 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_BLOCKDIRECTORY_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_BLOCKDIRECTORY_H
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include "units.h"
+#include "net/MpiCommunicator.h"
+
+namespace hemelb::geometry::decomposition
+{
+    /**
+     * Which rank owns each block (by OCT index) and the global
+     * index of the block's first fluid site, spread over the ranks
+     * of a communicator so that none holds an entry for every
+     * block. The entries for a contiguous range of blocks live on
+     * each rank (its "directory rank"); other ranks ask for them with
+     * a sparse exchange.
+     */
+    class BlockDirectory
+    {
+    public:
+        // Block OCT index, owning rank, first fluid site index.
+        using Entry = std::array<U64, 3>;
+
+        // Collective. Each rank gives the entries for the blocks it
+        // owns; blockCount is the number of (non-solid) blocks.
+        BlockDirectory(net::MpiCommunicator comms, U64 blockCount,
+                       std::span<Entry const> mine);
+
+        // Collective (every rank must call it, even with no
+        // blocks). Get the entries for the given blocks, in the same
+        // order.
+        std::vector<Entry> Lookup(std::span<U64 const> blocks) const;
+
+        // The rank holding the entry for a block
+        inline int GetDirectoryRank(U64 block) const {
+            return int(block / blocksPerRank);
+        }
+
+    private:
+        net::MpiCommunicator comms;
+        U64 blockCount;
+        U64 blocksPerRank;
+        // The entries for the blocks from rank * blocksPerRank
+        std::vector<Entry> entries;
+    };
+}
+
+#endif
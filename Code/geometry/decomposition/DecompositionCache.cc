@@ -0,0 +1,129 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "geometry/decomposition/DecompositionCache.h"
+
+#include <array>
+#include <cstdio>
+#include <span>
+
+#include "log/Logger.h"
+#include "net/MpiFile.h"
+
+namespace hemelb::geometry::decomposition
+{
+    namespace fs = std::filesystem;
+
+    namespace
+    {
+        // "HLBDCMP" and a version number
+        constexpr U64 MAGIC = 0x484c4244434d5000ULL;
+        constexpr U64 VERSION = 1;
+
+        // magic, version, header checksum, ranks, lattice vectors, data checksum
+        using Preamble = std::array<U64, 6>;
+        // After the preamble comes the offset (in sites) of each
+        // rank's data, plus one for the end, then the sites.
+        constexpr MPI_Offset OffsetsStart = sizeof(Preamble);
+
+        MPI_Offset SitesStart(int nRanks)
+        {
+            return OffsetsStart + (nRanks + 1) * sizeof(U64);
+        }
+
+        // View sites as the pairs of integers they are made of
+        std::span<U64> AsIntegers(SiteVec& sites)
+        {
+            return {sites.front().data(), 2 * sites.size()};
+        }
+        std::span<U64 const> AsIntegers(SiteVec const& sites)
+        {
+            return {sites.front().data(), 2 * sites.size()};
+        }
+    }
+
+    DecompositionCache::DecompositionCache(fs::path const& cacheDir, fs::path const& gmyPath,
+                                           U64 headerChecksum, unsigned nVectors, net::IOCommunicator c) :
+            headerChecksum(headerChecksum), nVectors(nVectors), comm(std::move(c))
+    {
+        char key[64];
+        std::snprintf(key, sizeof(key), "-%016llx-%dranks-Q%u.dcmp",
+                      static_cast<unsigned long long>(headerChecksum), comm.Size(), nVectors);
+        path = cacheDir / (gmyPath.stem().string() + key);
+    }
+
+    std::optional<DecompositionCache::Entry> DecompositionCache::Load() const
+    {
+        int exists = 0;
+        if (comm.OnIORank())
+            exists = fs::exists(path);
+        comm.Broadcast(exists, comm.GetIORank());
+        if (!exists)
+        {
+            log::Logger::Log<log::Info, log::Singleton>("No cached decomposition at %s", path.c_str());
+            return std::nullopt;
+        }
+
+        auto file = net::MpiFile::Open(comm, path, MPI_MODE_RDONLY);
+        // Every rank reads the same few bytes, so they all agree on
+        // whether to use the file.
+        Preamble preamble;
+        file.ReadAt(0, std::span(preamble));
+        if (preamble[0] != MAGIC || preamble[1] != VERSION || preamble[2] != headerChecksum
+            || preamble[3] != U64(comm.Size()) || preamble[4] != nVectors)
+        {
+            log::Logger::Log<log::Warning, log::Singleton>("Ignoring mismatched cached decomposition at %s",
+                                                           path.c_str());
+            return std::nullopt;
+        }
+
+        std::array<U64, 2> range;
+        file.ReadAt(OffsetsStart + comm.Rank() * sizeof(U64), std::span(range));
+
+        Entry ans{preamble[5], SiteVec(range[1] - range[0])};
+        if (!ans.sites.empty())
+            file.ReadAt(SitesStart(comm.Size()) + range[0] * sizeof(SiteDesc), AsIntegers(ans.sites));
+
+        log::Logger::Log<log::Info, log::Singleton>("Read cached decomposition from %s", path.c_str());
+        return ans;
+    }
+
+    void DecompositionCache::Save(U64 dataChecksum, SiteVec const& mySites) const
+    {
+        // Write to a temporary and rename it into place, so that a
+        // run that dies part way leaves no half-written cache.
+        auto tmp = path;
+        tmp += ".tmp";
+        if (comm.OnIORank())
+        {
+            fs::create_directories(path.parent_path());
+            fs::remove(tmp);
+        }
+        comm.Barrier();
+
+        U64 const nSites = mySites.size();
+        U64 const end = comm.Scan(nSites, MPI_SUM);
+        {
+            auto file = net::MpiFile::Open(comm, tmp, MPI_MODE_WRONLY | MPI_MODE_CREATE);
+            if (comm.Rank() == 0)
+            {
+                Preamble const preamble{MAGIC, VERSION, headerChecksum, U64(comm.Size()), nVectors, dataChecksum};
+                file.WriteAt(0, std::span(preamble));
+                std::array<U64, 1> const zero{0};
+                file.WriteAt(OffsetsStart, std::span(zero));
+            }
+            std::array<U64, 1> const myEnd{end};
+            file.WriteAt(OffsetsStart + (comm.Rank() + 1) * sizeof(U64), std::span(myEnd));
+            if (nSites)
+                file.WriteAt(SitesStart(comm.Size()) + (end - nSites) * sizeof(SiteDesc), AsIntegers(mySites));
+            // Closing is collective.
+        }
+
+        if (comm.OnIORank())
+            fs::rename(tmp, path);
+        comm.Barrier();
+        log::Logger::Log<log::Info, log::Singleton>("Wrote decomposition to cache at %s", path.c_str());
+    }
+}
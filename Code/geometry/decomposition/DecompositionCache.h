@@ -0,0 +1,65 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONCACHE_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONCACHE_H
+
+#include <filesystem>
+#include <optional>
+
+#include "units.h"
+#include "geometry/GmyReadResult.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb::geometry::decomposition
+{
+    /**
+     * An on-disk copy of the final, optimised decomposition of a
+     * geometry: the sites (by block OCT index and site index within
+     * the block) that each rank ends up with.
+     *
+     * The file is named for what the decomposition depends on: a
+     * checksum of the GMY preamble and header, the number of ranks
+     * and the number of lattice vectors. It also records a checksum
+     * of the block data, which the reader must compare with the file
+     * it actually read before trusting the result.
+     *
+     * The format is native-endian, as the cache is only for repeat
+     * runs on the same machine.
+     */
+    class DecompositionCache
+    {
+    public:
+        struct Entry
+        {
+            // Checksum of the GMY block data this was computed from
+            U64 dataChecksum;
+            // The sites this rank owns, sorted by block then site
+            SiteVec sites;
+        };
+
+        DecompositionCache(std::filesystem::path const& cacheDir, std::filesystem::path const& gmyPath,
+                           U64 headerChecksum, unsigned nVectors, net::IOCommunicator comm);
+
+        // Read this rank's sites, if there is a matching file. Collective.
+        std::optional<Entry> Load() const;
+
+        // Write this rank's sites, replacing any existing file. Collective.
+        void Save(U64 dataChecksum, SiteVec const& mySites) const;
+
+        inline std::filesystem::path const& GetPath() const
+        {
+            return path;
+        }
+
+    private:
+        std::filesystem::path path;
+        U64 headerChecksum;
+        U64 nVectors;
+        net::IOCommunicator comm;
+    };
+}
+
+#endif
@@ -5,6 +5,7 @@
 
 #include "geometry/ParmetisHeader.h"
 #include "geometry/decomposition/OptimisedDecomposition.h"
+#include "geometry/decomposition/BlockDirectory.h"
 #include "geometry/decomposition/DecompositionWeights.h"
 #include "geometry/LookupTree.h"
 
@@ -22,20 +23,20 @@ namespace hemelb::geometry::decomposition
         reporting::Timers& timers,
         net::MpiCommunicator c,
         const GmyReadResult& geometry,
-        const lb::LatticeInfo& latticeInfo
+        const lb::LatticeInfo& latticeInfo,
+        const std::vector<U64>& myBlocks
     ) : timers(timers), comms(std::move(c)), geometry(geometry),
-        tree(geometry.block_store->GetTree()), latticeInfo(latticeInfo),
-        procForBlockOct(geometry.block_store->GetBlockOwnerRank()),
-        fluidSitesPerBlockOct(tree.levels.back().sites_per_node)
+        tree(geometry.block_store->GetTree()), latticeInfo(latticeInfo)
     {
         timers[reporting::Timers::InitialGeometryRead].Start(); //overall dbg timing
 
         // Calculate the site distribution and validate if appropriate.
-        PopulateSiteDistribution();
+        PopulateSiteDistribution(myBlocks);
+        PopulateHaloBlocks();
 
         if constexpr (build_info::VALIDATE_GEOMETRY) {
           ValidateVertexDistribution();
-          ValidateFirstSiteIndexOnEachBlock();
+          ValidateHeldBlocks();
         }
 
         // Populate the adjacency data arrays (for ParMetis) and validate if appropriate
@@ -179,8 +180,8 @@ namespace hemelb::geometry::decomposition
         vertexWeights.resize(localVertexCount);
         idx_t i_wgt = 0;
         // For each block (counting up by lowest site id)...
-        for (auto [block_idx, block_rank]: enumerate_with<std::size_t>(procForBlockOct)) {
-            if (block_rank != comms.Rank())
+        for (auto const& [block_idx, held]: heldBlocks) {
+            if (held.owner != comms.Rank())
                 // Only consider sites on this procesr.
                 continue;
 
@@ -237,7 +238,7 @@ namespace hemelb::geometry::decomposition
                                                       TotalCoreWeight);
     }
 
-    void OptimisedDecomposition::PopulateSiteDistribution()
+    void OptimisedDecomposition::PopulateSiteDistribution(const std::vector<U64>& myBlocks)
     {
         // Parmetis needs to know (on all processes) how
         // vertices/sites are distributed across the processes.
@@ -256,54 +257,90 @@ namespace hemelb::geometry::decomposition
         //
         // We also need to know what vertex indices to assign to each
         // site. Do this contiguously for the sites within each block
-        // per-process.
+        // this process owns, in octree order.
         //
         // We will also need to be able to translate between a site's
-        // GMY index in a block and it's fluid-only index.
-
-        auto& procForBlockOct = geometry.block_store->GetBlockOwnerRank();
-        auto& tree = geometry.block_store->GetTree();
-        auto& fluidSitesPerBlockOct = tree.levels[tree.n_levels].sites_per_node;
-        auto const NBLOCKS = geometry.block_store->GetBlockCount();
-
-        // First, count the sites per process and assign contiguous
-        // IDs to the sites in each block.
-        U64 total_sites = 0;
-        vtxCountPerProc = std::vector<idx_t>(comms.Size(), 0);
-        firstSiteIndexPerBlockOct.resize(NBLOCKS + 1);
-
-        for (site_t block = 0; block < NBLOCKS; ++block) {
-            auto block_rank = procForBlockOct[block];
-            firstSiteIndexPerBlockOct[block] = total_sites;
-            vtxCountPerProc[block_rank] += fluidSitesPerBlockOct[block];
-            total_sites += fluidSitesPerBlockOct[block];
+        // GMY index in a block and it's fluid-only index, but only for
+        // the blocks we have read.
+
+        // First, note the GMY local site ids of the fluid sites on
+        // our own blocks.
+        auto const rank = comms.Rank();
+        for (auto block_idx: myBlocks) {
+            AddHeldBlock(block_idx, rank, 0);
         }
-        firstSiteIndexPerBlockOct[NBLOCKS] = total_sites;
-
-        // Now do the scan to setup vtxdist
-        vtxDistribn = std::vector<idx_t>(comms.Size() + 1);
-        vtxDistribn[0] = 0;
-        std::inclusive_scan(
-            vtxCountPerProc.begin(), vtxCountPerProc.end(),
-            vtxDistribn.begin() + 1,
-            std::plus<idx_t>()
-        );
 
-        // Now, for every block we've got data for, create the mapping
-        // from block OCT id to a vector of the GMY local site ids of
-        // the fluid sites.
-        for (auto [block_idx, block_rank]: enumerate_with<U64>(procForBlockOct)) {
-            auto block_ijk = tree.GetLeafCoords(block_idx);
-            auto block_gmy = geometry.GetBlockIdFromBlockCoordinates(block_ijk);
-            auto& blockReadResult = geometry.Blocks[block_gmy];
-            if (blockReadResult.Sites.empty())
-                continue;
-            std::vector<U16>& block_fluid_site_gmy_ids = gmySiteIdForBlockOct[block_idx];
-            for (auto const& [i, s]: util::enumerate_with<U16>(blockReadResult.Sites)) {
-                // ... only looking at non-solid sites...
-                if (s.targetProcessor != SITE_OR_BLOCK_SOLID) {
-                    block_fluid_site_gmy_ids.push_back(i);
-                }
+        // Then share the counts to set up vtxdist.
+        idx_t localVertexCount = 0;
+        for (auto const& [_, held]: heldBlocks) {
+            localVertexCount += std::ssize(held.gmySiteIds);
+        }
+        auto const counts = comms.AllGather(localVertexCount);
+        vtxDistribn = std::vector<idx_t>(comms.Size() + 1, 0);
+        std::inclusive_scan(counts.begin(), counts.end(), vtxDistribn.begin() + 1);
+
+        // Now number the sites of our blocks.
+        idx_t next = vtxDistribn[rank];
+        for (auto& [_, held]: heldBlocks) {
+            held.firstSiteIndex = next;
+            next += std::ssize(held.gmySiteIds);
+        }
+    }
+
+    void OptimisedDecomposition::PopulateHaloBlocks()
+    {
+        // Put each of our blocks' owner and first site index in the
+        // directory.
+        std::vector<BlockDirectory::Entry> mine;
+        mine.reserve(heldBlocks.size());
+        for (auto const& [block_idx, held]: heldBlocks) {
+            mine.push_back({block_idx, U64(held.owner), U64(held.firstSiteIndex)});
+        }
+        BlockDirectory directory(comms, tree.levels.back().node_ids.size(), mine);
+
+        // Find the blocks around ours (that the reader will also
+        // have read) which we don't own.
+        auto const& block_dims = geometry.GetBlockDimensions();
+        std::vector<U64> halo;
+        for (auto const& [block_idx, _]: heldBlocks) {
+            auto const block_ijk = tree.GetLeafCoords(block_idx).as<int>();
+            for (int di = -1; di <= 1; ++di)
+                for (int dj = -1; dj <= 1; ++dj)
+                    for (int dk = -1; dk <= 1; ++dk) {
+                        auto const neigh_ijk = block_ijk + Vector3D<int>(di, dj, dk);
+                        if (!neigh_ijk.IsInRange(Vector3D<int>::Zero(), block_dims.as<int>() - Vector3D<int>::Ones()))
+                            continue;
+                        auto const neigh_idx = tree.GetPath(neigh_ijk.as<U16>()).leaf();
+                        // Recall that the octree will return a path
+                        // with "no child" for all levels where the
+                        // requested node doesn't exist.
+                        if (neigh_idx != octree::Level::NC && !heldBlocks.contains(neigh_idx))
+                            halo.push_back(neigh_idx);
+                    }
+        }
+        std::sort(halo.begin(), halo.end());
+        halo.erase(std::unique(halo.begin(), halo.end()), halo.end());
+
+        for (auto [block_idx, owner, first]: directory.Lookup(halo)) {
+            AddHeldBlock(block_idx, int(owner), idx_t(first));
+        }
+    }
+
+    void OptimisedDecomposition::AddHeldBlock(U64 block_idx, int owner, idx_t firstSiteIndex)
+    {
+        auto block_ijk = tree.GetLeafCoords(block_idx);
+        auto block_gmy = geometry.GetBlockIdFromBlockCoordinates(block_ijk);
+        auto& blockReadResult = geometry.Blocks[block_gmy];
+        if (blockReadResult.Sites.empty())
+            throw (Exception() << "Block " << block_idx << " was not read");
+
+        auto& held = heldBlocks[block_idx];
+        held.owner = owner;
+        held.firstSiteIndex = firstSiteIndex;
+        for (auto const& [i, s]: util::enumerate_with<U16>(blockReadResult.Sites)) {
+            // ... only looking at non-solid sites...
+            if (s.targetProcessor != SITE_OR_BLOCK_SOLID) {
+                held.gmySiteIds.push_back(i);
             }
         }
     }
@@ -319,8 +356,8 @@ namespace hemelb::geometry::decomposition
         auto const hi_site = block_dims.as<site_t>() * BS - Vector3D<site_t>::Ones();
 
         // For each block (counting up by lowest site id)...
-        for (auto [block_idx, block_rank]: enumerate_with<std::size_t>(procForBlockOct)) {
-            if (block_rank != comms.Rank())
+        for (auto const& [block_idx, held]: heldBlocks) {
+            if (held.owner != comms.Rank())
                 // ... considering only the ones which live on this proc...
                 continue;
 
@@ -354,8 +391,12 @@ namespace hemelb::geometry::decomposition
                     U16 neighbourSiteId = geometry.GetSiteIdFromSiteCoordinates(ni, nj, nk);
 
                     // This is the GMY local site IDs for only the
-                    // fluid sites on the neighbour block
-                    auto const& neigh_gmy_sites = gmySiteIdForBlockOct[neigh_idx];
+                    // fluid sites on the neighbour block, which we
+                    // will have read as part of the halo
+                    auto neigh_held = heldBlocks.find(neigh_idx);
+                    if (neigh_held == heldBlocks.end())
+                        throw (Exception() << "Neighbouring block " << neigh_idx << " was not read");
+                    auto const& neigh_gmy_sites = neigh_held->second.gmySiteIds;
                     auto lb = std::lower_bound(neigh_gmy_sites.begin(), neigh_gmy_sites.end(), neighbourSiteId);
                     // lb is either end or the first elem greater than or equal to what we want
                     // end => SOLID; greater than or equal => SOLID
@@ -363,7 +404,7 @@ namespace hemelb::geometry::decomposition
                         continue;
                     // have equal
                     auto local_contig_idx = std::distance(neigh_gmy_sites.begin(), lb);
-                    U64 neighGlobalSiteId = firstSiteIndexPerBlockOct[neigh_idx] + local_contig_idx;
+                    U64 neighGlobalSiteId = neigh_held->second.firstSiteIndex + local_contig_idx;
 
                     // then add this to the list of adjacencies.
                     localAdjacencies.push_back(idx_t(neighGlobalSiteId));
@@ -386,55 +427,38 @@ namespace hemelb::geometry::decomposition
     auto OptimisedDecomposition::CompileMoveData() -> MovesMap
     {
         // Key is the destination rank, value is the list of [block, site id] pairs
-        std::map<int, std::vector<std::array<U64,2>>> movesToRank;
+        MovesMap movesToRank;
 
-        std::vector<idx_t> moveData;
-        auto const myLowest = vtxDistribn[comms.Rank()];
-        auto const mySiteCount = vtxDistribn[comms.Rank() + 1] - myLowest;
         // For each local fluid site...
-        // (NB: since the vertices/sites are sorted by block and then
+        // (NB: since the vertices/sites are numbered by block and then
         // site, the results are also so sorted.)
-        for (idx_t ii = 0; ii < mySiteCount; ++ii)
-        {
-            // Where should it be? Catalogue even sites staying here for simplicity
-            auto dest_rank = partitionVector[ii];
-
-            idx_t global_site_id = myLowest + ii;
-            // Find out which block it's on.
-
-            // Upper bound gives the iterator to the first one after
-            // (recalling that we have an extra entry with the total
-            // number of the fluid sites at the end).
-            auto after = std::upper_bound(
-                firstSiteIndexPerBlockOct.begin(), firstSiteIndexPerBlockOct.end(),
-                global_site_id
-            );
-            U64 const block_idx = std::distance(firstSiteIndexPerBlockOct.begin(), after) - 1;
+        idx_t ii = 0;
+        for (auto const& [block_idx, held]: heldBlocks) {
+            if (held.owner != comms.Rank())
+                continue;
 
             if constexpr (build_info::VALIDATE_GEOMETRY) {
-                // Check the block id is correct
-              if (
-                  global_site_id  < firstSiteIndexPerBlockOct[block_idx] ||
-                  global_site_id  >= firstSiteIndexPerBlockOct[block_idx+1]) {
-                  log::Logger::Log<log::Critical, log::OnePerCore>(
-                      "Found block %i for site %i but sites on this block start at number %i and finish before %i",
-                      block_idx,
-                      global_site_id ,
-                      firstSiteIndexPerBlockOct[block_idx],
-                      firstSiteIndexPerBlockOct[block_idx + 1]
-                  );
-              }
+                // Check the sites are where we numbered them
+                if (vtxDistribn[comms.Rank()] + ii != held.firstSiteIndex) {
+                    log::Logger::Log<log::Critical, log::OnePerCore>(
+                        "Found site %li at the start of block %lu but its first site is number %li",
+                        vtxDistribn[comms.Rank()] + ii,
+                        block_idx,
+                        held.firstSiteIndex
+                    );
+                }
             }
 
-            // ... and find its site id within that block. Start by working out how many fluid sites
-            // we have to pass before we arrive at the fluid site we're after...
-            site_t block_site_id = global_site_id - firstSiteIndexPerBlockOct[block_idx];
-            auto siteIndexGmy = gmySiteIdForBlockOct[block_idx][block_site_id];
-
-            // Add the block, site and destination rank to our move list.
-            movesToRank[dest_rank].push_back({block_idx, siteIndexGmy});
+            for (auto siteIndexGmy: held.gmySiteIds) {
+                // Where should it be? Catalogue even sites staying here for simplicity
+                auto dest_rank = partitionVector[ii++];
+                // Add the block, site and destination rank to our move list.
+                movesToRank[dest_rank].push_back({block_idx, siteIndexGmy});
+            }
         }
 
+        if (ii != std::ssize(partitionVector))
+            throw (Exception() << "Wrong number of vertices: expected " << partitionVector.size() << " got " << ii);
         return movesToRank;
       }
 
@@ -554,67 +578,82 @@ namespace hemelb::geometry::decomposition
             );
         }
 
-        std::vector<std::size_t> neigh_edge_counts(comms.Size());
-        for (int root = 0; root < comms.Size(); ++root) {
-          // Send any edges we've got to the current root process
-          auto maybe_edges = adjByNeighProc.find(root);
-          std::size_t const nedges = (maybe_edges == adjByNeighProc.end()) ?
-            0 // no edges to that process
-            : maybe_edges->second.size();
-
-          net::MpiCall{MPI_Gather}(&nedges, 1, net::MpiDataType<std::size_t>(), neigh_edge_counts.data(), 1, net::MpiDataType<std::size_t>(), root, comms);
-
-          if (root == comms.Rank()) {
-            // Root receives and checks non-zeros
-            std::vector<edge> neigh_edges;
-            for (int src = 0; src < comms.Size(); ++src) {
-              if (neigh_edge_counts[src]) {
-                neigh_edges.resize(neigh_edge_counts[src]);
-                comms.Receive(neigh_edges, src, 43);
-                // Check!
+        // Send them to the processes they belong to, to check
+        net::sparse_exchange<edge> xchg(comms, 43);
+        for (auto const& [proc, edges]: adjByNeighProc) {
+            xchg.send(to_span(edges), proc);
+        }
+        std::vector<edge> neigh_edges;
+        xchg.receive(
+            [&](int src, int count) {
+                neigh_edges.resize(count);
+                return neigh_edges.data();
+            },
+            [&](int src, edge* buf) {
                 for (auto [w, v]: neigh_edges) {
-                  check_edge(v, w);
+                    check_edge(v, w);
                 }
-              }
             }
-          } else {
-            if (nedges)
-              comms.Send(maybe_edges->second, root, 43);
-          }
-        }
+        );
     }
 
-    void OptimisedDecomposition::ValidateFirstSiteIndexOnEachBlock() {
-        // Check that values are
-        // a) the same across all processes
-        // b) increase from zero to the the total number of fluid
-        // sites by at least one per block and at most by sites per
-        // block
-
-        log::Logger::Log<log::Debug, log::OnePerCore>("Validating the firstSiteIndexPerBlock values.");
-        auto const n_non_solid = tree.levels[tree.n_levels].sites_per_node.size();
-        auto const total_fluid = tree.levels[0].sites_per_node[0];
-
-        HASSERT(firstSiteIndexPerBlockOct.size() == n_non_solid + 1);
-        HASSERT(firstSiteIndexPerBlockOct[0] == 0);
-        for (auto i = 0UL; i < n_non_solid; ++i) {
-            auto d = firstSiteIndexPerBlockOct[i+1] - firstSiteIndexPerBlockOct[i];
-            HASSERT(d > 0);
-            HASSERT(d <= geometry.GetSitesPerBlock());
+    void OptimisedDecomposition::ValidateHeldBlocks() {
+        // Check that
+        // a) the sites on this process's blocks are numbered
+        // contiguously, as vtxDistribn says
+        // b) the owner of each block held as halo agrees on the
+        // number of its first site
+
+        log::Logger::Log<log::Debug, log::OnePerCore>("Validating the first site index of held blocks.");
+        auto const rank = comms.Rank();
+        idx_t next = vtxDistribn[rank];
+        std::map<int, std::vector<std::array<U64, 2>>> haloFirstSites;
+        for (auto const& [block_idx, held]: heldBlocks) {
+            HASSERT(!held.gmySiteIds.empty());
+            HASSERT(std::ssize(held.gmySiteIds) <= geometry.GetSitesPerBlock());
+            HASSERT(std::ssize(held.gmySiteIds) == idx_t(tree.levels.back().sites_per_node[block_idx]));
+
+            auto const owner = held.owner;
+            if (owner == rank) {
+                if (held.firstSiteIndex != next) {
+                    log::Logger::Log<log::Critical, log::OnePerCore>(
+                        "This process had the first site index on block %lu as %li but expected %li.",
+                        block_idx, held.firstSiteIndex, next
+                    );
+                }
+                next = held.firstSiteIndex + held.gmySiteIds.size();
+            } else {
+                haloFirstSites[owner].push_back({block_idx, U64(held.firstSiteIndex)});
+            }
+        }
+        if (next != vtxDistribn[rank + 1]) {
+            log::Logger::Log<log::Critical, log::OnePerCore>(
+                "This process's sites end at %li but vtxDistribn says %li.",
+                next, vtxDistribn[rank + 1]
+            );
         }
-        HASSERT(firstSiteIndexPerBlockOct[n_non_solid] == total_fluid);
-
-        auto firstSiteIndexPerBlockRecv = comms.AllReduce(firstSiteIndexPerBlockOct, MPI_MAX);
 
-        for (auto i = 0UL; i < n_non_solid; ++i) {
-            if (firstSiteIndexPerBlockOct[i] != firstSiteIndexPerBlockRecv[i]) {
-                log::Logger::Log<log::Critical, log::OnePerCore>(
-                    "This process had the first site index on block %li as %li but at least one other core had it as %li.",
-                    i,
-                    firstSiteIndexPerBlockOct[i],
-                    firstSiteIndexPerBlockRecv[i]
-                );
-            }
+        net::sparse_exchange<std::array<U64, 2>> xchg(comms, 44);
+        for (auto const& [owner, firsts]: haloFirstSites) {
+            xchg.send(to_span(firsts), owner);
         }
+        std::vector<std::array<U64, 2>> recv;
+        xchg.receive(
+            [&](int src, int count) {
+                recv.resize(count);
+                return recv.data();
+            },
+            [&](int src, std::array<U64, 2>* buf) {
+                for (auto [block_idx, first]: recv) {
+                    auto held = heldBlocks.find(block_idx);
+                    if (held == heldBlocks.end() || U64(held->second.firstSiteIndex) != first) {
+                        log::Logger::Log<log::Critical, log::OnePerCore>(
+                            "Process %i had the first site index on block %lu as %lu but this process, its owner, did not.",
+                            src, block_idx, first
+                        );
+                    }
+                }
+            }
+        );
     }
 }
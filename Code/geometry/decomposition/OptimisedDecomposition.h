@@ -32,9 +32,13 @@ namespace hemelb::geometry {
       {
       public:
           // Constructor actually does the optimisation - collective over comm.
+          //
+          // myBlocks are the blocks (OCT indices, ascending) that the
+          // initial decomposition gave this rank.
           OptimisedDecomposition(reporting::Timers& timers, net::MpiCommunicator comms,
                                  const GmyReadResult& geometry,
-                                 const lb::LatticeInfo& latticeInfo);
+                                 const lb::LatticeInfo& latticeInfo,
+                                 const std::vector<U64>& myBlocks);
 
           // NOTE! All the sites in staying, leaving and arriving are
           // sorted first by block ID and then by intra-block site ID.
@@ -64,11 +68,23 @@ namespace hemelb::geometry {
           void PopulateVertexWeightData(idx_t localVertexCount);
           /**
            * Populates the vertex distribution array in a ParMetis-compatible way. (off-by-1,
-           * cumulative count)
+           * cumulative count) and numbers the sites of the blocks held.
            *
-           * @param localVertexCount The number of local vertices
+           * @param myBlocks The blocks this rank owns
+           */
+          void PopulateSiteDistribution(const std::vector<U64>& myBlocks);
+
+          /**
+           * Add the halo of the blocks this rank owns to the blocks
+           * held, asking a BlockDirectory for their owners and first
+           * site indices.
+           */
+          void PopulateHaloBlocks();
+
+          /**
+           * Add a block this rank has read to those held.
            */
-          void PopulateSiteDistribution();
+          void AddHeldBlock(U64 block_idx, int owner, idx_t firstSiteIndex);
 
           /**
            * Gets the list of adjacencies and the count of adjacencies per local fluid site
@@ -98,9 +114,9 @@ namespace hemelb::geometry {
           void ValidateVertexDistribution();
 
           /**
-           * Validates the firstSiteIndexOnEachBlock array
+           * Validates the numbering of the fluid sites on the blocks held
            */
-          void ValidateFirstSiteIndexOnEachBlock();
+          void ValidateHeldBlocks();
 
           /**
            * Validate the adjacency data.
@@ -117,12 +133,17 @@ namespace hemelb::geometry {
           const GmyReadResult& geometry; //! The geometry being optimised.
           octree::LookupTree const& tree;
           const lb::LatticeInfo& latticeInfo; //! The lattice info to optimise for.
-          const std::vector<proc_t>& procForBlockOct; //! The initial MPI process for each block, in OCT layout
-          const std::vector<U64>& fluidSitesPerBlockOct; //! The number of fluid sites per block, in OCT layout
-          std::vector<idx_t> vtxCountPerProc; //! The number of vertices on each process.
           std::vector<idx_t> vtxDistribn; //! The vertex distribution across participating cores.
-          std::vector<idx_t> firstSiteIndexPerBlockOct; //! The global contiguous index of the first fluid site on each block.
-          std::map<U64, std::vector<U16>> gmySiteIdForBlockOct; //! A map keyed on block OCT id to an array of all the fluid sites' GMY local site ID.
+          // What we need to know about each block this process has
+          // read (its own and their halo). Nothing is stored per
+          // block of the whole geometry: the owner and first site
+          // index of halo blocks come from a BlockDirectory.
+          struct HeldBlock {
+              int owner; //! The rank that owns the block in the initial decomposition
+              idx_t firstSiteIndex; //! The global contiguous index of the block's first fluid site
+              std::vector<U16> gmySiteIds; //! The GMY local site ID of each of the block's fluid sites
+          };
+          std::map<U64, HeldBlock> heldBlocks; //! Keyed on block OCT id
           std::vector<idx_t> adjacenciesPerVertex; //! The number of adjacencies for each local fluid site
           std::vector<idx_t> vertexWeights; //! The weight of each local fluid site
           std::vector<real_t> vertexCoordinates; //! The coordinates of each local fluid site
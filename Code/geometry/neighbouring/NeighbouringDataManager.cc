@@ -115,12 +115,22 @@ auto const site = localFieldData.GetSite(localContiguousId);
             localNeed != neededSites.end(); localNeed++)
         {
           proc_t source = ProcForSite(*localNeed);
+          // The neighbouring data always keeps a site's values together.
           auto site = neighbouringFieldData.GetSite(*localNeed);
           net.RequestReceive(site.GetFOld(NV),
                              NV,
                              source);
 
         }
+        // The local distribution layout need not keep a site's values
+        // together, so gather each site's into the send buffer. This
+        // is sized before any send is requested so it doesn't move.
+        std::size_t numSends = 0;
+        for (auto const& needs: needsEachProcHasFromMe)
+          numSends += needs.size();
+        sendBuffer.resize(numSends * NV);
+
+        auto nextSend = sendBuffer.begin();
         for (proc_t other = 0; other < net.Size(); other++)
         {
           for (std::vector<site_t>::iterator needOnProcFromMe =
@@ -129,14 +139,13 @@ auto const site = localFieldData.GetSite(localContiguousId);
           {
             site_t localContiguousId =
                 local_dom.GetLocalContiguousIdFromGlobalNoncontiguousId(*needOnProcFromMe);
-//            Site<Domain> site =
-//                const_cast<Domain&>(localFieldData).GetSite(localContiguousId);
             auto const site = localFieldData.GetSite(localContiguousId);
-            // have to cast away the const, because no respect for const-ness for sends in MPI
-            net.RequestSend(site.GetFOld(NV),
+            for (Direction direction = 0; direction < NV; ++direction)
+              nextSend[direction] = *localFieldData.GetFOld(site.GetDistributionIndex(direction));
+            net.RequestSend(&*nextSend,
                             NV,
                             other);
-
+            nextSend += NV;
           }
         }
       }
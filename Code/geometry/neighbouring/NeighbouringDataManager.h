@@ -57,6 +57,7 @@ namespace hemelb
 
           std::vector<site_t> neededSites;
           std::vector<std::vector<site_t> > needsEachProcHasFromMe;
+          std::vector<distribn_storage_t> sendBuffer; //! Each needed site's distributions, gathered to be sent
 
           bool needsHaveBeenShared;
 
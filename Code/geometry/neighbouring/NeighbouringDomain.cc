@@ -63,7 +63,7 @@ namespace hemelb
           return ConstNeighbouringSite(globalIndex, *this);
       }
 
-      distribn_t* NeighbouringFieldData::GetFOld(site_t distributionIndex)
+      distribn_storage_t* NeighbouringFieldData::GetFOld(site_t distributionIndex)
       {
         const auto Q = m_domain->latticeInfo.GetNumVectors();
         site_t globalIndex = distributionIndex / Q;
@@ -73,12 +73,12 @@ namespace hemelb
         return &buffer[direction];
       }
 
-      std::vector<distribn_t>& NeighbouringFieldData::GetDistribution(site_t globalIndex)
+      std::vector<distribn_storage_t>& NeighbouringFieldData::GetDistribution(site_t globalIndex)
       {
         return distributions[globalIndex];
       }
 
-      const distribn_t* NeighbouringFieldData::GetFOld(site_t distributionIndex) const
+      const distribn_storage_t* NeighbouringFieldData::GetFOld(site_t distributionIndex) const
       {
         const auto Q = m_domain->latticeInfo.GetNumVectors();
         site_t globalIndex = distributionIndex / Q;
@@ -113,7 +113,7 @@ namespace hemelb
                                           const std::vector<distribn_t> &distances,
                                           const util::Vector3D<distribn_t> &normal,
                                           const SiteData & data) {
-            GetDistribution(index) = distribution;
+            GetDistribution(index).assign(distribution.begin(), distribution.end());
             m_domain->SaveSite(index, distances, normal, data);
         }
     }
@@ -64,6 +64,15 @@ namespace hemelb
             return -1;
           }
 
+          /*
+           * The neighbouring distributions are always stored with the
+           * values for a site together.
+           */
+          site_t GetDistributionIndex(site_t globalIndex, Direction direction) const
+          {
+            return globalIndex * latticeInfo.GetNumVectors() + direction;
+          }
+
           template<typename LatticeType>
           double GetCutDistance(site_t globalIndex, int direction) const
           {
@@ -103,7 +112,7 @@ namespace hemelb
       private:
           std::shared_ptr<domain_type> m_domain;
           // For now, just list fields by hand
-          std::map<site_t, std::vector<distribn_t> > distributions; //! The distribution values for the previous time step
+          std::map<site_t, std::vector<distribn_storage_t> > distributions; //! The distribution values for the previous time step
 
       public:
           NeighbouringFieldData() = default;
@@ -135,7 +144,7 @@ namespace hemelb
            * @param distributionIndex
            * @return
            */
-          distribn_t* GetFOld(site_t distributionIndex);
+          distribn_storage_t* GetFOld(site_t distributionIndex);
 
           /**
            * Get a vector of the fOld array for the site
@@ -143,7 +152,7 @@ namespace hemelb
            * @param globalIndex
            * @return
            */
-          std::vector<distribn_t>& GetDistribution(site_t globalIndex);
+          std::vector<distribn_storage_t>& GetDistribution(site_t globalIndex);
           /**
            * Get a pointer to the fOld array starting at the requested index. This version
            * of the function allows us to access the fOld array in a const way from a const
@@ -151,7 +160,7 @@ namespace hemelb
            * @param distributionIndex
            * @return
            */
-          const distribn_t* GetFOld(site_t distributionIndex) const;
+          const distribn_storage_t* GetFOld(site_t distributionIndex) const;
       };
     }
   }
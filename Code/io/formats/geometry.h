@@ -6,7 +6,11 @@
 #ifndef HEMELB_IO_FORMATS_GEOMETRY_H
 #define HEMELB_IO_FORMATS_GEOMETRY_H
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 
 #include "io/formats/formats.h"
 #include "util/Vector3D.h"
@@ -35,6 +39,19 @@ namespace hemelb
 	// Version number for geometry format.
 	static constexpr std::uint32_t VersionNumber = 4;
 
+	// Version 5 keeps the version 4 preamble but adds a table of
+	// 64-bit block offsets, fixed size little-endian site records
+	// and a choice of codec for the blocks.
+	static constexpr std::uint32_t VersionNumberV5 = 5;
+
+	// Codes for how a version 5 file's blocks are compressed, given
+	// in place of the preamble's padding. Each block is compressed
+	// on its own. (Version 4 files always use zlib.)
+	enum class Codec : std::uint32_t {
+	  NONE = 0,
+	  ZLIB = 1
+	};
+
 	// Type codes permitted for sites
 	enum class SiteType : std::uint32_t {
 	  SOLID = 0,
@@ -78,6 +95,18 @@ namespace hemelb
 	//  * 1 uint for uncompressed data size in bytes
 	static constexpr size_t HeaderRecordLength = 12;
 
+	// A version 5 header record, little-endian, one per block.
+	struct BlockIndexRecordV5 {
+	  // Position of the block's (compressed) data from the start
+	  // of the file. Blocks must be in order and not overlap.
+	  std::uint64_t offset;
+	  std::uint32_t fluidSites;
+	  std::uint32_t compressedBytes;
+	  std::uint32_t uncompressedBytes;
+	  std::uint32_t padding;
+	};
+	static constexpr size_t HeaderRecordLengthV5 = sizeof(BlockIndexRecordV5);
+
 	// The maximum possible length of a single site's data.
 	//  * 1 uint for the type
 	//  * then NumberOfDisplacements:
@@ -92,6 +121,59 @@ namespace hemelb
 	// THE length of a solid site's data.)
 	static constexpr size_t MaxSolidSiteRecordLength = 4;
 
+	// A version 5 site is a little-endian uint32 SiteType; for
+	// solid sites that is all. Fluid sites are this record (which
+	// repeats the type), with every field present for every link
+	// so that it can be copied straight from the file.
+	struct LinkRecordV5 {
+	  std::uint32_t cutType;
+	  // Zero unless an inlet or outlet
+	  std::uint32_t ioletId;
+	  // Zero unless cut
+	  float distance;
+	};
+	struct FluidSiteRecordV5 {
+	  std::uint32_t siteType;
+	  std::array<LinkRecordV5, NumberOfDisplacements> links;
+	  std::uint32_t wallNormalAvailable;
+	  // Zero unless available
+	  std::array<float, 3> wallNormal;
+	};
+	static_assert(sizeof(FluidSiteRecordV5) == MaxFluidSiteRecordLength);
+	static_assert(sizeof(BlockIndexRecordV5) == 24);
+
+	// Convert a value between little-endian and the host's order.
+	template <typename T>
+	static constexpr T LittleEndian(T val)
+	{
+	  if constexpr (std::endian::native == std::endian::little) {
+	    return val;
+	  } else {
+	    auto bytes = std::bit_cast<std::array<std::byte, sizeof(T)>>(val);
+	    std::reverse(bytes.begin(), bytes.end());
+	    return std::bit_cast<T>(bytes);
+	  }
+	}
+	static constexpr void LittleEndian(BlockIndexRecordV5& rec)
+	{
+	  rec.offset = LittleEndian(rec.offset);
+	  rec.fluidSites = LittleEndian(rec.fluidSites);
+	  rec.compressedBytes = LittleEndian(rec.compressedBytes);
+	  rec.uncompressedBytes = LittleEndian(rec.uncompressedBytes);
+	}
+	static constexpr void LittleEndian(FluidSiteRecordV5& rec)
+	{
+	  rec.siteType = LittleEndian(rec.siteType);
+	  for (auto& link: rec.links) {
+	    link.cutType = LittleEndian(link.cutType);
+	    link.ioletId = LittleEndian(link.ioletId);
+	    link.distance = LittleEndian(link.distance);
+	  }
+	  rec.wallNormalAvailable = LittleEndian(rec.wallNormalAvailable);
+	  for (auto& x: rec.wallNormal)
+	    x = LittleEndian(x);
+	}
+
 	// Compute the maximum possible length of a single block's data.
 	// @param blockSideLength
 	// @return maximum block record length in bytes
@@ -47,12 +47,35 @@ namespace hemelb::lb
                 f(f, LatticeType::NUMVECTORS)
         {
         }
+
+        // The site's own distributions: in place if they are stored as
+        // distribn_t, otherwise a copy.
         template<class DataSource>
         HydroVarsBase(geometry::Site<DataSource> const &_site) :
-                f(_site.template GetFOld<LatticeType>())
+                f(_site.template ReadFOld<LatticeType>(fRead))
+        {
+        }
+
+        // For streamers that have already found the values the site
+        // should collide.
+        template<class DataSource>
+        HydroVarsBase(geometry::Site<DataSource> const &_site, const_span s) : f(s) {
+        }
+
+        // If f refers to the other's copy of the distributions, refer to ours.
+        HydroVarsBase(HydroVarsBase const& other) :
+                fRead(other.fRead),
+                density(other.density), tau(other.tau), momentum(other.momentum), velocity(other.velocity),
+                f(other.f.data() == other.fRead.data() ? const_span(fRead) : other.f),
+                f_eq(other.f_eq), f_neq(other.f_neq), fPostCollision(other.fPostCollision)
         {
         }
+        HydroVarsBase& operator=(HydroVarsBase const&) = delete;
+
+    private:
+        FVector<LatticeType> fRead;
 
+    public:
         distribn_t density, tau;
         util::Vector3D<distribn_t> momentum;
         util::Vector3D<distribn_t> velocity;
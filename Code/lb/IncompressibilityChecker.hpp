@@ -6,6 +6,8 @@
 #ifndef HEMELB_LB_INCOMPRESSIBILITYCHECKER_HPP
 #define HEMELB_LB_INCOMPRESSIBILITYCHECKER_HPP
 
+#include <algorithm>
+
 #include "lb/IncompressibilityChecker.h"
 
 #include "hassert.h"
@@ -189,10 +191,28 @@ namespace hemelb::lb
     {
       timings[hemelb::reporting::Timers::monitoring].Start();
 
-      for (site_t i = 0; i < mLatDat->GetLocalFluidSiteCount(); i++)
+      // Find the extremes over this rank's sites, split between threads.
+      const site_t siteCount = mLatDat->GetLocalFluidSiteCount();
+      distribn_t minDensity = DBL_MAX;
+      distribn_t maxDensity = -DBL_MAX;
+      distribn_t maxVelocityMagnitude = 0.0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(min: minDensity) reduction(max: maxDensity, maxVelocityMagnitude)
+#endif
+      for (site_t i = 0; i < siteCount; i++)
+      {
+        const distribn_t density = propertyCache.densityCache.Get(i);
+        minDensity = std::min(minDensity, density);
+        maxDensity = std::max(maxDensity, density);
+        maxVelocityMagnitude = std::max(maxVelocityMagnitude,
+                                        propertyCache.velocityCache.Get(i).GetMagnitude());
+      }
+
+      if (siteCount > 0)
       {
-        upwardsDensityTracker.UpdateDensityTracker(propertyCache.densityCache.Get(i),
-                                                   propertyCache.velocityCache.Get(i).GetMagnitude());
+        upwardsDensityTracker.UpdateDensityTracker(minDensity, maxVelocityMagnitude);
+        upwardsDensityTracker.UpdateDensityTracker(maxDensity, maxVelocityMagnitude);
       }
 
       timings[hemelb::reporting::Timers::monitoring].Stop();
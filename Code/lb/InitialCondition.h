@@ -24,10 +24,10 @@ namespace hemelb::lb {
 
     protected:
       // Allow access for derived classes (this is a friend of domain_type)
-      inline distribn_t* GetFOld(geometry::FieldData* ld, site_t i) const {
+      inline distribn_storage_t* GetFOld(geometry::FieldData* ld, site_t i) const {
 	return ld->GetFOld(i);
       }
-      inline distribn_t* GetFNew(geometry::FieldData* ld, site_t i) const {
+      inline distribn_storage_t* GetFNew(geometry::FieldData* ld, site_t i) const {
 	return ld->GetFNew(i);
       }
 
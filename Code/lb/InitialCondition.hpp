@@ -42,11 +42,9 @@ namespace hemelb {
       LatticeType::CalculateFeq(density, mom_x, mom_y, mom_z, f_eq);
       
       for (site_t i = 0; i < latDat->GetDomain().GetLocalFluidSiteCount(); i++) {
-	distribn_t* f_old_p = this->GetFOld(latDat, i * LatticeType::NUMVECTORS);
-	distribn_t* f_new_p = this->GetFNew(latDat, i * LatticeType::NUMVECTORS);
-	
 	for (unsigned int l = 0; l < LatticeType::NUMVECTORS; l++) {
-	  f_new_p[l] = f_old_p[l] = f_eq[l];
+	  auto const idx = latDat->GetDomain().GetDistributionIndex(i, l);
+	  *this->GetFNew(latDat, idx) = *this->GetFOld(latDat, idx) = f_eq[l];
 	}
       }
     }
@@ -7,9 +7,13 @@
 #define HEMELB_LB_LBMPARAMETERS_H
 
 #include <cmath>
+#include <map>
+#include <memory>
+#include <typeindex>
 #include <vector>
 
 #include "constants.h"
+#include "reporting/timers_fwd.h"
 
 namespace hemelb::geometry {
     class Domain;
@@ -21,6 +25,7 @@ namespace hemelb::geometry {
 namespace hemelb::lb
 {
     class BoundaryValues;
+    class RheologyTable;
 
     enum StressTypes
     {
@@ -113,6 +118,10 @@ namespace hemelb::lb
 
         StressTypes StressType;
 
+        // Relative error allowed in the viscosity when tabulating a
+        // non-Newtonian rheology model; zero to evaluate it exactly.
+        double RheologyTableTolerance = 0.0;
+
       private:
         PhysicalTime timeStep = 1; // seconds
         PhysicalDistance voxelSize = 1; // metres
@@ -164,6 +173,15 @@ namespace hemelb::lb
         // The neighbouring data manager, for kernels / collisions / streamers that
         // require data from other cores.
         geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager;
+
+        // The timers of the run, for kernels that count how often they take each
+        // of their code paths. May be null (e.g. in the unit tests).
+        reporting::Timers *timings = nullptr;
+
+        // The tabulated rheology models (see RheologyTable), by model type.
+        // The first LBGKNN kernel of a type builds its table and the
+        // kernels for the other site types share it.
+        std::map<std::type_index, std::shared_ptr<const RheologyTable> > rheologyTables;
     };
 }
 
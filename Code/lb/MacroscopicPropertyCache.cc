@@ -38,6 +38,13 @@ namespace hemelb
       velDistributionsCache.UnsetRefreshFlag();
     }
 
+    bool MacroscopicPropertyCache::RequiresNonEquilibriumRefresh() const
+    {
+      return wallShearStressMagnitudeCache.RequiresRefresh() || vonMisesStressCache.RequiresRefresh()
+          || shearRateCache.RequiresRefresh() || stressTensorCache.RequiresRefresh()
+          || tractionCache.RequiresRefresh() || tangentialProjectionTractionCache.RequiresRefresh();
+    }
+
     site_t MacroscopicPropertyCache::GetSiteCount() const
     {
       return siteCount;
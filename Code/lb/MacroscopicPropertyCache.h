@@ -21,6 +21,15 @@ namespace hemelb
   }
   namespace lb
   {
+    /**
+     * Caches of macroscopic quantities at each fluid site, filled in
+     * by the streamers on the time steps they are needed.
+     *
+     * The caches are sized when their refresh flags are set, between
+     * time steps. After that, Put for different sites may be called
+     * from different threads at once (each site's entry is separate
+     * storage); nothing else may be.
+     */
     class MacroscopicPropertyCache
     {
       public:
@@ -38,6 +47,13 @@ namespace hemelb
          */
         void ResetRequirements();
 
+        /**
+         * Do any of the caches that are calculated from the non-equilibrium
+         * part of the distributions need refreshing?
+         * @return
+         */
+        bool RequiresNonEquilibriumRefresh() const;
+
         /**
          * Returns the number of sites cached.
          * @return
@@ -36,6 +36,13 @@ namespace hemelb::lb
                 net::PhasedBroadcastRegular<>(net, simState, SPREADFACTOR), mLatDat(std::move(iLatDat)),
                 mSimState(simState), timings(timings), testerConfig(testerConfig)
         {
+            // The convergence check compares the distributions at both ends of a
+            // time step; the AA pattern updates them in place.
+            if (testerConfig.doConvergenceCheck
+                && mLatDat->GetStreamingPattern() == geometry::StreamingPattern::AA)
+            {
+                throw Exception() << "Convergence checking is not available with the AA streaming pattern";
+            }
             Reset();
         }
 
@@ -96,32 +103,53 @@ namespace hemelb::lb
           // sending up a 'Unstable' value anyway.
           if (mUpwardsStability != Unstable)
           {
+            bool unstableSitePresent = false;
             bool unconvergedSitePresent = false;
+            auto const& dom = mLatDat->GetDomain();
+            site_t const siteCount = dom.GetLocalFluidSiteCount();
 
-            for (site_t i = 0; i < mLatDat->GetDomain().GetLocalFluidSiteCount(); i++)
+            // Exceptions can't leave the threaded loop below, so check
+            // this first.
+            if (testerConfig.doConvergenceCheck
+                && !std::holds_alternative<extraction::source::Velocity>(testerConfig.convergenceVariable))
             {
+              throw Exception() << "Convergence check based on requested variable currently not available";
+            }
+
+            // Each thread checks some of the sites; the flags are or-ed
+            // together at the end.
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(||: unstableSitePresent, unconvergedSitePresent)
+#endif
+            for (site_t i = 0; i < siteCount; i++)
+            {
+              // No need to test the rest of this thread's sites.
+              if (unstableSitePresent)
+              {
+                continue;
+              }
+
+              std::array<distribn_t, LatticeType::NUMVECTORS> fNew, fOld;
               for (unsigned int l = 0; l < LatticeType::NUMVECTORS; l++)
               {
-                distribn_t value = *mLatDat->GetFNew(i * LatticeType::NUMVECTORS + l);
+                distribn_t value = fNew[l] = *mLatDat->GetFNew(dom.GetDistributionIndex(i, l));
 
                 // Note that by testing for value > 0.0, we also catch stray NaNs.
                 if (! (value > 0.0))
                 {
-                  mUpwardsStability = Unstable;
+                  unstableSitePresent = true;
                   break;
                 }
               }
-              ///@todo: If we refactor the previous loop out, we can get away with a single break statement
-              if (mUpwardsStability == Unstable)
+              if (unstableSitePresent)
               {
-                break;
+                continue;
               }
 
               if (testerConfig.doConvergenceCheck)
               {
-                distribn_t relativeDifference =
-                    ComputeRelativeDifference(mLatDat->GetFNew<LatticeType>(i),
-                                              mLatDat->GetSite(i).GetFOld<LatticeType>());
+                mLatDat->GetSite(i).template GatherFOld<LatticeType>(fOld);
+                distribn_t relativeDifference = ComputeRelativeDifference(fNew, fOld);
 
                 if (relativeDifference > testerConfig.convergenceRelativeTolerance)
                 {
@@ -131,6 +159,11 @@ namespace hemelb::lb
               }
             }
 
+            if (unstableSitePresent)
+            {
+              mUpwardsStability = Unstable;
+            }
+
             switch (mUpwardsStability)
             {
               case UndefinedStability:
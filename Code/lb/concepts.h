@@ -7,6 +7,7 @@
 #define HEMELB_LB_CONCEPTS_H
 
 #include <concepts>
+#include <span>
 #include "lb/LbmParameters.h"
 #include "lb/lattices/Lattice.h"
 #include "util/concepts.h"
@@ -100,5 +101,75 @@ namespace hemelb::lb {
         { s.StreamAndCollide(site_idx, site_idx, lbmParameters, dom, cache) };
         { s.PostStep(site_idx, site_idx, lbmParameters, dom, cache) };
     };
+
+    // Can this link streamer / streamer be used with the AA streaming
+    // pattern (see geometry::StreamingPattern)? For a link streamer this
+    // requires that it only ever writes to the bounce-back slot of the
+    // site being updated and does nothing in PostStepLink. Types opt in
+    // by defining `static constexpr bool supports_aa_pattern = true`.
+    template <typename T>
+    concept aa_link_streamer = link_streamer<T> && requires {
+        requires T::supports_aa_pattern;
+    };
+    template <typename S>
+    concept aa_streamer = streamer<S> && requires {
+        requires S::supports_aa_pattern;
+    };
+
+    // Can this link streamer / streamer be used with any
+    // geometry::DistributionLayout? This requires that it finds the
+    // distributions of a site only through Site::GetDistributionIndex,
+    // Site::GetStreamedIndex or Site::GatherFOld, never by assuming they
+    // are adjacent. Types opt in by defining
+    // `static constexpr bool supports_any_layout = true`.
+    template <typename T>
+    concept any_layout_link_streamer = link_streamer<T> && requires {
+        requires T::supports_any_layout;
+    };
+    template <typename S>
+    concept any_layout_streamer = streamer<S> && requires {
+        requires S::supports_any_layout;
+    };
+
+    // Can this link streamer / streamer update different sites on
+    // different threads at the same time (see util::ForEachChunk)? This
+    // requires that, while streaming a site, it writes only to that
+    // site's outgoing distributions and its own
+    // entries of the MacroscopicPropertyCache, and otherwise changes no
+    // state shared between sites. Types opt in by defining
+    // `static constexpr bool supports_threading = true`.
+    template <typename T>
+    concept threadable_link_streamer = link_streamer<T> && requires {
+        requires T::supports_threading;
+    };
+    template <typename S>
+    concept threadable_streamer = streamer<S> && requires {
+        requires S::supports_threading;
+    };
+
+    // Does this wall link streamer work out what to do for each link
+    // once, at initialisation, rather than on every step? Such types
+    // define a LinkRecord type, with one record per wall link, and
+    // StreamerTypeFactory hands them those records instead of the site
+    // and direction whenever it has link lists for the sites (see
+    // LinkLists and PreparedLinks). PostStepLinks does the post-step
+    // work of all the wall links of some sites, returning false if it
+    // has no records for them.
+    template <typename T>
+    concept prepared_link_streamer = link_streamer<T> && requires(
+            T& linkStreamer,
+            LbmParameters const* lbmParams,
+            geometry::Domain const& dom,
+            geometry::FieldData& data,
+            geometry::Site<geometry::FieldData> const& site,
+            typename T::CollisionType::VarsType& hydroVars,
+            typename T::LinkRecord const& link,
+            std::span<const typename T::LinkRecord>& links,
+            site_t site_idx
+    ) {
+        { linkStreamer.FindLinks(dom, site_idx, site_idx, links) } -> std::same_as<bool>;
+        { linkStreamer.StreamLink(lbmParams, data, site, hydroVars, link) };
+        { linkStreamer.PostStepLinks(data, site_idx, site_idx) } -> std::same_as<bool>;
+    };
 }
 #endif
\ No newline at end of file
@@ -109,6 +109,7 @@ namespace hemelb::lb
       {
         for (int i = 0; i < ssize(localIoletIDs); i++)
         {
+          GetLocalIolet(i)->PrepareTimeStep(state->Get0IndexedTimeStep());
           HandleComms(GetLocalIolet(i));
         }
       }
@@ -143,6 +143,16 @@ namespace hemelb::lb
           /// @todo: #632 Is this method ever implemented not empty?
           virtual void Reset(SimulationState& state) = 0;
 
+          /***
+           * Called once at the start of each time step, before any boundary values
+           * for it are requested, so iolets can prepare the values they evaluate on
+           * the fly. Must not change any value returned.
+           * @param timeStep the 0-indexed time step about to be simulated
+           */
+          virtual void PrepareTimeStep(LatticeTimeStep timeStep)
+          {
+          }
+
           const LatticePosition& GetPosition() const
           {
             return position;
@@ -151,6 +161,7 @@ namespace hemelb::lb
           void SetPosition(const LatticePosition& x)
           {
             position = x;
+            GeometryChanged();
           }
 
           /**
@@ -160,6 +171,7 @@ namespace hemelb::lb
           void SetNormal(const util::Vector3D<Dimensionless>& newNormal)
           {
             normal = newNormal.GetNormalised();
+            GeometryChanged();
           }
 
           const util::Vector3D<Dimensionless>& GetNormal() const
@@ -195,6 +207,12 @@ namespace hemelb::lb
           }
 
         protected:
+          //! Called when the position or normal changes, for subclasses that
+          //! precompute anything from them.
+          virtual void GeometryChanged()
+          {
+          }
+
           LatticeDensity minimumSimulationDensity;
           LatticePosition position;
           util::Vector3D<Dimensionless> normal;
@@ -4,6 +4,7 @@
 // license in the file LICENSE.
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 
 #include "lb/iolets/InOutLetFile.h"
@@ -38,15 +39,14 @@ namespace hemelb::lb
             log::Logger::Log<log::Debug, log::OnePerCore>("Reading iolet values from file: %s", pressureFilePath.c_str());
 
 
-            while (datafile.good())
+            double t_s, p_mmHg;
+            while (datafile >> t_s >> p_mmHg)
             {
-                double t_s, p_mmHg;
-                datafile >> t_s >> p_mmHg;
                 log::Logger::Log<log::Trace, log::OnePerCore>("Time: %f s. Value: %f mmHg.", t_s, p_mmHg);
                 auto t_lat = unitConverter->ConvertTimeToLatticeUnits(t_s);
                 auto rho_lat = unitConverter->ConvertPressureToLatticeUnits(p_mmHg) / Cs2;
                 auto it = std::lower_bound(file_data_lat.begin(), file_data_lat.end(), DataPair{t_lat, rho_lat}, less_time);
-                if (it->first == t_lat) {
+                if (it != file_data_lat.end() && it->first == t_lat) {
                     *it = {t_lat, rho_lat};
                 } else {
                     file_data_lat.insert(it, std::make_pair(t_lat, rho_lat));
@@ -70,45 +70,44 @@ namespace hemelb::lb
         // IMPORTANT: to allow reading in data taken at irregular intervals the user
         // needs to make sure that the last point in the file coincides with the first
         // point of a new cycle for a continuous trace.
-        void InOutLetFile::Reset(SimulationState &state)
+        LatticeDensity InOutLetFile::InterpolateDensity(LatticeTimeStep timeStep) const
         {
-            auto totalTimeSteps = state.GetTotalTimeSteps();
-            // If the time values in the input file end BEFORE the planned
-            // end of the simulation, then loop the profile afterwards
-            // (using %TimeStepsInInletPressureProfile).
-            // int TimeStepsInInletPressureProfile = times.back() / timeStepLength;
-            // throw Exception() << "Finding Time steps: " << times.back() << " " << timeStepLength << " " << TimeStepsInInletPressureProfile;
-
-            // extend the table to one past the total time steps, so that
-            // the table is valid in the end-state, where the zero indexed
-            // time step is equal to the limit.
-            densityTable.resize(totalTimeSteps + 1);
-            // Now convert these vectors into arrays using linear
-            // interpolation
-
             auto const& t_0 = file_data_lat.front().first;
             auto const& t_1 = file_data_lat.back().first;
+            LatticeTime x = std::lerp(t_0, t_1, LatticeTime(timeStep) / LatticeTime(totalTimeSteps));
 
-            // To speed up the search, track the iterators that bracket the current time
-
-            // Let lower be the iterator to the last element less than or equal to x
-            auto lower = file_data_lat.begin();
             // Let upper be the iterator to the first element greater than x
-            auto upper = lower + 1;
-            // These are always one apart
-            for (unsigned int timeStep = 0; timeStep <= totalTimeSteps; timeStep++)
-            {
-                LatticeTime x = std::lerp(t_0, t_1, LatticeTime(timeStep) / LatticeTime(totalTimeSteps));
-                // First element strictly greater than t_0
-                upper = std::find_if(upper, file_data_lat.end(), [&](DataPair const& p) {
-                    return p.first > x;
-                });
-                // Last element less than or equal to t_0
-                lower = upper - 1;
-                auto [x0, y0] = *lower;
-                auto [x1, y1] = *upper;
-                densityTable[timeStep] = std::lerp(y0, y1, (x - x0) / (x1 - x0));
-            }
+            auto upper = std::upper_bound(file_data_lat.begin() + 1, file_data_lat.end(), DataPair{x, 0.0}, less_time);
+            // and lower the last less than or equal to it.
+            auto lower = upper - 1;
+            auto [x0, y0] = *lower;
+            // At the end of the trace, that is the value.
+            if (upper == file_data_lat.end())
+                return y0;
+            auto [x1, y1] = *upper;
+            return std::lerp(y0, y1, (x - x0) / (x1 - x0));
+        }
+
+        void InOutLetFile::FillWindow(LatticeTimeStep start)
+        {
+            // The table must be valid in the end-state, where the zero
+            // indexed time step is equal to the limit.
+            windowStart = start;
+            densityTable.resize(std::min(WINDOW_STEPS, totalTimeSteps + 1 - start));
+            for (LatticeTimeStep i = 0; i < densityTable.size(); ++i)
+                densityTable[i] = InterpolateDensity(start + i);
+        }
+
+        void InOutLetFile::Reset(SimulationState &state)
+        {
+            totalTimeSteps = state.GetTotalTimeSteps();
+            FillWindow(std::min(state.Get0IndexedTimeStep(), totalTimeSteps));
+        }
+
+        void InOutLetFile::PrepareTimeStep(LatticeTimeStep timeStep)
+        {
+            if (timeStep - windowStart >= densityTable.size() && timeStep <= totalTimeSteps)
+                FillWindow(timeStep);
         }
 
     }
@@ -50,12 +50,26 @@ namespace hemelb::lb
           }
           inline LatticeDensity GetDensity(LatticeTimeStep timeStep) const override
           {
-            return densityTable[timeStep];
+            auto const offset = timeStep - windowStart;
+            return offset < densityTable.size() ? densityTable[offset] : InterpolateDensity(timeStep);
           }
           void Initialise(const util::UnitConverter* unitConverter) override;
+          void PrepareTimeStep(LatticeTimeStep timeStep) override;
+
+          //! The most time steps whose densities are tabulated at once.
+          static constexpr LatticeTimeStep WINDOW_STEPS = 1 << 14;
 
         private:
+          //! Interpolate the density at a time step from the file data.
+          LatticeDensity InterpolateDensity(LatticeTimeStep timeStep) const;
+          //! Tabulate the densities for the time steps from start.
+          void FillWindow(LatticeTimeStep start);
+
+          //! Densities for the time steps from windowStart, so that long runs
+          //! don't need a table covering every step.
           std::vector<LatticeDensity> densityTable;
+          LatticeTimeStep windowStart = 0;
+          LatticeTimeStep totalTimeSteps = 0;
           LatticeDensity densityMin;
           LatticeDensity densityMax;
           std::filesystem::path pressureFilePath;
@@ -5,6 +5,8 @@
 #include "lb/iolets/InOutLetFileVelocity.h"
 
 #include <algorithm>
+#include <bit>
+#include <cstring>
 #include <fstream>
 #include "hassert.h"
 #include "log/Logger.h"
@@ -14,8 +16,70 @@
 
 namespace hemelb::lb
 {
+    std::vector<VelocityWeight> ReadVelocityWeights(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+        if (!file)
+            throw Exception() << "Could not open velocity weights file: " << path;
+
+        std::vector<VelocityWeight> weights;
+        char magic[sizeof(VELOCITY_WEIGHTS_MAGIC)] = {};
+        file.read(magic, sizeof(magic));
+        if (file && std::equal(magic, magic + sizeof(magic), VELOCITY_WEIGHTS_MAGIC))
+        {
+            // Binary: read all the records at once and unpack them.
+            if constexpr (std::endian::native != std::endian::little)
+                throw Exception() << "Binary velocity weights files can only be read on little-endian machines";
+
+            constexpr std::size_t RECORD = 3 * sizeof(std::int32_t) + sizeof(double);
+            std::uint64_t count = 0;
+            file.read(reinterpret_cast<char*>(&count), sizeof(count));
+            // Check the count against the file before allocating for it,
+            // so a truncated or corrupt file can't ask for any amount.
+            auto const remaining = std::filesystem::file_size(path) - sizeof(magic) - sizeof(count);
+            if (!file || count > remaining / RECORD)
+                throw Exception() << "Velocity weights file is truncated: " << path;
+            std::vector<char> records(count * RECORD);
+            file.read(records.data(), records.size());
+            if (!file)
+                throw Exception() << "Velocity weights file is truncated: " << path;
+
+            weights.resize(count);
+            for (std::uint64_t i = 0; i < count; ++i)
+            {
+                char const* record = records.data() + i * RECORD;
+                std::int32_t xyz[3];
+                std::memcpy(xyz, record, sizeof(xyz));
+                std::memcpy(&weights[i].weight, record + sizeof(xyz), sizeof(double));
+                weights[i].site = {xyz[0], xyz[1], xyz[2]};
+            }
+        }
+        else
+        {
+            /* Text, in format:
+             *
+             * coord_x coord_y coord_z weights_value
+             *
+             * */
+            file.clear();
+            file.seekg(0);
+            VelocityWeight w;
+            while (file >> w.site[0] >> w.site[1] >> w.site[2] >> w.weight)
+                weights.push_back(w);
+        }
+
+        // Sort by site, keeping the last of any repeats (as a map assigned to in file order
+        // would).
+        std::stable_sort(weights.begin(), weights.end(),
+                         [](VelocityWeight const& a, VelocityWeight const& b) { return a.site < b.site; });
+        auto last = std::unique(weights.rbegin(), weights.rend(),
+                                [](VelocityWeight const& a, VelocityWeight const& b) { return a.site == b.site; });
+        weights.erase(weights.begin(), last.base());
+        return weights;
+    }
+
     InOutLetFileVelocity::InOutLetFileVelocity() :
-            units(nullptr)
+            useWeightsFromFile(false), units(nullptr)
     {
     }
 
@@ -88,10 +152,15 @@ namespace hemelb::lb
           throw Exception() << "Last point's value does not match the first point's value in "
               << velocityFilePath;
 
-        // extend the table to one past the total time steps, so that the table is valid in the end-state, where the zero indexed time step is equal to the limit.
-        velocityTable.resize(totalTimeSteps + 1);
+        if (TimeStepsInInletVelocityProfile < 1)
+          throw Exception() << "Velocity profile in " << velocityFilePath << " is shorter than a time step";
+
+        // The profile loops every TimeStepsInInletVelocityProfile steps, so only that many
+        // (or, if fewer, one past the total time steps, so that the table is valid in the
+        // end-state, where the zero indexed time step is equal to the limit) are tabulated.
+        velocityTable.resize(std::min(LatticeTimeStep(TimeStepsInInletVelocityProfile), totalTimeSteps + 1));
         // Now convert these vectors into arrays using linear interpolation
-        for (unsigned int timeStep = 0; timeStep <= totalTimeSteps; timeStep++)
+        for (unsigned int timeStep = 0; timeStep < velocityTable.size(); timeStep++)
         {
           // The "% TimeStepsInInletVelocityProfile" here is to prevent profile stretching (it will loop instead).
           double point = times.front()
@@ -105,27 +174,8 @@ namespace hemelb::lb
 
       }
 
-      LatticeVelocity InOutLetFileVelocity::GetVelocity(const LatticePosition& x,
-                                                        const LatticeTimeStep t) const
+      std::optional<double> InOutLetFileVelocity::FindWeight(const LatticePosition& x) const
       {
-
-        if (!useWeightsFromFile)
-        {
-          // v(r) = vMax (1 - r**2 / a**2)
-          // where r is the distance from the centreline
-          LatticePosition displ = x - position;
-          LatticeDistance z = Dot(displ, normal);
-          Dimensionless rSqOverASq = (displ.GetMagnitudeSquared() - z * z) / (radius * radius);
-          HASSERT(rSqOverASq <= 1.0);
-
-          // Get the max velocity
-          LatticeSpeed max = velocityTable[t];
-
-          // Brackets to ensure that the scalar multiplies are done before vector * scalar.
-          return normal * (max * (1. - rSqOverASq));
-        }
-        else
-        {
           /* These absolute normal values can still be negative here,
            * but are corrected below to become positive.
            * */
@@ -136,23 +186,9 @@ namespace hemelb::lb
               comp = std::max(comp, 0.0000001);
           }
 
-          /*bool logging = false;
-          if (402.9 < x.x && x.x < 403.1 && 312.9 < x.y && x.y < 313.1 && 160.4 < x.z && x.z < 160.6)
-           {
-           logging = true;
-           }
-
-          if (logging)
-          {
-            log::Logger::Log<log::Warning, log::OnePerCore>("%f %f %f", x.x, x.y, x.z);
-          }*/
-
           int xyz_directions[3] = { 1, 1, 1 };
 
-          std::vector<int> xyz;
-          xyz.push_back(0);
-          xyz.push_back(0);
-          xyz.push_back(0);
+          std::array<int, 3> xyz = { 0, 0, 0 };
 
           double xyz_residual[3] = {0.0, 0.0, 0.0};
           /* The residual values increase by the normal values at every time step. When they hit >1.0, then
@@ -172,39 +208,24 @@ namespace hemelb::lb
               }
           }
 
-	  auto v_tot = LatticeVelocity::Zero();
           int iterations = 0;
 
           while (iterations < 3)
           {
-            if (weights_table.count(xyz) > 0)
+            auto found = std::lower_bound(weights_table.begin(), weights_table.end(), xyz,
+                                          [](VelocityWeight const& w, std::array<int, 3> const& site) {
+                                            return w.site < site;
+                                          });
+            if (found != weights_table.end() && found->site == xyz)
             {
-              v_tot = normal * weights_table.at(xyz) * velocityTable[t];
-              //log::Logger::Log<log::Warning, log::OnePerCore>("%f %f %f %f",
-              //                                                              x.x,
-              //                                                              x.y,
-              //                                                              x.z, v_tot);
-              return v_tot;
+              return found->weight;
             }
 
-            /*if (logging)
-            {
-              log::Logger::Log<log::Warning, log::OnePerCore>("%f %f %f %d %d %d",
-                                                              x.x,
-                                                              x.y,
-                                                              x.z,
-                                                              xyz[0],
-                                                              xyz[1],
-                                                              xyz[2]);
-            }*/
-
             /* Propagate residuals to the move to the next grid point. */
             double xstep = (1.0 - xyz_residual[0]) / abs_normal[0];
             double ystep = (1.0 - xyz_residual[1]) / abs_normal[1];
             double zstep = (1.0 - xyz_residual[2]) / abs_normal[2];
 
-            //log::Logger::Log<log::Warning, log::OnePerCore>("%f %f %f", xstep, ystep, zstep);
-
             double all_step = 0.0;
             int xyz_change = 0;
 
@@ -238,10 +259,6 @@ namespace hemelb::lb
 
             xyz[xyz_change] += xyz_directions[xyz_change];
 
-            //if(xyz_residual[xyz_change] < 1.0) {
-            //  log::Logger::Log<log::Error, log::Singleton>("ERROR: Residual bug in vInlet: %f %f %f %f", x.x, x.y, x.z, xyz_residual[xyz_change]);
-            //}
-
             xyz_residual[xyz_change] -= 1.0;
 
             iterations++;
@@ -251,11 +268,65 @@ namespace hemelb::lb
            * If you are unsure, you can increase the log level of this, run HemeLb
            * for 1 time step, and plot these points out. */
           log::Logger::Log<log::Trace, log::OnePerCore>("%f %f %f", x.x(), x.y(), x.z());
-          return normal * 0.0;
+          return std::nullopt;
+      }
+
+      LatticeVelocity InOutLetFileVelocity::GetVelocity(const LatticePosition& x,
+                                                        const LatticeTimeStep t) const
+      {
+
+        if (!useWeightsFromFile)
+        {
+          // v(r) = vMax (1 - r**2 / a**2)
+          // where r is the distance from the centreline
+          LatticePosition displ = x - position;
+          LatticeDistance z = Dot(displ, normal);
+          Dimensionless rSqOverASq = (displ.GetMagnitudeSquared() - z * z) / (radius * radius);
+          HASSERT(rSqOverASq <= 1.0);
+
+          // Get the max velocity
+          LatticeSpeed max = GetMaxVelocity(t);
+
+          // Brackets to ensure that the scalar multiplies are done before vector * scalar.
+          return normal * (max * (1. - rSqOverASq));
+        }
+        else
+        {
+          auto weight = FindWeight(x);
+          return weight ? normal * *weight * GetMaxVelocity(t) : normal * 0.0;
         }
 
       }
 
+      LatticeVelocity InOutLetFileVelocity::GetVelocityAtPoint(std::size_t point,
+                                                               const LatticeTimeStep t) const
+      {
+        // As GetVelocity, but with the factor looked up.
+        if (!useWeightsFromFile)
+          return normal * (GetMaxVelocity(t) * pointFactors[point]);
+        else
+          return normal * pointFactors[point] * GetMaxVelocity(t);
+      }
+
+      void InOutLetFileVelocity::PrecomputeVelocityPoint(std::size_t point)
+      {
+        pointFactors.resize(velocityPoints.size());
+        auto const& x = velocityPoints[point];
+        if (!useWeightsFromFile)
+        {
+          LatticePosition displ = x - position;
+          LatticeDistance z = Dot(displ, normal);
+          Dimensionless rSqOverASq = (displ.GetMagnitudeSquared() - z * z) / (radius * radius);
+          HASSERT(rSqOverASq <= 1.0);
+          pointFactors[point] = 1. - rSqOverASq;
+        }
+        else
+        {
+          // Sites with no weight get no velocity.
+          pointFactors[point] = FindWeight(x).value_or(0.0);
+        }
+      }
+
       void InOutLetFileVelocity::Initialise(const util::UnitConverter* unitConverter)
       {
         log::Logger::Log<log::Warning, log::OnePerCore>("Initializing vInlet.");
@@ -267,43 +338,19 @@ namespace hemelb::lb
         #endif
 
         if(useWeightsFromFile) {
-          //if the new velocity approximation is enabled, then we want to create a lookup table here.
-          const std::string in_name = velocityFilePath + ".weights.txt";
+          //if the new velocity approximation is enabled, then we want to create a lookup table
+          //here, from the binary weights file if there is one and the text one otherwise.
+          std::string in_name = velocityFilePath + ".weights.bin";
+          if (!std::filesystem::exists(in_name))
+              in_name = velocityFilePath + ".weights.txt";
           if (!std::filesystem::exists(in_name))
               throw Exception() << "File does not exist: " << in_name;
 
-          /* Load and read file. */
-          std::fstream myfile;
-          myfile.open(in_name, std::ios_base::in);
           log::Logger::Log<log::Warning, log::OnePerCore>("Loading weights file: %s",
                                                         in_name.c_str());
-
-          std::string input_line;
-          /* input files are in ASCII, in format:
-           *
-           * coord_x coord_y coord_z weights_value
-           *
-           * */
-          while (myfile.good()) //(std::getline(myfile, input_line))
-          {
-            int x, y, z;
-            double v;
-            myfile >> x >> y >> z >> v;
-
-            std::vector<int> xyz;
-            xyz.push_back(x);
-            xyz.push_back(y);
-            xyz.push_back(z);
-            weights_table[xyz] = v;
-
-            log::Logger::Log<log::Trace, log::OnePerCore>("%lld %lld %lld %f",
-            x,
-            y,
-            z,
-            weights_table[xyz]);
-          }
-          myfile.close();
+          weights_table = ReadVelocityWeights(in_name);
         }
+        PrecomputeVelocityPoints();
       }
 
 }
@@ -5,11 +5,34 @@
 #ifndef HEMELB_LB_IOLETS_INOUTLETFILEVELOCITY_H
 #define HEMELB_LB_IOLETS_INOUTLETFILEVELOCITY_H
 
-#include <map>
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <vector>
 #include "lb/iolets/InOutLetVelocity.h"
 
 namespace hemelb::lb
 {
+      //! The weight of one site in a velocity weights file.
+      struct VelocityWeight
+      {
+        std::array<int, 3> site;
+        double weight;
+      };
+
+      /**
+       * Read a velocity weights file, sorted by site. If a site appears more than once, the
+       * last weight for it is kept.
+       *
+       * The text form has a line "x y z weight" per site. The binary form, told apart by
+       * starting with VELOCITY_WEIGHTS_MAGIC, then has the number of sites as a 64-bit
+       * unsigned integer followed by a record of three 32-bit signed integers and a 64-bit
+       * float per site, all little-endian.
+       */
+      std::vector<VelocityWeight> ReadVelocityWeights(const std::filesystem::path& path);
+
+      //! The first 8 bytes of a binary velocity weights file.
+      inline constexpr char VELOCITY_WEIGHTS_MAGIC[8] = {'H', 'L', 'B', 'V', 'W', 'G', 'T', '1'};
 
       class InOutLetFileVelocity : public InOutLetVelocity
       {
@@ -35,6 +58,7 @@ namespace hemelb::lb
           }
 
           LatticeVelocity GetVelocity(const LatticePosition& x, const LatticeTimeStep t) const override;
+          LatticeVelocity GetVelocityAtPoint(std::size_t point, const LatticeTimeStep t) const override;
           /*LatticeVelocity GetVelocity2(const util::Vector3D<int64_t> globalCoordinates,
                                                                   const LatticeTimeStep t) const;*/
 
@@ -42,14 +66,29 @@ namespace hemelb::lb
 
           bool useWeightsFromFile;
 
+        protected:
+          void PrecomputeVelocityPoint(std::size_t point) override;
+
         private:
           std::string velocityFilePath;
           std::string velocityWeightsFilePath;
           void CalculateTable(LatticeTimeStep totalTimeSteps, PhysicalTime timeStepLength);
+          //! The maximum velocity over one loop of the profile.
           std::vector<LatticeSpeed> velocityTable;
+          LatticeSpeed GetMaxVelocity(LatticeTimeStep t) const
+          {
+            return velocityTable[t % velocityTable.size()];
+          }
           const util::UnitConverter* units;
 
-          std::map<std::vector<int>, double> weights_table;
+          //! The weights read from file, sorted by site.
+          std::vector<VelocityWeight> weights_table;
+          //! For each registered point, the factor (weight, or parabolic profile) by which the
+          //! maximum velocity is multiplied.
+          std::vector<double> pointFactors;
+
+          //! The weight for the site at x, or the first one found stepping along the normal.
+          std::optional<double> FindWeight(const LatticePosition& x) const;
 
           //double calcVTot(std::vector<double> v);
 
@@ -5,6 +5,7 @@
 
 #ifndef HEMELB_LB_IOLETS_INOUTLETVELOCITY_H
 #define HEMELB_LB_IOLETS_INOUTLETVELOCITY_H
+#include <vector>
 #include "lb/iolets/InOutLet.h"
 
 namespace hemelb::lb
@@ -34,16 +35,59 @@ namespace hemelb::lb
           void SetRadius(const LatticeDistance& r)
           {
             radius = r;
+            GeometryChanged();
           }
 
           virtual LatticeVelocity GetVelocity(const LatticePosition& x,
                                               const LatticeTimeStep t) const = 0;
 
+          /**
+           * Streamers that need the velocity at the same points on every step register each
+           * point once, at initialisation, and then ask for the velocity there by the index
+           * returned. This lets an iolet precompute whatever does not depend on time.
+           * @param x lattice position
+           * @return index of the point
+           */
+          std::size_t RegisterVelocityPoint(const LatticePosition& x)
+          {
+            velocityPoints.push_back(x);
+            PrecomputeVelocityPoint(velocityPoints.size() - 1);
+            return velocityPoints.size() - 1;
+          }
+
+          /**
+           * Get the velocity at a registered point; the same as GetVelocity at its position.
+           * @param point index returned by RegisterVelocityPoint
+           * @param t time
+           * @return velocity
+           */
+          virtual LatticeVelocity GetVelocityAtPoint(std::size_t point, const LatticeTimeStep t) const
+          {
+            return GetVelocity(velocityPoints[point], t);
+          }
+
           //virtual LatticeVelocity GetVelocity2(const util::Vector3D<site_t> globalCoordinates,
           //                                                          const LatticeTimeStep t) const = 0;
 
         protected:
+          void GeometryChanged() override
+          {
+            PrecomputeVelocityPoints();
+          }
+
+          //! Work out what is needed of the registered point for GetVelocityAtPoint.
+          virtual void PrecomputeVelocityPoint(std::size_t point)
+          {
+          }
+          //! Redo the above for all points, e.g. when a parameter changes.
+          void PrecomputeVelocityPoints()
+          {
+            for (std::size_t point = 0; point < velocityPoints.size(); ++point)
+              PrecomputeVelocityPoint(point);
+          }
+
           LatticeDistance radius;
+          std::vector<LatticePosition> velocityPoints;
       };
 }
 #endif // HEMELB_LB_IOLETS_INOUTLETVELOCITY_H
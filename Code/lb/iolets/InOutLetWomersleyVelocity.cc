@@ -18,25 +18,59 @@ namespace hemelb::lb
         return copy;
       }
 
-      LatticeVelocity InOutLetWomersleyVelocity::GetVelocity(const LatticePosition& x,
-                                                             const LatticeTimeStep t) const
+      InOutLetWomersleyVelocity::Complex InOutLetWomersleyVelocity::Profile(const LatticePosition& x) const
       {
         LatticePosition displ = x - position;
         LatticeDistance z = Dot(displ, normal);
         Dimensionless r = sqrt(displ.GetMagnitudeSquared() - z * z);
 
+        Complex besselNumer = util::BesselJ0ComplexArgument(iPowThreeHalves * womersleyNumber * r
+            / radius);
+        return 1.0 - besselNumer / besselDenominator;
+      }
+
+      InOutLetWomersleyVelocity::Complex InOutLetWomersleyVelocity::Phase(const LatticeTimeStep t) const
+      {
+        double omega = 2.0 * PI / period;
+        return exp(i * omega * double(t));
+      }
+
+      LatticeVelocity InOutLetWomersleyVelocity::Velocity(const Complex& profileValue,
+                                                          const Complex& phaseValue) const
+      {
         double omega = 2.0 * PI / period;
         LatticeDensity density = 1.0;
 
-        Complex besselNumer = util::BesselJ0ComplexArgument(iPowThreeHalves * womersleyNumber * r
-            / radius);
-        Complex besselDenom = util::BesselJ0ComplexArgument(iPowThreeHalves * womersleyNumber);
         LatticeSpeed velocityMagnitude = std::real(pressureGradientAmplitude / (density * omega)
-            * (1.0 - besselNumer / besselDenom) * exp(i * omega * double(t)));
+            * profileValue * phaseValue);
 
         return normal * -velocityMagnitude;
       }
 
+      LatticeVelocity InOutLetWomersleyVelocity::GetVelocity(const LatticePosition& x,
+                                                             const LatticeTimeStep t) const
+      {
+        return Velocity(Profile(x), Phase(t));
+      }
+
+      LatticeVelocity InOutLetWomersleyVelocity::GetVelocityAtPoint(std::size_t point,
+                                                                    const LatticeTimeStep t) const
+      {
+        return Velocity(profile[point], t == phaseStep ? phase : Phase(t));
+      }
+
+      void InOutLetWomersleyVelocity::PrepareTimeStep(LatticeTimeStep timeStep)
+      {
+        phaseStep = timeStep + 1;
+        phase = Phase(phaseStep);
+      }
+
+      void InOutLetWomersleyVelocity::PrecomputeVelocityPoint(std::size_t point)
+      {
+        profile.resize(velocityPoints.size());
+        profile[point] = Profile(velocityPoints[point]);
+      }
+
       const LatticePressureGradient& InOutLetWomersleyVelocity::GetPressureGradientAmplitude() const
       {
         return pressureGradientAmplitude;
@@ -56,6 +90,7 @@ namespace hemelb::lb
       void InOutLetWomersleyVelocity::SetPeriod(const LatticeTime& per)
       {
         period = per;
+        phase = Phase(phaseStep);
       }
 
       const Dimensionless& InOutLetWomersleyVelocity::GetWomersleyNumber() const
@@ -66,5 +101,7 @@ namespace hemelb::lb
       void InOutLetWomersleyVelocity::SetWomersleyNumber(const Dimensionless& womNumber)
       {
         womersleyNumber = womNumber;
+        besselDenominator = util::BesselJ0ComplexArgument(iPowThreeHalves * womersleyNumber);
+        PrecomputeVelocityPoints();
       }
     }
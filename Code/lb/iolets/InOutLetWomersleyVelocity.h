@@ -7,6 +7,7 @@
 #define HEMELB_LB_IOLETS_INOUTLETWOMERSLEYVELOCITY_H
 #include "lb/iolets/InOutLetVelocity.h"
 #include <complex>
+#include <vector>
 
 namespace hemelb::lb
 {
@@ -46,6 +47,24 @@ namespace hemelb::lb
            */
           LatticeVelocity GetVelocity(const LatticePosition& x, const LatticeTimeStep t) const override;
 
+          /**
+           * Get Womersley velocity at a registered point, from its precomputed radial profile.
+           *
+           * @param point index returned by RegisterVelocityPoint
+           * @param t time
+           * @return velocity
+           */
+          LatticeVelocity GetVelocityAtPoint(std::size_t point, const LatticeTimeStep t) const override;
+
+          /**
+           * Work out exp(i omega t) for the step streamers will ask about, which is
+           * the 1-indexed SimulationState::GetTimeStep, so that each point costs one
+           * complex multiply.
+           *
+           * @param timeStep the 0-indexed time step about to be simulated
+           */
+          void PrepareTimeStep(LatticeTimeStep timeStep) override;
+
           /**
            * Get the amplitude of the zero average pressure gradient sine wave imposed.
            *
@@ -88,13 +107,32 @@ namespace hemelb::lb
            */
           void SetWomersleyNumber(const Dimensionless& womNumber);
 
+        protected:
+          void PrecomputeVelocityPoint(std::size_t point) override;
+
         private:
           typedef std::complex<double> Complex;
           static const Complex i;
           static const Complex iPowThreeHalves;
           LatticePressureGradient pressureGradientAmplitude; ///< See class documentation
           LatticeTime period; ///< See class documentation
-          double womersleyNumber; ///< See class documentation
+          double womersleyNumber = 0.0; ///< See class documentation
+
+          //! J0(i^(3/2) womersleyNumber), which does not depend on position.
+          Complex besselDenominator = 1.0;
+          //! The radial profile, 1 - J0(i^(3/2) womersleyNumber r / radius) / besselDenominator,
+          //! at each registered point.
+          std::vector<Complex> profile;
+          //! exp(i omega t) at t = phaseStep, as set by PrepareTimeStep.
+          LatticeTimeStep phaseStep = 0;
+          Complex phase = 1.0;
+
+          //! The radial profile at x.
+          Complex Profile(const LatticePosition& x) const;
+          //! exp(i omega t).
+          Complex Phase(const LatticeTimeStep t) const;
+          //! The velocity where the radial profile and phase take the given values.
+          LatticeVelocity Velocity(const Complex& profileValue, const Complex& phaseValue) const;
       };
 }
 #endif // HEMELB_LB_IOLETS_INOUTLETWOMERSLEYVELOCITY_H
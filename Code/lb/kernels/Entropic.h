@@ -7,12 +7,17 @@
 #define HEMELB_LB_KERNELS_ENTROPIC_H
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
 #include "units.h"
 #include "lb/concepts.h"
 #include "lb/HFunction.h"
 #include "lb/LbmParameters.h"
+#include "reporting/Timers.h"
 #include "geometry/Domain.h"
 #include "util/utilityFunctions.h"
 
@@ -26,6 +31,14 @@ namespace hemelb::lb
     class EntropicBase
     {
     public:
+        /**
+         * Below this largest relative deviation, |f_eq - f| / f, of a site from
+         * equilibrium, alpha is taken from its series about the LBGK value of
+         * 2 without evaluating the H function. The error of that is of order
+         * the square of the deviation relative to the alpha - 2 it approximates.
+         */
+        static constexpr double APPROXIMATION_DEVIATION = 1.0E-3;
+
         /**
            * Performs the entropic LB collision (using alpha as a relaxation parameter)
            * @param lbmParams
@@ -35,7 +48,8 @@ namespace hemelb::lb
         void Collide(const LbmParameters* const lbmParams, HydroVarsType& hydroVars)
         {
             distribn_t alpha = CalculateAlpha(lbmParams->GetTau(),
-                                              hydroVars,
+                                              hydroVars.f,
+                                              hydroVars.f_eq,
                                               oldAlpha[hydroVars.index]);
             oldAlpha[hydroVars.index] = alpha;
 
@@ -48,101 +62,258 @@ namespace hemelb::lb
             }
         }
 
+        /**
+         * Publishes how alpha was found at the sites this thread has
+         * collided since it last did so. Called by the streamers at the
+         * end of each range of sites (see FinishKernelRange), so the
+         * timers' counters are only touched once per range rather than
+         * once per site.
+         */
+        void FinishRange()
+        {
+            if (timings != nullptr)
+            {
+                if (rangeCounts.analytic != 0)
+                    timings->AddToCounter(reporting::Timers::entropicAlphaAnalytic, rangeCounts.analytic);
+                if (rangeCounts.newtonRaphson != 0)
+                    timings->AddToCounter(reporting::Timers::entropicAlphaNewtonRaphson, rangeCounts.newtonRaphson);
+                if (rangeCounts.brent != 0)
+                    timings->AddToCounter(reporting::Timers::entropicAlphaBrent, rangeCounts.brent);
+            }
+            rangeCounts = AlphaCounts{};
+        }
+
     protected:
+        using const_span = typename LatticeType::const_span;
+        using mut_span = typename LatticeType::mut_span;
+
         /**
          * Constructs the alpha array.
          * @param initParams
          */
-        EntropicBase(InitParams* initParams) : oldAlpha(initParams->latDat->GetLocalFluidSiteCount())
+        EntropicBase(InitParams* initParams) :
+            oldAlpha(initParams->latDat->GetLocalFluidSiteCount()), timings(initParams->timings)
         {
             // Initialises the value of alpha to 2.0 for every site.
             std::fill(oldAlpha.begin(), oldAlpha.end(), 2.0);
         }
 
         /**
-         * Calculates the new value of alpha (the relaxation parameter) and updates the cache.
+         * Performs the entropic LB collision of the sites [first, first +
+         * V::size()), held in the lanes of SIMD vectors V. The equilibrium is
+         * recomputed from the density and momentum by calculateFeq (which must
+         * be an entropic one, see ApproximateAlpha). The deviation and the
+         * approximate alpha are found for all lanes together; only lanes too
+         * far from equilibrium for the approximation solve for alpha one at a
+         * time.
+         */
+        template<typename V, typename FeqFunction>
+        void CollideEntropicBatch(FeqFunction&& calculateFeq,
+                                  const LbmParameters* const lbmParams,
+                                  const site_t first,
+                                  const V& density,
+                                  const V& momentum_x, const V& momentum_y, const V& momentum_z,
+                                  const std::array<V, LatticeType::NUMVECTORS>& f,
+                                  std::array<V, LatticeType::NUMVECTORS>& fPostCollision)
+        {
+            constexpr Direction Q = LatticeType::NUMVECTORS;
+            constexpr auto W = V::size();
+            using std::abs;
+            using std::max;
+
+            std::array<V, Q> f_eq;
+            distribn_t laneFEq[Q];
+            for (std::size_t k = 0; k < W; ++k)
+            {
+                calculateFeq(distribn_t(density[k]),
+                             LatticeMomentum(momentum_x[k], momentum_y[k], momentum_z[k]),
+                             mut_span(laneFEq));
+                for (Direction i = 0; i < Q; ++i)
+                    f_eq[i][k] = laneFEq[i];
+            }
+
+            V deviation(0.0);
+            V guess = ApproximateAlpha(f, f_eq, deviation);
+
+            distribn_t laneF[Q];
+            std::uint64_t approximated = 0;
+            V alpha;
+            for (std::size_t k = 0; k < W; ++k)
+            {
+                const site_t index = first + site_t(k);
+                if (deviation[k] <= APPROXIMATION_DEVIATION)
+                {
+                    alpha[k] = guess[k];
+                    ++approximated;
+                }
+                else
+                {
+                    for (Direction i = 0; i < Q; ++i)
+                    {
+                        laneF[i] = f[i][k];
+                        laneFEq[i] = f_eq[i][k];
+                    }
+                    alpha[k] = SolveAlpha(lbmParams->GetTau(), const_span(laneF), const_span(laneFEq),
+                                          deviation[k], guess[k], oldAlpha[index]);
+                }
+                oldAlpha[index] = alpha[k];
+            }
+            rangeCounts.analytic += approximated;
+
+            const V alphaBeta = alpha * lbmParams->GetBeta();
+            for (Direction i = 0; i < Q; ++i)
+                fPostCollision[i] = f[i] + alphaBeta * (f[i] - f_eq[i]);
+        }
+
+        /**
+         * Calculates the new value of alpha (the relaxation parameter).
          * @param tau The value of tau to use as a basis for calculating alpha.
-         * @param hydroVars
+         * @param f
+         * @param f_eq
          * @param prevAlpha Alpha value from the previous timestep.
          * @return
          */
-        template<typename HydroVarsType>
-        double CalculateAlpha(const distribn_t tau, const HydroVarsType& hydroVars,
+        double CalculateAlpha(const distribn_t tau, const_span f, const_span f_eq,
                               double prevAlpha)
         {
-            bool big = false;
             double deviation = 0.0;
+            const double guess = ApproximateAlpha(f, f_eq, deviation);
+            if (deviation <= APPROXIMATION_DEVIATION)
+            {
+                ++rangeCounts.analytic;
+                return guess;
+            }
+            return SolveAlpha(tau, f, f_eq, deviation, guess, prevAlpha);
+        }
 
-            for (unsigned int i = 0; i < LatticeType::NUMVECTORS; i++)
+        /**
+         * Finds the largest relative deviation from equilibrium over the
+         * directions and approximates alpha from it. With x_i = (f_eq_i -
+         * f_i) / f_i and S_n the sum of f_i x_i^n, expanding H(f + alpha
+         * (f_eq - f)) = H(f) to fourth order in x about alpha = 2 gives
+         *
+         *     alpha ~ 2 + (S_3 - 2 S_4) / (3 S_2 - 4 S_3).
+         *
+         * This assumes the first-order term, the sum of (f_eq_i - f_i)
+         * ln(f_eq_i / w_i), vanishes, as it does for the entropic equilibria
+         * since they conserve density and momentum. An approximation that is
+         * not finite or not near 2 (from rounding at equilibrium) is replaced
+         * by 2, the LBGK value.
+         *
+         * Works on either doubles or SIMD vectors of them.
+         */
+        template<typename F, typename V>
+        static V ApproximateAlpha(const F& f, const F& f_eq, V& deviation)
+        {
+            using std::abs;
+            using std::max;
+            V s2(0.0), s3(0.0), s4(0.0);
+            for (Direction i = 0; i < LatticeType::NUMVECTORS; ++i)
+            {
+                const V x = (f_eq[i] - f[i]) / f[i];
+                deviation = max(deviation, V(abs(x)));
+                const V fx2 = f[i] * x * x;
+                s2 += fx2;
+                s3 += fx2 * x;
+                s4 += fx2 * x * x;
+            }
+            V guess = 2.0 + (s3 - 2.0 * s4) / (3.0 * s2 - 4.0 * s3);
+            if constexpr (std::is_floating_point_v<V>)
+            {
+                if (!(abs(guess - 2.0) <= 1.0))
+                    guess = 2.0;
+            }
+            else
             {
-              // Papers suggest f_eq - f < 0.001 or (f_eq - f)/f < 0.01 for the point to have approx alpha = 2
-              // Accuracy can change depending on stability requirements, because the more NR evaluations it skips
-              // the more of the simulation is in the LBGK limit.
-              deviation = util::NumericalFunctions::max(fabs( (hydroVars.f_eq[i] - hydroVars.f[i])
-                                                            / hydroVars.f[i]),
-                                                        deviation);
-              if (deviation > 1.0E-2)
-              {
-                big = true;
-                // if this is the case Brent isn't called so the value of deviation doesn't matter
-                break;
-              }
+                where(!(abs(guess - 2.0) <= 1.0), guess) = 2.0;
             }
+            return guess;
+        }
 
-            if (big)
+        /**
+         * Solves for alpha, for a site too far from equilibrium for the
+         * approximation.
+         * @param tau The value of tau to use as a basis for calculating alpha.
+         * @param f
+         * @param f_eq
+         * @param deviation The largest relative deviation from equilibrium.
+         * @param guess The approximate alpha.
+         * @param prevAlpha Alpha value from the previous timestep.
+         * @return
+         */
+        double SolveAlpha(const distribn_t tau, const_span f, const_span f_eq,
+                          double deviation, double guess, double prevAlpha)
+        {
+            HFunction<LatticeType> HFunc(f, f_eq);
+
+            // Papers suggest f_eq - f < 0.001 or (f_eq - f)/f < 0.01 for the point to have approx alpha = 2
+            // Accuracy can change depending on stability requirements, because the more NR evaluations it skips
+            // the more of the simulation is in the LBGK limit.
+            if (deviation > 1.0E-2)
             {
-              HFunction<LatticeType> HFunc(hydroVars.f, hydroVars.f_eq);
+              ++rangeCounts.newtonRaphson;
 
-              // This is in case previous Alpha was calculated to be zero (does happen occasionally if f_eq - f is small
+              // Start from the previous value, unless that was calculated to be (nearly) zero, which does
+              // happen occasionally if f_eq - f is small; then use the approximation.
               prevAlpha = (prevAlpha < 2.0 * tau ?
-                2.0 :
+                guess :
                 prevAlpha);
 
               return (util::NumericalMethods::NewtonRaphson(&HFunc, prevAlpha, 1.0E-6));
             }
-            else
+
+            ++rangeCounts.brent;
+
+            // The bracket is very large, but it should guarantee that a root is enclosed
+            double alphaLower = 2.0 * (tau), HLower;
+            double alphaHigher = 2.0 * (tau) / deviation, HHigher;
+
+            HFunc(alphaLower, HLower);
+            HFunc(alphaHigher, HHigher);
+
+            // The root should be enclosed, but in case it isn't return some default
+            // Chosen to return 2.0 as that is the LBGK case
+            // Very often if f is v close to equilibrium a root will not be enclosed (rounding and truncation errors)
+            // Doesn't really matter what is returned then as f_neq is negligible in that case
+            if (HLower * HHigher >= 0.0)
             {
-              // Happens a lot near equilibrium. In this limit we return LBGK to avoid unnecessary calculations
-              // Should really be a small number to accommodate round off and truncations errors, but only 0.0
-              // causes problems as it causes a NaN when bracketing in Brent.
-              if (deviation == 0.0)
-              {
-                return 2.0;
-              }
-
-              HFunction<LatticeType> HFunc(hydroVars.f, hydroVars.f_eq);
-
-              // The bracket is very large, but it should guarantee that a root is enclosed
-              double alphaLower = 2.0 * (tau), HLower;
-              double alphaHigher = 2.0 * (tau) / deviation, HHigher;
-
-              HFunc(alphaLower, HLower);
-              HFunc(alphaHigher, HHigher);
-
-              // The root should be enclosed, but in case it isn't return some default
-              // Chosen to return 2.0 as that is the LBGK case
-              // Very often if f is v close to equilibrium a root will not be enclosed (rounding and truncation errors)
-              // Doesn't really matter what is returned then as f_neq is negligible in that case
-              if (HLower * HHigher >= 0.0)
-              {
-                return 2.0;
-              }
-
-              return (util::NumericalMethods::Brent(&HFunc,
-                                                            alphaLower,
-                                                            HLower,
-                                                            alphaHigher,
-                                                            HHigher,
-                                                            1.0E-6,
-                                                            1.0E-12));
+              return 2.0;
             }
 
+            return (util::NumericalMethods::Brent(&HFunc,
+                                                          alphaLower,
+                                                          HLower,
+                                                          alphaHigher,
+                                                          HHigher,
+                                                          1.0E-6,
+                                                          1.0E-12));
         }
 
+        /**
+         * How many sites had their alpha found each way.
+         */
+        struct AlphaCounts
+        {
+            std::uint64_t analytic = 0;
+            std::uint64_t newtonRaphson = 0;
+            std::uint64_t brent = 0;
+        };
+
+        /**
+         * The counts for the range of sites this thread is colliding, not
+         * yet added to the timers (see FinishRange).
+         */
+        static inline thread_local AlphaCounts rangeCounts;
+
         /**
          * Stores the value of alpha (the relaxation parameter) from the previous iteration.
          */
         std::vector<distribn_t> oldAlpha;
+
+        /**
+         * Where to count how alpha was found; may be null.
+         */
+        reporting::Timers* timings;
     };
 }
 
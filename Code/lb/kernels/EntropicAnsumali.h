@@ -37,6 +37,9 @@ namespace hemelb::lb
         using LatticeType = L;
         using VarsType = HydroVars<EntropicAnsumali>;
 
+        // Bulk sites can be collided in SIMD batches (see StreamAndCollideBatches).
+        static constexpr bool supports_batch_collision = true;
+
         /**
          * Constructor, passes parameters onto the base class.
          * @param initParams
@@ -86,6 +89,27 @@ namespace hemelb::lb
                 hydroVars.f_neq[ii] = hydroVars.f[ii] - hydroVars.f_eq[ii];
             }
         }
+
+        /**
+         * Collides the sites [first, first + T::size()) held in the lanes of
+         * the SIMD vectors T, with the equilibrium as described by Ansumali.
+         * The f_eq passed is the polynomial one and is not used.
+         */
+        template<typename T>
+        void CollideBatch(const LbmParameters* const lbmParams,
+                          const site_t first,
+                          const T& density,
+                          const T& momentum_x, const T& momentum_y, const T& momentum_z,
+                          const std::array<T, LatticeType::NUMVECTORS>& f,
+                          const std::array<T, LatticeType::NUMVECTORS>& /* f_eq */,
+                          std::array<T, LatticeType::NUMVECTORS>& fPostCollision)
+        {
+            Base::CollideEntropicBatch(
+                    [](const distribn_t& rho, const LatticeMomentum& momentum, typename LatticeType::mut_span f_eq) {
+                        LatticeType::CalculateEntropicFeqAnsumali(rho, momentum, f_eq);
+                    },
+                    lbmParams, first, density, momentum_x, momentum_y, momentum_z, f, fPostCollision);
+        }
     };
 }
 
@@ -50,6 +50,12 @@ namespace hemelb::lb
         {
         }
 
+        template<class DataSource>
+        HydroVars(geometry::Site<DataSource> const &_site, typename LatticeType::const_span f) :
+                HydroVarsBase<LatticeType>(_site, f), force(_site.GetForce())
+        {
+        }
+
         HydroVars(typename LatticeType::const_span f, const LatticeForceVector& _force) :
                 HydroVarsBase<LatticeType>(f), force(_force)
         {
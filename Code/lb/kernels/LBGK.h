@@ -22,6 +22,8 @@ namespace hemelb::lb
         using LatticeType = L;
         using VarsType = HydroVars<LBGK>;
 
+        static constexpr bool supports_batch_collision = true;
+
         LBGK(InitParams& initParams)
         {
         }
@@ -61,6 +63,18 @@ namespace hemelb::lb
                                             + hydroVars.f_neq[direction]
                                               * lbmParams->GetOmega());
         }
+
+        //! Collide a batch of sites held in SIMD vectors (one lane per site).
+        template <typename T>
+        void CollideBatch(const LbmParameters* const lbmParams,
+                          const std::array<T, LatticeType::NUMVECTORS>& f,
+                          const std::array<T, LatticeType::NUMVECTORS>& f_eq,
+                          std::array<T, LatticeType::NUMVECTORS>& fPostCollision) const
+        {
+            const distribn_t omega = lbmParams->GetOmega();
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+                fPostCollision[direction] = f[direction] + (f[direction] - f_eq[direction]) * omega;
+        }
     };
 }
 #endif /* HEMELB_LB_KERNELS_LBGK_H */
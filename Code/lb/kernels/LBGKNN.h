@@ -6,7 +6,10 @@
 #ifndef HEMELB_LB_KERNELS_LBGKNN_H
 #define HEMELB_LB_KERNELS_LBGKNN_H
 
+#include <array>
 #include <cmath>
+#include <memory>
+#include <typeinfo>
 
 #include "hassert.h"
 #include "units.h"
@@ -14,6 +17,7 @@
 #include "lb/HydroVars.h"
 #include "lb/LbmParameters.h"
 #include "lb/SimulationState.h"
+#include "lb/kernels/RheologyTable.h"
 
 namespace hemelb::lb
 {
@@ -56,11 +60,27 @@ namespace hemelb::lb
         using LatticeType = L;
         using VarsType = HydroVars<LBGKNN>;
 
+        // CalculateFeq also updates the relaxation time stored for the
+        // site, so must not be called for the same site on two threads.
+        static constexpr bool feq_updates_site = true;
+
+        // Bulk sites can be collided in SIMD batches (see StreamAndCollideBatches).
+        static constexpr bool supports_batch_collision = true;
+
         LBGKNN(InitParams& initParams)
                 : mTau(initParams.latDat->GetLocalFluidSiteCount(), initParams.lbmParams->GetTau()),
                   mLbParams(*initParams.lbmParams),
                   mRheo(initParams)
         {
+            if (mLbParams.RheologyTableTolerance > 0.0)
+            {
+                auto& table = initParams.rheologyTables[typeid(tRheologyModel)];
+                if (!table)
+                    table = std::make_shared<const RheologyTable>(
+                            [this](PhysicalRate shearRate) { return CalculateTau(shearRate); },
+                            mLbParams.RheologyTableTolerance);
+                mTable = table;
+            }
         }
 
         void CalculateDensityMomentumFeq(VarsType& hydroVars, site_t index)
@@ -81,7 +101,7 @@ namespace hemelb::lb
             hydroVars.tau = mTau[index];
 
             // Compute the local relaxation time that will be used in the next time step
-            UpdateLocalTau(mTau[index], hydroVars);
+            UpdateLocalTau(mTau[index], hydroVars.f_neq, hydroVars.density);
         }
 
         void CalculateFeq(VarsType& hydroVars, site_t index)
@@ -100,7 +120,7 @@ namespace hemelb::lb
             hydroVars.tau = mTau[index];
 
             // Compute the local relaxation time that will be used in the next time step
-            UpdateLocalTau(mTau[index], hydroVars);
+            UpdateLocalTau(mTau[index], hydroVars.f_neq, hydroVars.density);
         }
 
         void Collide(const LbmParameters* const lbmParams, VarsType& hydroVars)
@@ -115,6 +135,38 @@ namespace hemelb::lb
             }
         }
 
+        /**
+         * Collides the sites [first, first + T::size()) held in the lanes
+         * of the SIMD vectors T, each with its relaxation time loaded from
+         * mTau, then updates those for the next time step as
+         * CalculateDensityMomentumFeq and Collide do for a single site.
+         */
+        template<typename T>
+        void CollideBatch(const LbmParameters* const lbmParams,
+                          const site_t first,
+                          const T& density,
+                          const T& /* momentum_x */, const T& /* momentum_y */, const T& /* momentum_z */,
+                          const std::array<T, LatticeType::NUMVECTORS>& f,
+                          const std::array<T, LatticeType::NUMVECTORS>& f_eq,
+                          std::array<T, LatticeType::NUMVECTORS>& fPostCollision)
+        {
+            constexpr Direction Q = LatticeType::NUMVECTORS;
+            HASSERT(first + site_t(T::size()) <= site_t(mTau.size()));
+
+            const T tau([&](auto k) { return mTau[first + site_t(k)]; });
+            const T omega = -1.0 / tau;
+            for (Direction direction = 0; direction < Q; ++direction)
+                fPostCollision[direction] = f[direction] + (f[direction] - f_eq[direction]) * omega;
+
+            distribn_t laneFNeq[Q];
+            for (std::size_t k = 0; k < T::size(); ++k)
+            {
+                for (Direction direction = 0; direction < Q; ++direction)
+                    laneFNeq[direction] = f[direction][k] - f_eq[direction][k];
+                UpdateLocalTau(mTau[first + site_t(k)], typename LatticeType::const_span(laneFNeq), density[k]);
+            }
+        }
+
         /*
          *  Helper method used in testing in order to access the mTau array after
          *  being set by CalculateDensityMomentumFeq
@@ -138,6 +190,16 @@ namespace hemelb::lb
         // Our rheology model
         tRheologyModel mRheo;
 
+        // Its tabulation, if asked for, shared with the other kernels of
+        // this type through InitParams
+        std::shared_ptr<const RheologyTable> mTable;
+
+        LatticeTime CalculateTau(PhysicalRate shearRate) const
+        {
+            // None of the models depend on the density.
+            return mRheo.CalculateTauForShearRate(shearRate, 1.0, mLbParams);
+        }
+
         /**
          *  Helper method to update the value of local relaxation time (tau) from a given hydrodynamic
          *  configuration. It requires values of f_neq and density at the current time step and it will
@@ -145,22 +207,27 @@ namespace hemelb::lb
          *
          *  @param localTau input: tau being used during the current time step,
          *                  output: tau to be used in the following time step
-         *  @param hydroVars hydrodynamic configuration for a given lattice site
+         *  @param fNeq non-equilibrium distributions at a given lattice site
+         *  @param density density at that site
          */
-        void UpdateLocalTau(distribn_t& localTau, VarsType& hydroVars) const
+        void UpdateLocalTau(distribn_t& localTau, typename LatticeType::const_span fNeq,
+                            const distribn_t density) const
         {
             /*
              * Shear-rate returned by CalculateShearRate is dimensionless and CalculateTauForShearRate
              * wants it in units of s^{-1}
              */
             double shear_rate = LatticeType::CalculateShearRate(localTau,
-                                                                hydroVars.f_neq,
-                                                                hydroVars.density) / mLbParams.GetTimeStep();
+                                                                fNeq,
+                                                                density) / mLbParams.GetTimeStep();
 
             // Update tau
-            localTau = mRheo.CalculateTauForShearRate(shear_rate,
-						      hydroVars.density,
-						      mLbParams);
+            if (mTable)
+                localTau = mTable->Evaluate(shear_rate, [this](PhysicalRate s) { return CalculateTau(s); });
+            else
+                localTau = mRheo.CalculateTauForShearRate(shear_rate,
+                                                          density,
+                                                          mLbParams);
 
             // In some rheology models viscosity tends to infinity as shear rate goes to zero.
             HASSERT(!std::isinf(localTau));
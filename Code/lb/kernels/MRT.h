@@ -6,7 +6,9 @@
 #ifndef HEMELB_LB_KERNELS_MRT_H
 #define HEMELB_LB_KERNELS_MRT_H
 
+#include "build_info.h"
 #include "lb/SimulationState.h"
+#include <array>
 #include <cassert>
 #include <cmath>
 
@@ -35,6 +37,11 @@ namespace hemelb::lb
      *  versions of {m,f}.
      *
      *  (M * M^T)^{-1} and \hat{S} are diagonal matrices.
+     *
+     *  With HEMELB_USE_FUSED_MRT the product M^T * (M * M^T)^{-1} * \hat{S} * M is
+     *  formed once, as a Q x Q matrix, and the collision applies it directly to f_{neq}
+     *  without going through moment space. The batched collision of bulk sites always
+     *  does so, as a small matrix-matrix product with one column per site.
      */
     template<moment_basis M>
     class MRT
@@ -48,9 +55,13 @@ namespace hemelb::lb
         static constexpr std::size_t NUMMOMENTS = MomentType::NUMMOMENTS;
         static constexpr std::size_t NUMVECTORS = LatticeType::NUMVECTORS;
 
+        // Bulk sites can be collided in SIMD batches (see StreamAndCollideBatches).
+        static constexpr bool supports_batch_collision = true;
+
         MRT(InitParams& initParams) :
                 collisionMatrixDiagonals(MomentType::SetUpCollisionMatrix(initParams.lbmParams->GetTau()))
         {
+            FuseCollisionOperator();
         }
 
         void CalculateDensityMomentumFeq(VarsType& hydroVars, site_t index)
@@ -65,33 +76,70 @@ namespace hemelb::lb
             {
                 hydroVars.f_neq[ii] = hydroVars.f[ii] - hydroVars.f_eq[ii];
             }
-
-            /** @todo #222 consider computing m_neq directly in the momentum space. See d'Humieres 2002. */
-            ProjectVelsIntoMomentSpace(hydroVars.f_neq, hydroVars.m_neq);
         }
 
         void CalculateFeq(VarsType& hydroVars, site_t index)
         {
             LatticeType::CalculateFeq(hydroVars.density,
-                                               hydroVars.momentum,
-                                               hydroVars.f_eq.f);
+                                      hydroVars.momentum,
+                                      hydroVars.f_eq);
 
             for (unsigned int ii = 0; ii < NUMVECTORS; ++ii)
             {
-              hydroVars.f_neq.f[ii] = hydroVars.f[ii] - hydroVars.f_eq.f[ii];
+              hydroVars.f_neq[ii] = hydroVars.f[ii] - hydroVars.f_eq[ii];
             }
-
-            /** @todo #222 consider computing m_neq directly in the moment space. See d'Humieres 2002. */
-            MomentType::ProjectVelsIntoMomentSpace(hydroVars.f_neq.f, hydroVars.m_neq);
           }
 
         void Collide(const LbmParameters* const lbmParams, VarsType& hydroVars)
         {
+            if constexpr (build_info::USE_FUSED_MRT)
+                CollideFused(hydroVars);
+            else
+                CollideInMomentSpace(hydroVars);
+        }
+
+        /**
+         * Collides the bulk sites held in the lanes of the (SIMD) vectors T,
+         * applying the fused operator to all of them together.
+         */
+        template<typename T>
+        void CollideBatch(const LbmParameters* const lbmParams,
+                          const std::array<T, NUMVECTORS>& f,
+                          const std::array<T, NUMVECTORS>& f_eq,
+                          std::array<T, NUMVECTORS>& fPostCollision) const
+        {
+            std::array<T, NUMVECTORS> f_neq;
+            for (Direction direction = 0; direction < NUMVECTORS; ++direction)
+                f_neq[direction] = f[direction] - f_eq[direction];
+            ApplyFusedOperator(f_neq, fPostCollision);
+            for (Direction direction = 0; direction < NUMVECTORS; ++direction)
+                fPostCollision[direction] = f[direction] - fPostCollision[direction];
+        }
+
+        /**
+         * The collision as the fused Q x Q operator applied to f_neq. This
+         * is what Collide does with HEMELB_USE_FUSED_MRT; it is public for
+         * comparison with the other way.
+         */
+        void CollideFused(VarsType& hydroVars) const
+        {
+            std::array<distribn_t, NUMVECTORS> collision;
+            ApplyFusedOperator(hydroVars.f_neq, collision);
+            for (Direction direction = 0; direction < NUMVECTORS; ++direction)
+                hydroVars.SetFPostCollision(direction, hydroVars.f[direction] - collision[direction]);
+        }
+
+        /**
+         * The collision via the moments of f_neq. This is what Collide
+         * does without HEMELB_USE_FUSED_MRT.
+         */
+        void CollideInMomentSpace(VarsType& hydroVars) const
+        {
+            /** @todo #222 consider computing m_neq directly in the moment space. See d'Humieres 2002. */
+            ProjectVelsIntoMomentSpace(hydroVars.f_neq, hydroVars.m_neq);
+
             for (Direction direction = 0; direction < NUMVECTORS; ++direction)
             {
-              /** @todo #222 many optimisations possible (and necessary!).
-               *  - Compute the loop below as a matrix product in DoCalculate*, alternatively we could consider reimplementing DoCollide to work with whole arrays (consider libraries boost::ublas or Armadillo)
-               */
               distribn_t collision = 0.;
               for (unsigned momentIndex = 0; momentIndex < NUMMOMENTS;
                   momentIndex++)
@@ -111,9 +159,52 @@ namespace hemelb::lb
         void SetMrtRelaxationParameters(ConstDistSpan<NUMMOMENTS> newRelaxationParameters)
         {
             std::copy(newRelaxationParameters.begin(), newRelaxationParameters.end(), collisionMatrixDiagonals.begin());
+            FuseCollisionOperator();
         }
 
     private:
+        /**
+         * Forms the fused operator for the current relaxation parameters,
+         * storing it by columns: column j holds the collision caused by a
+         * unit f_neq in direction j.
+         */
+        void FuseCollisionOperator()
+        {
+            for (Direction j = 0; j < NUMVECTORS; ++j)
+            {
+                for (Direction i = 0; i < NUMVECTORS; ++i)
+                {
+                    distribn_t element = 0.;
+                    for (unsigned momentIndex = 0; momentIndex < NUMMOMENTS; ++momentIndex)
+                    {
+                        element += collisionMatrixDiagonals[momentIndex]
+                                   * normalisedReducedMomentBasis[momentIndex][i]
+                                   * MomentType::REDUCED_MOMENT_BASIS[momentIndex][j];
+                    }
+                    fusedOperatorColumns[j][i] = element;
+                }
+            }
+        }
+
+        /**
+         * collision = fused operator * f_neq, for a single site (T a
+         * distribution) or one site per lane (T a SIMD vector). It is
+         * accumulated a column at a time so that the loop over the
+         * outputs has contiguous, independent elements and vectorises.
+         */
+        template<typename F, typename T>
+        void ApplyFusedOperator(const F& f_neq, std::array<T, NUMVECTORS>& collision) const
+        {
+            for (Direction i = 0; i < NUMVECTORS; ++i)
+                collision[i] = fusedOperatorColumns[0][i] * f_neq[0];
+            for (Direction j = 1; j < NUMVECTORS; ++j)
+            {
+                const T f_neq_j = f_neq[j];
+                for (Direction i = 0; i < NUMVECTORS; ++i)
+                    collision[i] += fusedOperatorColumns[j][i] * f_neq_j;
+            }
+        }
+
         /**
          * Projects a velocity distributions vector into the (reduced) MRT moment space.
          *
@@ -136,6 +227,8 @@ namespace hemelb::lb
 
         /** MRT collision matrix (\hat{S}, diagonal). It corresponds to the inverse of the relaxation time for each mode. */
         std::array<distribn_t, NUMMOMENTS> collisionMatrixDiagonals;
+        /** The fused operator, M^T * (M * M^T)^{-1} * \hat{S} * M, by columns. */
+        alignas(64) std::array<std::array<distribn_t, NUMVECTORS>, NUMVECTORS> fusedOperatorColumns;
         static constexpr MatrixType Normalise() {
             // Pre-compute the reduced moment basis divided by the basis times basis transposed.
             MatrixType ans;
@@ -0,0 +1,68 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "lb/kernels/RheologyTable.h"
+
+#include <cmath>
+
+#include "Exception.h"
+#include "log/Logger.h"
+
+namespace hemelb::lb
+{
+    RheologyTable::RheologyTable(TauFunction const& tau, double tolerance)
+    {
+        if (!(tolerance > 0.0))
+            throw (Exception() << "Rheology table tolerance must be positive, got " << tolerance);
+
+        // Use the fewest segments that meet the tolerance everywhere but
+        // at a few kinks.
+        unsigned bits = 0;
+        std::size_t failed;
+        while ((failed = Fit(tau, tolerance, bits)) > MAX_EXACT_SEGMENTS && bits < MAX_BITS)
+            ++bits;
+
+        log::Logger::Log<log::Info, log::Singleton>(
+                "Tabulated rheology in %lu segments (%u bits per binade), %lu evaluated exactly",
+                segments.size(), bits, failed);
+    }
+
+    std::size_t RheologyTable::Fit(TauFunction const& tau, double tolerance, unsigned bits)
+    {
+        shift = 52 - bits;
+        first = std::bit_cast<std::uint64_t>(MIN_SHEAR_RATE) >> shift;
+        auto const end = std::bit_cast<std::uint64_t>(MAX_SHEAR_RATE) >> shift;
+        segments.resize(end - first);
+
+        std::size_t failed = 0;
+        for (std::uint64_t i = 0; i < segments.size(); ++i)
+        {
+            auto& s = segments[i];
+            s.start = std::bit_cast<PhysicalRate>((first + i) << shift);
+            auto const h = std::bit_cast<PhysicalRate>((first + i + 1) << shift) - s.start;
+
+            // The quadratic through the start, middle and end.
+            auto const f0 = tau(s.start);
+            auto const fm = tau(s.start + h / 2);
+            auto const f1 = tau(s.start + h);
+            s.c0 = f0;
+            s.c2 = 2.0 * (f1 - 2.0 * fm + f0) / (h * h);
+            s.c1 = (f1 - f0) / h - s.c2 * h;
+
+            // Check the viscosity in between.
+            s.exact = false;
+            for (int j = 1; j < 8; ++j)
+            {
+                auto const x = h * j / 8;
+                auto const expected = tau(s.start + x) - 0.5;
+                auto const actual = s.c0 + x * (s.c1 + x * s.c2) - 0.5;
+                if (!(std::abs(actual - expected) <= tolerance * std::abs(expected)))
+                    s.exact = true;
+            }
+            failed += s.exact;
+        }
+        return failed;
+    }
+}
@@ -0,0 +1,92 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_LB_KERNELS_RHEOLOGYTABLE_H
+#define HEMELB_LB_KERNELS_RHEOLOGYTABLE_H
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "units.h"
+
+namespace hemelb::lb
+{
+    /**
+     * Piecewise-quadratic approximation of the relaxation time as a
+     * function of shear rate, to save evaluating a rheology model
+     * (typically a couple of calls to pow) for every site on every step.
+     *
+     * The segments are the binades of the shear rate, each split into
+     * 2^bits equal parts, so the segment containing a shear rate is
+     * found from the top bits of its representation, without a log.
+     * Enough bits are used that the viscosity (tau - 1/2) is within the
+     * given relative tolerance of the model's, checked at several points
+     * in each segment. The few segments where a model isn't smooth
+     * enough for that (e.g. where a viscosity is capped), and shear rates
+     * outside [MIN_SHEAR_RATE, MAX_SHEAR_RATE), are evaluated exactly.
+     *
+     * Only valid for models whose relaxation time doesn't depend on the
+     * local density, which is true of all those in HemeLB.
+     */
+    class RheologyTable
+    {
+    public:
+        using TauFunction = std::function<LatticeTime(PhysicalRate)>;
+
+        static constexpr PhysicalRate MIN_SHEAR_RATE = 0x1p-20; // s^{-1}
+        static constexpr PhysicalRate MAX_SHEAR_RATE = 0x1p24; // s^{-1}
+        static constexpr unsigned MAX_BITS = 10;
+        static constexpr unsigned MAX_EXACT_SEGMENTS = 4;
+
+        RheologyTable(TauFunction const& tau, double tolerance);
+
+        /**
+         * The relaxation time for a shear rate, calling exact if that
+         * isn't tabulated.
+         */
+        template <typename F>
+        LatticeTime Evaluate(PhysicalRate shearRate, F&& exact) const
+        {
+            if (!(shearRate >= MIN_SHEAR_RATE && shearRate < MAX_SHEAR_RATE))
+                return exact(shearRate);
+            auto const& s = segments[(std::bit_cast<std::uint64_t>(shearRate) >> shift) - first];
+            if (s.exact)
+                return exact(shearRate);
+            auto const x = shearRate - s.start;
+            return s.c0 + x * (s.c1 + x * s.c2);
+        }
+
+        unsigned GetBits() const
+        {
+            return 52 - shift;
+        }
+        std::size_t GetSegmentCount() const
+        {
+            return segments.size();
+        }
+
+    private:
+        struct Segment
+        {
+            PhysicalRate start;
+            LatticeTime c0;
+            double c1;
+            double c2;
+            bool exact;
+        };
+
+        // Fit every segment when split by this many bits, returning how
+        // many exceed the tolerance.
+        std::size_t Fit(TauFunction const& tau, double tolerance, unsigned bits);
+
+        std::vector<Segment> segments;
+        unsigned shift;
+        std::uint64_t first;
+    };
+}
+
+#endif /* HEMELB_LB_KERNELS_RHEOLOGYTABLE_H */
@@ -45,7 +45,7 @@ namespace hemelb::lb
             for (Direction i = 0; i < LatticeType::NUMVECTORS; ++i)
             {
                 Direction iBar = LatticeType::INVERSEDIRECTIONS[i];
-                if (iBar >= i) {
+                if (iBar > i) {
                     ans[j] = {i, iBar};
                     ++j;
                 }
@@ -55,6 +55,8 @@ namespace hemelb::lb
         static constexpr auto directionPairs = MakeOpposites();
 
     public:
+        static constexpr bool supports_batch_collision = true;
+
         TRT(InitParams& initParams)
         {
         }
@@ -63,31 +65,25 @@ namespace hemelb::lb
         {
             LatticeType::CalculateDensityMomentumFEq(hydroVars.f,
                                                      hydroVars.density,
-                                                     hydroVars.momentum.x,
-                                                     hydroVars.momentum.y,
-                                                     hydroVars.momentum.z,
-                                                     hydroVars.velocity.x,
-                                                     hydroVars.velocity.y,
-                                                     hydroVars.velocity.z,
-                                                     hydroVars.f_eq.f);
+                                                     hydroVars.momentum,
+                                                     hydroVars.velocity,
+                                                     hydroVars.f_eq);
 
             for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
             {
-                hydroVars.f_neq.f[ii] = hydroVars.f[ii] - hydroVars.f_eq.f[ii];
+                hydroVars.f_neq[ii] = hydroVars.f[ii] - hydroVars.f_eq[ii];
             }
         }
 
         void CalculateFeq(VarsType& hydroVars, site_t index)
         {
             LatticeType::CalculateFeq(hydroVars.density,
-                                      hydroVars.momentum.x,
-                                      hydroVars.momentum.y,
-                                      hydroVars.momentum.z,
-                                      hydroVars.f_eq.f);
+                                      hydroVars.momentum,
+                                      hydroVars.f_eq);
 
             for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
             {
-                hydroVars.f_neq.f[ii] = hydroVars.f[ii] - hydroVars.f_eq.f[ii];
+                hydroVars.f_neq[ii] = hydroVars.f[ii] - hydroVars.f_eq[ii];
             }
         }
 
@@ -108,18 +104,47 @@ namespace hemelb::lb
             if constexpr (HasZero) {
                 // Special case the null velocity.
                 hydroVars.SetFPostCollision(iZero,
-                                            hydroVars.f[iZero] + omega_plus * hydroVars.f_neq.f[iZero]);
+                                            hydroVars.f[iZero] + omega_plus * hydroVars.f_neq[iZero]);
             }
 
             // Now deal with the non-zero
             for (auto [i, iBar]: directionPairs)
             {
-                distribn_t sym = 0.5 * omega_plus * (hydroVars.f_neq.f[i] + hydroVars.f_neq.f[iBar]);
-                distribn_t asym = 0.5 * omega_minus * (hydroVars.f_neq.f[i] - hydroVars.f_neq.f[iBar]);
+                distribn_t sym = 0.5 * omega_plus * (hydroVars.f_neq[i] + hydroVars.f_neq[iBar]);
+                distribn_t asym = 0.5 * omega_minus * (hydroVars.f_neq[i] - hydroVars.f_neq[iBar]);
                 hydroVars.SetFPostCollision(i, hydroVars.f[i] + sym + asym);
                 hydroVars.SetFPostCollision(iBar, hydroVars.f[iBar] + sym - asym);
             }
         }
+
+        //! Collide a batch of sites held in SIMD vectors (one lane per site).
+        template <typename T>
+        void CollideBatch(const LbmParameters* const lbmParams,
+                          const std::array<T, LatticeType::NUMVECTORS>& f,
+                          const std::array<T, LatticeType::NUMVECTORS>& f_eq,
+                          std::array<T, LatticeType::NUMVECTORS>& fPostCollision) const
+        {
+            // As in Collide above.
+            const distribn_t Lambda = 3.0 / 16.0;
+            const distribn_t tau_plus = lbmParams->GetTau();
+            const distribn_t omega_plus = lbmParams->GetOmega();
+            const distribn_t tau_minus = 0.5 + Lambda / (tau_plus - 0.5);
+            const distribn_t omega_minus =  -1.0 / tau_minus;
+
+            if constexpr (HasZero) {
+                fPostCollision[iZero] = f[iZero] + omega_plus * (f[iZero] - f_eq[iZero]);
+            }
+
+            for (auto [i, iBar]: directionPairs)
+            {
+                const T fNeq = f[i] - f_eq[i];
+                const T fNeqBar = f[iBar] - f_eq[iBar];
+                const T sym = 0.5 * omega_plus * (fNeq + fNeqBar);
+                const T asym = 0.5 * omega_minus * (fNeq - fNeqBar);
+                fPostCollision[i] = f[i] + sym + asym;
+                fPostCollision[iBar] = f[iBar] + sym - asym;
+            }
+        }
     };
 }
 
@@ -8,6 +8,7 @@
 
 #include <cmath>
 #include <span>
+#include <utility>
 #ifdef HEMELB_USE_SSE3
 #include <immintrin.h>
 #endif
@@ -67,6 +68,38 @@ namespace hemelb::lb
             }
             return ans;
         }
+
+        // The directions of a lattice as the rest (zero) vector, if
+        // there is one, and pairs of opposite directions: first[p] and
+        // second[p] are inverses of each other.
+        template <std::size_t N>
+        struct DirectionPairs {
+            std::array<Direction, N / 2> first;
+            std::array<Direction, N / 2> second;
+            // The rest vector, or N if there isn't one.
+            Direction rest;
+        };
+
+        template <std::size_t N>
+        constexpr DirectionPairs<N> compute_pairs(std::array<util::Vector3D<int>, N> const& vecs)
+        {
+            auto const inverses = compute_inverses(vecs);
+            DirectionPairs<N> ans{};
+            ans.rest = N;
+            std::size_t p = 0;
+            for (std::size_t i = 0; i < N; ++i) {
+                if (inverses[i] == i) {
+                    if (ans.rest != N)
+                        throw "More than one rest vector";
+                    ans.rest = i;
+                } else if (inverses[i] > i) {
+                    ans.first[p] = i;
+                    ans.second[p] = inverses[i];
+                    ++p;
+                }
+            }
+            return ans;
+        }
     }
 
 
@@ -92,106 +125,144 @@ namespace hemelb::lb
         alignas(16) static constexpr FArray EQMWEIGHTS = W;
         // The index of the inverse direction of each discrete velocity vector
         static constexpr std::array<Direction, Q> INVERSEDIRECTIONS = detail::compute_inverses(V);
+        // The directions split into the rest vector and pairs of opposites
+        static constexpr detail::DirectionPairs<Q> PAIRS = detail::compute_pairs(V);
 
         using mut_span = MutDistSpan<Q>;
         using const_span = ConstDistSpan<Q>;
 
-#ifdef HEMELB_USE_SSE3
-        inline static void CalculateDensityAndMomentum(const_span f,
-                                                       distribn_t &density,
-                                                       util::Vector3D<distribn_t>& momentum) {
-            CalculateDensityAndMomentum(f, density, momentum.x(), momentum.y(), momentum.z());
+    private:
+        // c * x for a lattice vector component c, without multiplying
+        // by +-1.
+        template <int C, typename T>
+        static constexpr T Times(const T& x) {
+            if constexpr (C == 1)
+                return x;
+            else if constexpr (C == -1)
+                return -x;
+            else
+                return distribn_t(C) * x;
         }
-        /**
-         * Calculates density and momentum using SSE3 intrinsics.
-         * If the lattice has an odd number of vectors (directions),
-         * the last element is processed first
-         *
-         * The reductions are calculated in two streams (the loop is virtually
-         * twice unrolled), followed by horizontal adds to sum two partial results together
-         *
-         * @param f
-         * @param density
-         * @param momentum_x
-         * @param momentum_y
-         * @param momentum_z
-         */
-        inline static void CalculateDensityAndMomentum(const_span f,
-                                                       distribn_t &density,
-                                                       distribn_t &momentum_x,
-                                                       distribn_t &momentum_y,
-                                                       distribn_t &momentum_z)
-        {
-            // SSE2 accumulator registers containing a pair of double values
-            __m128d density_SSE2;
-            __m128d momentum_x_SSE2;
-            __m128d momentum_y_SSE2;
-            __m128d momentum_z_SSE2;
-
-            // set the loop boundary to the highest even number  =< NUMVECTORS
-            Direction numVect2 = ((NUMVECTORS >> 1) << 1);
 
-            // process the 15/19/27th element first
-            if (NUMVECTORS != numVect2)
-            {
-              // the first double is set to the result of the last element, the second double to zero
-              density_SSE2 = _mm_set_pd(f[NUMVECTORS - 1], 0.0);
-              momentum_x_SSE2 = _mm_set_pd(CXD[NUMVECTORS - 1] * f[NUMVECTORS - 1], 0.0);
-              momentum_y_SSE2 = _mm_set_pd(CYD[NUMVECTORS - 1] * f[NUMVECTORS - 1], 0.0);
-              momentum_z_SSE2 = _mm_set_pd(CZD[NUMVECTORS - 1] * f[NUMVECTORS - 1], 0.0);
-            }
+        // c_i . (x, y, z), leaving out the zero components of c_i.
+        template <Direction I, typename T>
+        static constexpr T DotDirection(const T& x, const T& y, const T& z) {
+            constexpr int cx = CX[I], cy = CY[I], cz = CZ[I];
+            if constexpr (cx != 0 && cy != 0 && cz != 0)
+                return Times<cx>(x) + Times<cy>(y) + Times<cz>(z);
+            else if constexpr (cx != 0 && cy != 0)
+                return Times<cx>(x) + Times<cy>(y);
+            else if constexpr (cx != 0 && cz != 0)
+                return Times<cx>(x) + Times<cz>(z);
+            else if constexpr (cy != 0 && cz != 0)
+                return Times<cy>(y) + Times<cz>(z);
+            else if constexpr (cx != 0)
+                return Times<cx>(x);
+            else if constexpr (cy != 0)
+                return Times<cy>(y);
             else
-            {
-              // set the SSE accumulators to zero
-              density_SSE2 = _mm_set1_pd(0.0);
-              momentum_x_SSE2 = _mm_set1_pd(0.0);
-              momentum_y_SSE2 = _mm_set1_pd(0.0);
-              momentum_z_SSE2 = _mm_set1_pd(0.0);
-            }
-
-            //SSE loop processing two elements at once
-            for (Direction direction = 0; direction < numVect2; direction += 2)
-            {
+                return Times<cz>(z);
+        }
 
-              // f is not aligned, loadu has to be used,
-              // CXD, CYD, CZD are supposed to be 16B aligned
-              const __m128d f_SSE2 = _mm_loadu_pd(&f[direction]);
-              const __m128d CX_SSE2 = _mm_load_pd(&CXD[direction]);
-              const __m128d CY_SSE2 = _mm_load_pd(&CYD[direction]);
-              const __m128d CZ_SSE2 = _mm_load_pd(&CZD[direction]);
+        // sum += c * x, or nothing if c is zero.
+        template <int C, typename T>
+        static constexpr void AddTimes(T& sum, const T& x) {
+            if constexpr (C != 0)
+                sum += Times<C>(x);
+        }
 
-              // density += f[i]
-              density_SSE2 = _mm_add_pd(density_SSE2, f_SSE2);
+        template <typename F, typename T, std::size_t... P>
+        static void UnrolledDensityAndMomentum(const F& f, T& density,
+                                               T& momentum_x, T& momentum_y, T& momentum_z,
+                                               std::index_sequence<P...>)
+        {
+            if constexpr (PAIRS.rest < Q)
+                density = f[PAIRS.rest];
+            else
+                density = 0.0;
+            momentum_x = momentum_y = momentum_z = 0.0;
+            ([&] {
+                constexpr Direction i = PAIRS.first[P], j = PAIRS.second[P];
+                density += f[i] + f[j];
+                // c_j = -c_i, so each pair adds c_i (f_i - f_j) to the momentum.
+                const T difference = f[i] - f[j];
+                AddTimes<CX[i]>(momentum_x, difference);
+                AddTimes<CY[i]>(momentum_y, difference);
+                AddTimes<CZ[i]>(momentum_z, difference);
+            }(), ...);
+        }
 
-              // momentum_x += CX[i] * f[i]]
-              momentum_x_SSE2 = _mm_add_pd(momentum_x_SSE2, _mm_mul_pd(CX_SSE2, f_SSE2));
-              momentum_y_SSE2 = _mm_add_pd(momentum_y_SSE2, _mm_mul_pd(CY_SSE2, f_SSE2));
-              momentum_z_SSE2 = _mm_add_pd(momentum_z_SSE2, _mm_mul_pd(CZ_SSE2, f_SSE2));
+        template <typename T, typename F, std::size_t... P>
+        static void UnrolledFeq(const T& density, const T& momentum_x, const T& momentum_y,
+                                const T& momentum_z, F& f_eq, std::index_sequence<P...>)
+        {
+            // f_eq[i] = w_i * (A + B * (c_i.u)^2 + 3 * c_i.u), where
+            // A = density - (3/2) |momentum|^2 / DENSITY and B = (9/2) / DENSITY,
+            // DENSITY being density if compressible, else 1. The even
+            // part is shared by the pair i, j; the odd part changes sign.
+            const T momentumMagnitudeSquared = momentum_x * momentum_x + momentum_y * momentum_y
+                    + momentum_z * momentum_z;
+            T a, b;
+            if constexpr (COMPRESSIBLE) {
+                const T density_1 = 1. / density;
+                a = density - (3. / 2.) * momentumMagnitudeSquared * density_1;
+                b = (9. / 2.) * density_1;
+            } else {
+                a = density - (3. / 2.) * momentumMagnitudeSquared;
+                b = T(9. / 2.);
             }
 
-            // horizontal adds to sum partial results and store them back to memory
-            _mm_store_sd(&density, _mm_hadd_pd(density_SSE2, density_SSE2));
-            _mm_store_sd(&momentum_x, _mm_hadd_pd(momentum_x_SSE2, momentum_x_SSE2));
-            _mm_store_sd(&momentum_y, _mm_hadd_pd(momentum_y_SSE2, momentum_y_SSE2));
-            _mm_store_sd(&momentum_z, _mm_hadd_pd(momentum_z_SSE2, momentum_z_SSE2));
+            if constexpr (PAIRS.rest < Q)
+                f_eq[PAIRS.rest] = EQMWEIGHTS[PAIRS.rest] * a;
+            ([&] {
+                constexpr Direction i = PAIRS.first[P], j = PAIRS.second[P];
+                static_assert(EQMWEIGHTS[i] == EQMWEIGHTS[j]);
+                constexpr distribn_t w = EQMWEIGHTS[i];
+                const T mom_dot_ei = DotDirection<i>(momentum_x, momentum_y, momentum_z);
+                const T even = w * (a + b * mom_dot_ei * mom_dot_ei);
+                const T odd = (3. * w) * mom_dot_ei;
+                f_eq[i] = even + odd;
+                f_eq[j] = even - odd;
+            }(), ...);
+        }
 
-          }
+    public:
+        /**
+         * Calculates density and momentum with the loop over directions
+         * unrolled at compile time: opposite directions are taken in
+         * pairs and zero velocity components are left out, so there are
+         * no multiplications. T is distribn_t or a SIMD vector with one
+         * lane per site.
+         */
+        template <typename F, typename T>
+        inline static void CalculateDensityAndMomentumUnrolled(const F& f, T& density,
+                                                               T& momentum_x, T& momentum_y, T& momentum_z)
+        {
+            UnrolledDensityAndMomentum(f, density, momentum_x, momentum_y, momentum_z,
+                                       std::make_index_sequence<Q / 2>{});
+        }
+
+        /**
+         * Calculates the equilibrium with the loop over directions
+         * unrolled at compile time: the terms even in the velocity are
+         * computed once for each pair of opposite directions and zero
+         * velocity components are left out. T is distribn_t or a SIMD
+         * vector with one lane per site.
+         */
+        template <typename T, typename F>
+        inline static void CalculateFeqUnrolled(const T& density, const T& momentum_x, const T& momentum_y,
+                                                const T& momentum_z, F& f_eq)
+        {
+            UnrolledFeq(density, momentum_x, momentum_y, momentum_z, f_eq,
+                        std::make_index_sequence<Q / 2>{});
+        }
 
-#else
         inline static void CalculateDensityAndMomentum(const_span f,
                                                        distribn_t &density,
                                                        LatticeMomentum& momentum) {
-            density = 0.0;
-            momentum = {0.0, 0.0, 0.0};
-            for (Direction i = 0; i < NUMVECTORS; ++i)
-            {
-              density += f[i];
-              momentum += VECTORS[i] * f[i];
-            }
+            CalculateDensityAndMomentumUnrolled(f, density, momentum.x(), momentum.y(), momentum.z());
         }
 
-#endif                   
-
           /**
            * Calculates density and momentum, including Guo forcing
            * @param f
@@ -218,142 +289,14 @@ namespace hemelb::lb
             CalculateFeq(density, momentum.x(), momentum.y(), momentum.z(), f_eq);
         }
 
-#ifdef HEMELB_USE_SSE3
-        /**
-           * Calculates Feq using SSE3 intrinsics.
-           * If the lattice has an odd number of vectors (directions), 
-           * the last element is processed using scalar arithmetics
-           * 
-           * The reductions are calculated in two streams (the loop is virtually 
-           * twice unrolled). Some invariants are merged together
-           * 
-           * @param density
-           * @param momentum_x
-           * @param momentum_y
-           * @param momentum_z
-           * @param f_eq
-           */
-        static void CalculateFeq(const distribn_t &density,
-                                 const distribn_t &momentum_x,
-                                 const distribn_t &momentum_y,
-                                 const distribn_t &momentum_z,
-                                 mut_span f_eq)
+        inline static void CalculateFeq(const distribn_t &density,
+                                        const distribn_t &momentum_x,
+                                        const distribn_t &momentum_y,
+                                        const distribn_t &momentum_z,
+                                        mut_span f_eq)
         {
-            // f_eq[i] = EQMWEIGHTS[i]
-            //            * (density - (3. / 2.) * momentumMagnitudeSquared/ DENSITY // Note this line invariant over i loop
-            //               + (9. / 2. * DENSITY) * mom_dot_ei * mom_dot_ei + 3. * mom_dot_ei);
-            // Where DENSITY = (constexpr COMPRESSIBLE) ? density : 1
-
-            // merge some constants and invariants and populate SSE registers by them
-            // want f_eq[i] = weight[i] * (tmp1 + tmp2 + tmp3)
-            const distribn_t threeHalvesOfMomentumMagnitudeSquared = (3./2.) * (momentum_x * momentum_x + momentum_y * momentum_y
-                + momentum_z * momentum_z);
-            distribn_t tmp1_scalar;
-            if constexpr (COMPRESSIBLE)
-                tmp1_scalar = density - threeHalvesOfMomentumMagnitudeSquared / density;
-            else
-                tmp1_scalar = density - threeHalvesOfMomentumMagnitudeSquared;
-
-            //const __m128d threeHalvesOfMomentumMagnitudeSquared_SSE2 = _mm_set1_pd(tmp0);
-
-            const distribn_t density_1 = 1. / density;
-
-            const __m128d momentum_x_SSE2 = _mm_set1_pd(momentum_x);
-            const __m128d momentum_y_SSE2 = _mm_set1_pd(momentum_y);
-            const __m128d momentum_z_SSE2 = _mm_set1_pd(momentum_z);
-
-            distribn_t nineHalvesOfDensity_1 = (9. / 2.);
-            if constexpr (COMPRESSIBLE)
-                nineHalvesOfDensity_1 *= density_1;
-            const __m128d nineOnTwoDensity_1_SSE2 = _mm_set1_pd(nineHalvesOfDensity_1);
-            const __m128d three_SSE2 = _mm_set1_pd(3.);
-
-            // sse loop (the loop is virtually twice unrolled)
-            Direction numVect2 = ((NUMVECTORS >> 1) << 1);
-            for (Direction i = 0; i < numVect2; i+=2)
-            {
-              // mom_dot_ei = CX[i] * momentum_x + CY[i] * momentum_y + CZ[i] * momentum_z;
-              const __m128d CXD_momentum_x_SSE2 = _mm_mul_pd(_mm_load_pd(&CXD[i]), momentum_x_SSE2);
-              const __m128d CYD_momentum_y_SSE2 = _mm_mul_pd(_mm_load_pd(&CYD[i]), momentum_y_SSE2);
-              const __m128d CZD_momentum_z_SSE2 = _mm_mul_pd(_mm_load_pd(&CZD[i]), momentum_z_SSE2);
-
-              const __m128d EQMWEIGHTS_SSE2 = _mm_load_pd(&EQMWEIGHTS[i]);
-
-              const __m128d mom_dot_ei_SSE2 = _mm_add_pd(
-                  _mm_add_pd(CXD_momentum_x_SSE2, CYD_momentum_y_SSE2),
-                  CZD_momentum_z_SSE2
-              );
-
-              //  (density - (3. / 2.) * momentumMagnitudeSquared * density_1
-              const __m128d tmp1 = _mm_set1_pd(tmp1_scalar);
-
-              // (9. / 2.) * density_1 * mom_dot_ei * mom_dot_ei
-              const __m128d tmp2 = (_mm_mul_pd(
-                      nineOnTwoDensity_1_SSE2,
-                      _mm_mul_pd(mom_dot_ei_SSE2, mom_dot_ei_SSE2)
-                  )
-              );
-              // 3. * mom_dot_ei);
-              const __m128d tmp3 = _mm_mul_pd(three_SSE2, mom_dot_ei_SSE2);
-
-              __m128d tmp4 = _mm_add_pd(tmp1, tmp2);
-              tmp4 = _mm_add_pd(tmp4, tmp3);
-
-              // f_eq is not 16B aligned
-              _mm_storeu_pd(&f_eq[i], _mm_mul_pd(EQMWEIGHTS_SSE2,tmp4));
-            }
-
-            // do the odd element (15/19/27) 
-            if (NUMVECTORS != numVect2)// constants are reduced
-            {
-                constexpr auto i = NUMVECTORS - 1;
-
-                const distribn_t mom_dot_ei = CXD[i] * momentum_x
-                                              + CYD[i] * momentum_y
-                                              + CZD[i] * momentum_z;
-
-                f_eq[i] = EQMWEIGHTS[i]
-                          * (tmp1_scalar
-                             + nineHalvesOfDensity_1 * (mom_dot_ei * mom_dot_ei)
-                             + 3. * mom_dot_ei);
-
-            }
+            CalculateFeqUnrolled(density, momentum_x, momentum_y, momentum_z, f_eq);
         }
-#else
-
-          /**
-           * Calculate Feq, the orginal version
-           * @param density
-           * @param momentum_x
-           * @param momentum_y
-           * @param momentum_z
-           * @param f_eq
-           */
-          inline static void CalculateFeq(const distribn_t &density, const distribn_t &momentum_x,
-                                          const distribn_t &momentum_y,
-                                          const distribn_t &momentum_z, mut_span f_eq)
-          {
-            const distribn_t density_1 = 1. / density;
-            const distribn_t momentumMagnitudeSquared = momentum_x * momentum_x
-                + momentum_y * momentum_y + momentum_z * momentum_z;
-
-            for (Direction i = 0; i < NUMVECTORS; ++i)
-            {
-              const distribn_t mom_dot_ei = CX[i] * momentum_x + CY[i] * momentum_y
-                  + CZ[i] * momentum_z;
-
-              if constexpr (COMPRESSIBLE) {
-                  f_eq[i] = EQMWEIGHTS[i]
-                            * (density - (3. / 2.) * momentumMagnitudeSquared * density_1
-                               + (9. / 2.) * density_1 * mom_dot_ei * mom_dot_ei + 3. * mom_dot_ei);
-              } else {
-                  f_eq[i] = EQMWEIGHTS[i]
-                            * (density - (3. / 2.) * momentumMagnitudeSquared
-                               + (9. / 2.) * mom_dot_ei * mom_dot_ei + 3. * mom_dot_ei);
-              }
-            }
-          }
-#endif
 
 #ifdef HEMELB_USE_SSE3
 
@@ -464,6 +407,21 @@ namespace hemelb::lb
         }
 #endif
 
+          /**
+           * Calculate density, momentum and f_eq for several sites at
+           * once. T is a SIMD vector type (or plain distribn_t) with one
+           * lane per site; the arithmetic is the same as the scalar
+           * CalculateDensityAndMomentum and CalculateFeq.
+           */
+          template <typename T>
+          inline static void BatchCalculateDensityMomentumFEq(const std::array<T, Q>& f, T& density,
+                                                              T& momentum_x, T& momentum_y, T& momentum_z,
+                                                              std::array<T, Q>& f_eq)
+          {
+            CalculateDensityAndMomentumUnrolled(f, density, momentum_x, momentum_y, momentum_z);
+            CalculateFeqUnrolled(density, momentum_x, momentum_y, momentum_z, f_eq);
+          }
+
           // Calculate density, momentum and the equilibrium distribution
           // functions according to the D3Q15 model.  The calculated momentum_x, momentum_y
           // and momentum_z are actually density * velocity, because we are using the
@@ -13,6 +13,7 @@
 #include "lb/InitialCondition.h"
 #include "lb/iolets/BoundaryValues.h"
 #include "lb/MacroscopicPropertyCache.h"
+#include "util/Threading.h"
 #include "util/UnitConverter.h"
 #include "reporting/Timers.h"
 #include "Traits.h"
@@ -106,24 +107,31 @@ namespace hemelb::lb
         std::unique_ptr<tInletWallCollision> mInletWallCollision;
         std::unique_ptr<tOutletWallCollision> mOutletWallCollision;
 
-        void StreamAndCollide(streamer auto& s, const site_t iFirstIndex,
+        // Streamers that allow it have their sites split between the
+        // threads of this process (see util::ForEachChunk).
+        template <streamer S>
+        void StreamAndCollide(S& s, const site_t iFirstIndex,
                               const site_t iSiteCount)
         {
-            s.StreamAndCollide(iFirstIndex,
-                                                 iSiteCount,
-                                                 &mParams,
-                                                 *mLatDat,
-                                                 propertyCache);
+            auto doChunk = [&](site_t first, site_t count) {
+                s.StreamAndCollide(first, count, &mParams, *mLatDat, propertyCache);
+            };
+            if constexpr (threadable_streamer<S>)
+                util::ForEachChunk(iFirstIndex, iSiteCount, doChunk);
+            else
+                doChunk(iFirstIndex, iSiteCount);
         }
 
-        void PostStep(streamer auto& s, const site_t iFirstIndex, const site_t iSiteCount)
+        template <streamer S>
+        void PostStep(S& s, const site_t iFirstIndex, const site_t iSiteCount)
         {
-            s.PostStep(iFirstIndex,
-                                           iSiteCount,
-                                           &mParams,
-                                           *mLatDat,
-                                           propertyCache);
-
+            auto doChunk = [&](site_t first, site_t count) {
+                s.PostStep(first, count, &mParams, *mLatDat, propertyCache);
+            };
+            if constexpr (threadable_streamer<S>)
+                util::ForEachChunk(iFirstIndex, iSiteCount, doChunk);
+            else
+                doChunk(iFirstIndex, iSiteCount);
         }
 
         net::Net* mNet;
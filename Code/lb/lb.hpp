@@ -6,6 +6,7 @@
 #ifndef HEMELB_LB_LB_HPP
 #define HEMELB_LB_LB_HPP
 
+#include "Exception.h"
 #include "lb/lb.h"
 #include "lb/InitialCondition.h"
 #include "lb/InitialCondition.hpp"
@@ -84,10 +85,27 @@ namespace hemelb::lb
       // It'd be nice to do this with something like
       // MidFluidCollision = new ConvergenceCheckingWrapper(new WhateverMidFluidCollision());
 
+      if (mLatDat->GetStreamingPattern() == geometry::StreamingPattern::AA
+          && !(aa_streamer<tMidFluidCollision> && aa_streamer<tWallCollision>
+               && aa_streamer<tInletCollision> && aa_streamer<tOutletCollision>
+               && aa_streamer<tInletWallCollision> && aa_streamer<tOutletWallCollision>))
+      {
+        throw Exception() << "The AA streaming pattern is not supported by the chosen boundary conditions";
+      }
+
+      if (!mLatDat->GetDomain().GetDistributionLayout().IsSiteContiguous()
+          && !(any_layout_streamer<tMidFluidCollision> && any_layout_streamer<tWallCollision>
+               && any_layout_streamer<tInletCollision> && any_layout_streamer<tOutletCollision>
+               && any_layout_streamer<tInletWallCollision> && any_layout_streamer<tOutletWallCollision>))
+      {
+        throw Exception() << "The chosen boundary conditions require the AoS distribution layout";
+      }
+
       auto initParams = InitParams();
       initParams.latDat = &mLatDat->GetDomain();
       initParams.lbmParams = &mParams;
       initParams.neighbouringDataManager = neighbouringDataManager;
+      initParams.timings = &timings;
 
       unsigned collId;
       InitInitParamsSiteRanges(initParams, collId);
@@ -207,6 +225,9 @@ namespace hemelb::lb
 
       StreamAndCollide(*mOutletWallCollision, offset, dom.GetDomainEdgeCollisionCount(5));
 
+      // The results for the neighbouring ranks are now complete.
+      mLatDat->PrepareSends();
+
       timings[hemelb::reporting::Timers::lb_calc].Stop();
       timings[hemelb::reporting::Timers::lb].Stop();
     }
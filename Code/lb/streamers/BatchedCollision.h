@@ -0,0 +1,165 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_LB_STREAMERS_BATCHEDCOLLISION_H
+#define HEMELB_LB_STREAMERS_BATCHEDCOLLISION_H
+
+#include <array>
+#include <concepts>
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#endif
+
+#include "build_info.h"
+#include "lb/collisions/Normal.h"
+#include "lb/streamers/Common.h"
+
+namespace hemelb::lb
+{
+#if __has_include(<experimental/simd>)
+    // The widest vector of distributions the target supports natively:
+    // 4 sites with AVX2, 8 with AVX-512.
+    using SiteBatch = std::experimental::native_simd<distribn_t>;
+    inline constexpr bool USE_BATCHED_COLLISION = build_info::USE_BATCHED_COLLISION;
+#else
+    // CMake turns the option off when the header is missing.
+    static_assert(!build_info::USE_BATCHED_COLLISION,
+                  "HEMELB_USE_BATCHED_COLLISION needs <experimental/simd>");
+    using SiteBatch = distribn_t;
+    inline constexpr bool USE_BATCHED_COLLISION = false;
+#endif
+
+    // Can the collision be applied to a batch of sites held in SIMD
+    // vectors? Only plain collisions with a kernel that opts in by
+    // defining `static constexpr bool supports_batch_collision = true`
+    // and providing CollideBatch. CollideBatch takes either just f,
+    // f_eq and the result or, for kernels needing more (such as the
+    // entropic ones and LBGKNN, which keep per-site state), also the
+    // index of the batch's first site, the density and the momentum
+    // components before those.
+    template <typename C>
+    concept batch_collision = collision_type<C>
+            && std::same_as<C, Normal<typename C::KernelType>>
+            && requires {
+                requires C::KernelType::supports_batch_collision;
+            };
+
+    /**
+     * Stream and collide sites [firstIndex, firstIndex + siteCount) of
+     * the bulk (i.e. with neither wall nor iolet links) in batches of
+     * V::size() sites, each held in the lanes of SIMD vectors of type
+     * V. The result is the same as BulkStreamer's site-by-site update,
+     * up to rounding. Only the density and velocity caches can be
+     * updated; the caller must not use this if any other needs
+     * refreshing.
+     *
+     * Returns the number of sites processed, which is the largest
+     * multiple of the batch size not more than siteCount; the caller
+     * must deal with the remainder.
+     */
+    template<StepKind STEP, typename V, batch_collision CollisionType>
+    site_t StreamAndCollideBatches(CollisionType& collider,
+                                   const site_t firstIndex, const site_t siteCount,
+                                   const LbmParameters* lbmParams,
+                                   geometry::FieldData& latDat,
+                                   lb::MacroscopicPropertyCache& propertyCache)
+    {
+        using LatticeType = typename CollisionType::LatticeType;
+        namespace stdx = std::experimental;
+        constexpr Direction Q = LatticeType::NUMVECTORS;
+        constexpr site_t W = V::size();
+
+        auto const& dom = latDat.GetDomain();
+        const bool cacheDensity = propertyCache.densityCache.RequiresRefresh();
+        const bool cacheVelocity = propertyCache.velocityCache.RequiresRefresh();
+
+        std::array<V, Q> f, f_eq, fPost;
+        alignas(stdx::memory_alignment_v<V>) distribn_t lanes[W];
+
+        const site_t batchedCount = siteCount / W * W;
+        for (site_t first = firstIndex; first < firstIndex + batchedCount; first += W)
+        {
+            // A site's own values are adjacent to the next site's in
+            // the same direction for the SoA layout and within the
+            // blocks of the AoSoA one; then whole vectors can be read
+            // and (on the even AA step) written at once.
+            const bool ownContiguous = STEP != StepKind::AAOdd
+                    && dom.GetDistributionIndex(first + W - 1, 0) == dom.GetDistributionIndex(first, 0) + W - 1;
+
+            for (Direction i = 0; i < Q; ++i)
+            {
+                if (ownContiguous)
+                {
+                    f[i].copy_from(latDat.GetFOld(dom.GetDistributionIndex(first, i)), stdx::element_aligned);
+                    continue;
+                }
+                for (site_t k = 0; k < W; ++k)
+                {
+                    auto const site = latDat.GetSite(first + k);
+                    if constexpr (STEP == StepKind::AAOdd)
+                        // Bulk sites have no wall or iolet links, so all
+                        // inputs are in the neighbours (as GatherAAOddStepInputs).
+                        lanes[k] = *latDat.GetFOld(site.template GetStreamedIndex<LatticeType>(LatticeType::INVERSEDIRECTIONS[i]));
+                    else
+                        lanes[k] = *latDat.GetFOld(site.GetDistributionIndex(i));
+                }
+                f[i].copy_from(lanes, stdx::vector_aligned);
+            }
+
+            V density, momentum_x, momentum_y, momentum_z;
+            LatticeType::BatchCalculateDensityMomentumFEq(f, density, momentum_x, momentum_y, momentum_z, f_eq);
+            if constexpr (requires {
+                collider.kernel.CollideBatch(lbmParams, first, density, momentum_x, momentum_y, momentum_z,
+                                             f, f_eq, fPost);
+            })
+                collider.kernel.CollideBatch(lbmParams, first, density, momentum_x, momentum_y, momentum_z,
+                                             f, f_eq, fPost);
+            else
+                collider.kernel.CollideBatch(lbmParams, f, f_eq, fPost);
+
+            for (Direction i = 0; i < Q; ++i)
+            {
+                if constexpr (STEP == StepKind::AAEven)
+                {
+                    // Leave the value at this site, in the slot of the reversed direction.
+                    const Direction inv = LatticeType::INVERSEDIRECTIONS[i];
+                    if (ownContiguous)
+                    {
+                        fPost[i].copy_to(latDat.GetFNew(dom.GetDistributionIndex(first, inv)), stdx::element_aligned);
+                        continue;
+                    }
+                    fPost[i].copy_to(lanes, stdx::vector_aligned);
+                    for (site_t k = 0; k < W; ++k)
+                        *latDat.GetFNew(dom.GetDistributionIndex(first + k, inv)) = lanes[k];
+                }
+                else
+                {
+                    fPost[i].copy_to(lanes, stdx::vector_aligned);
+                    for (site_t k = 0; k < W; ++k)
+                        *latDat.GetFNew(latDat.GetSite(first + k).template GetStreamedIndex<LatticeType>(i)) = lanes[k];
+                }
+            }
+
+            if (cacheDensity || cacheVelocity)
+            {
+                for (site_t k = 0; k < W; ++k)
+                {
+                    if (cacheDensity)
+                        propertyCache.densityCache.Put(first + k, density[k]);
+                    if (cacheVelocity)
+                    {
+                        LatticeVelocity velocity(momentum_x[k], momentum_y[k], momentum_z[k]);
+                        if constexpr (LatticeType::IsLatticeCompressible())
+                            velocity /= distribn_t(density[k]);
+                        propertyCache.velocityCache.Put(first + k, velocity);
+                    }
+                }
+            }
+        }
+        return batchedCount;
+    }
+}
+
+#endif
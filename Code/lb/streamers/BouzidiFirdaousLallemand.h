@@ -7,6 +7,7 @@
 #define HEMELB_LB_STREAMERS_BOUZIDIFIRDAOUSLALLEMAND_H
 
 #include "lb/concepts.h"
+#include "lb/streamers/LinkLists.h"
 #include "lb/streamers/SimpleBounceBack.h"
 
 namespace hemelb::lb
@@ -20,6 +21,10 @@ namespace hemelb::lb
      *
      * Note that since the method requires data from neighbouring sites (in
      * some circumstances), it has a DoPostStep method.
+     *
+     * The branches and coefficients of each wall link are worked out
+     * once, when the streamer is given its site ranges, so that each
+     * step only has to gather and scatter.
      */
     template<collision_type C>
     class BouzidiFirdaousLallemandLink
@@ -28,66 +33,154 @@ namespace hemelb::lb
         using CollisionType = C;
         using VarsType = typename CollisionType::VarsType;
         using LatticeType = typename CollisionType::LatticeType;
+        static constexpr bool supports_any_layout = true;
+        static constexpr bool supports_threading = true;
+
+        /**
+         * What streaming one wall link does, worked out from the wall
+         * distance q. Eq (5b) for q >= 0.5 and simple bounce-back
+         * otherwise both write a weighted sum of the outgoing
+         * post-collision values to the opposite direction of this site:
+         *
+         * fNew[target] = fromDirection * fPost[direction] + fromInverse * fPost[inverse]
+         */
+        struct LinkRecord
+        {
+            site_t site;
+            site_t target;
+            distribn_t fromDirection;
+            distribn_t fromInverse;
+            Direction direction;
+            Direction inverse;
+        };
+
+        /**
+         * The post-step work of a link with a fluid site opposite and
+         * q < 0.5, Eq (5a):
+         *
+         * fNew[target] = keep * fNew[target] + fromSource * fNew[source]
+         */
+        struct PostStepRecord
+        {
+            site_t site;
+            site_t target;
+            site_t source;
+            distribn_t keep;
+            distribn_t fromSource;
+        };
+
     private:
-        BounceBackLink<CollisionType> bbDelegate;
+        PreparedLinks<LatticeType, LinkRecord> streamLinks;
+        PreparedLinks<LatticeType, PostStepRecord> postStepLinks;
 
     public:
         BouzidiFirdaousLallemandLink(CollisionType& delegatorCollider,
                                      InitParams& initParams) :
-                bbDelegate(delegatorCollider, initParams)
+                streamLinks(*initParams.latDat, initParams.siteRanges,
+                            [](auto const& site, Direction direction) {
+                                return std::optional{PrepareLink(site, direction)};
+                            }),
+                postStepLinks(*initParams.latDat, initParams.siteRanges,
+                              [](auto const& site, Direction direction) {
+                                  return PreparePostStepLink(site, direction);
+                              })
         {
         }
 
-        void StreamLink(const LbmParameters* lbmParams,
-                        geometry::FieldData& latticeData,
-                        const geometry::Site<geometry::FieldData>& site,
-                        VarsType& hydroVars,
-                        const Direction& direction)
+        template<class DataSource>
+        static LinkRecord PrepareLink(const geometry::Site<DataSource>& site, Direction direction)
         {
-            site_t invDirection = LatticeType::INVERSEDIRECTIONS[direction];
-            site_t bbDestination = (site.GetIndex() * LatticeType::NUMVECTORS) + invDirection;
-            distribn_t q = site.GetWallDistance<LatticeType>(direction);
+            Direction invDirection = LatticeType::INVERSEDIRECTIONS[direction];
+            distribn_t q = site.template GetWallDistance<LatticeType>(direction);
+            LinkRecord ans{site.GetIndex(), site.GetDistributionIndex(invDirection), 1.0, 0.0, direction, invDirection};
 
-            if (site.HasWall(invDirection) || q < 0.5)
-            {
-              // If there IS NO fluid site in the opposite direction, fall back to SBB.
-              // If there IS such a site, we have to wait for the site in the opposite
-              // direction to finish in order to complete this update. So just bounce-back
-              // the post collision f that we would have otherwise thrown away (to avoid
-              // having to collide twice).
-              bbDelegate.StreamLink(lbmParams, latticeData, site, hydroVars, direction);
-            }
-            else
+            // If there IS NO fluid site in the opposite direction, fall back to SBB.
+            // If there IS such a site but q < 0.5, we have to wait for the site in the
+            // opposite direction to finish in order to complete this update. So just
+            // bounce-back the post collision f that we would have otherwise thrown away
+            // (to avoid having to collide twice).
+            if (!site.HasWall(invDirection) && q >= 0.5)
             {
               // We have a fluid site and have all the data needed to complete this direction!
               // Implement Eq (5b) from Bouzidi et al.
-              * (latticeData.GetFNew(bbDestination)) = (hydroVars.GetFPostCollision()[direction]
-                  + (2.0 * q - 1) * hydroVars.GetFPostCollision()[invDirection]) / (2.0 * q);
+              ans.fromDirection = 1.0 / (2.0 * q);
+              ans.fromInverse = (2.0 * q - 1.0) / (2.0 * q);
             }
+            return ans;
+        }
+
+        template<class DataSource>
+        static std::optional<PostStepRecord> PreparePostStepLink(const geometry::Site<DataSource>& site,
+                                                                 Direction direction)
+        {
+            Direction invDirection = LatticeType::INVERSEDIRECTIONS[direction];
+            distribn_t q = site.template GetWallDistance<LatticeType>(direction);
+            // If there is no fluid site in the opposite direction, fall back to simple
+            // bounce back, which has been done when streaming.
+            // If q >= 0.5, then we handled that fully then also.
+            if (site.HasWall(invDirection) || q >= 0.5)
+              return std::nullopt;
 
+            // Note that:
+            // - fNew[direction] is the newly-arrived fPostColl[direction] from the neighbouring site
+            // - fNew[invDirection] is the bounced-back fPostColl[direction] for this site.
+            return PostStepRecord{site.GetIndex(),
+                                  site.GetDistributionIndex(invDirection),
+                                  site.GetDistributionIndex(direction),
+                                  2.0 * q,
+                                  1.0 - 2.0 * q};
+        }
+
+        bool FindLinks(const geometry::Domain& dom, site_t first, site_t count,
+                       std::span<const LinkRecord>& links) const
+        {
+            return streamLinks.Find(dom, first, count, links);
+        }
+
+        void StreamLink(const LbmParameters* lbmParams,
+                        geometry::FieldData& latticeData,
+                        const geometry::Site<geometry::FieldData>& site,
+                        VarsType& hydroVars,
+                        const Direction& direction)
+        {
+            StreamLink(lbmParams, latticeData, site, hydroVars, PrepareLink(site, direction));
+        }
+
+        void StreamLink(const LbmParameters*,
+                        geometry::FieldData& latticeData,
+                        const geometry::Site<geometry::FieldData>&,
+                        VarsType& hydroVars,
+                        const LinkRecord& link)
+        {
+            auto const& fPost = hydroVars.GetFPostCollision();
+            *latticeData.GetFNew(link.target) = link.fromDirection * fPost[link.direction]
+                + link.fromInverse * fPost[link.inverse];
         }
 
         void PostStepLink(geometry::FieldData& latticeData,
                           const geometry::Site<geometry::FieldData>& site,
                           const Direction& direction)
         {
-            distribn_t* fNew = latticeData.GetFNew(site.GetIndex() * LatticeType::NUMVECTORS);
-            site_t invDirection = LatticeType::INVERSEDIRECTIONS[direction];
-            distribn_t q = site.GetWallDistance<LatticeType>(direction);
-            // If there is no fluid site in the opposite direction, fall back to simple
-            // bounce back, which has been done above.
+            if (auto link = PreparePostStepLink(site, direction))
+              PostStepLink(latticeData, *link);
+        }
 
-            // If q >= 0.5, then we handled that fully above also.
-            if (!site.HasWall(invDirection) && q < 0.5)
-            {
-              // So, we have a fluid site and all the data needed to complete this direction!
-              // Implement Eq (5a) from Bouzidi et al.
+        bool PostStepLinks(geometry::FieldData& latticeData, site_t first, site_t count)
+        {
+            std::span<const PostStepRecord> links;
+            if (!postStepLinks.Find(latticeData.GetDomain(), first, count, links))
+              return false;
+            for (auto const& link: links)
+              PostStepLink(latticeData, link);
+            return true;
+        }
 
-              // Note that:
-              // - fNew[direction] is the newly-arrived fPostColl[direction] from the neighbouring site
-              // - fNew[invDirection] is the above-bounced-back fPostColl[direction] for this site.
-              fNew[invDirection] = 2.0 * q * fNew[invDirection] + (1.0 - 2.0 * q) * fNew[direction];
-            }
+    private:
+        static void PostStepLink(geometry::FieldData& latticeData, const PostStepRecord& link)
+        {
+            // Implement Eq (5a) from Bouzidi et al.
+            distribn_storage_t& fNewInv = *latticeData.GetFNew(link.target);
+            fNewInv = link.keep * fNewInv + link.fromSource * *latticeData.GetFNew(link.source);
         }
     };
 }
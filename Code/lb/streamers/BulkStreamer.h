@@ -7,6 +7,7 @@
 #define HEMELB_LB_STREAMERS_BULKSTREAMER_H
 
 #include "geometry/FieldData.h"
+#include "lb/streamers/BatchedCollision.h"
 #include "lb/streamers/Common.h"
 #include "lb/HFunction.h"
 
@@ -22,6 +23,9 @@ namespace hemelb::lb
         using KernelType = typename CollisionType::KernelType;
         using VarsType = typename CollisionType::VarsType;
         using LatticeType = typename KernelType::LatticeType;
+        static constexpr bool supports_aa_pattern = true;
+        static constexpr bool supports_any_layout = true;
+        static constexpr bool supports_threading = true;
 
         BulkLink(CollisionType& delegatorCollider,
                  InitParams& initParams)
@@ -38,6 +42,17 @@ namespace hemelb::lb
                     hydroVars.GetFPostCollision()[direction];
         }
 
+        /// The even step of the AA pattern: leave the value at this
+        /// site, in the slot of the reversed direction.
+        void StreamLinkInPlace(geometry::FieldData& latticeData,
+                               const geometry::Site<geometry::FieldData>& site,
+                               VarsType& hydroVars,
+                               const Direction& direction)
+        {
+            * (latticeData.GetFNew(site.GetDistributionIndex(LatticeType::INVERSEDIRECTIONS[direction]))) =
+                    hydroVars.GetFPostCollision()[direction];
+        }
+
         void PostStepLink(geometry::FieldData& latticeData,
                           const geometry::Site<geometry::FieldData>& site,
                           const Direction& direction) {
@@ -59,6 +74,10 @@ namespace hemelb::lb
         static_assert(link_streamer<BulkLink<CollisionType>>);
 
     public:
+        static constexpr bool supports_aa_pattern = true;
+        static constexpr bool supports_any_layout = true;
+        static constexpr bool supports_threading = true;
+
         BulkStreamer(InitParams& initParams) :
                 collider(initParams), bulkLinkDelegate(collider, initParams)
         {
@@ -69,10 +88,64 @@ namespace hemelb::lb
                               geometry::FieldData& latDat,
                               lb::MacroscopicPropertyCache& propertyCache)
         {
+            switch (GetStepKind(latDat))
+            {
+                case StepKind::AB:
+                    DoStreamAndCollide<StepKind::AB>(firstIndex, siteCount, lbmParams, latDat, propertyCache);
+                    break;
+                case StepKind::AAEven:
+                    DoStreamAndCollide<StepKind::AAEven>(firstIndex, siteCount, lbmParams, latDat, propertyCache);
+                    break;
+                case StepKind::AAOdd:
+                    DoStreamAndCollide<StepKind::AAOdd>(firstIndex, siteCount, lbmParams, latDat, propertyCache);
+                    break;
+            }
+            FinishKernelRange(collider);
+        }
+
+        void PostStep(const site_t iFirstIndex, const site_t iSiteCount,
+                      const LbmParameters* iLbmParams, geometry::FieldData& bLatDat,
+                      lb::MacroscopicPropertyCache& propertyCache)
+        {
+        }
+
+    private:
+        template<StepKind STEP>
+        void DoStreamAndCollide(site_t firstIndex, site_t siteCount,
+                                const LbmParameters* lbmParams,
+                                geometry::FieldData& latDat,
+                                lb::MacroscopicPropertyCache& propertyCache)
+        {
+            if constexpr (USE_BATCHED_COLLISION && batch_collision<CollisionType>)
+            {
+                // Collide what we can in SIMD batches, leaving the
+                // remainder (and any step that needs the stress etc.)
+                // to the loop below.
+                if (!propertyCache.RequiresNonEquilibriumRefresh())
+                {
+                    auto const done = StreamAndCollideBatches<STEP, SiteBatch>(collider, firstIndex, siteCount,
+                                                                               lbmParams, latDat, propertyCache);
+                    firstIndex += done;
+                    siteCount -= done;
+                }
+            }
+
+            FVector<LatticeType> gathered;
+            // Except on odd AA steps a site collides its own values,
+            // which must be copied out unless the layout keeps them together.
+            const bool gatherOwn = !latDat.GetDomain().GetDistributionLayout().IsSiteContiguous();
             for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
             {
                 geometry::Site<geometry::FieldData> site = latDat.GetSite(siteIndex);
-                VarsType hydroVars(site);
+                typename LatticeType::const_span f = gathered;
+                if constexpr (STEP == StepKind::AAOdd)
+                    // Bulk sites have no wall or iolet links to check.
+                    GatherAAOddStepInputs<LatticeType, false>(latDat, site, gathered);
+                else if (gatherOwn)
+                    site.GatherFOld<LatticeType>(gathered);
+                else
+                    f = site.ReadFOld<LatticeType>(gathered);
+                VarsType hydroVars(site, f);
 
                 ///< @todo #126 This value of tau will be updated by some kernels within the collider code (e.g. LBGKNN). It would be nicer if tau is handled in a single place.
                 hydroVars.tau = lbmParams->GetTau();
@@ -83,19 +156,19 @@ namespace hemelb::lb
 
                 for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ii++)
                 {
-                    bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
+                    if constexpr (STEP == StepKind::AAEven)
+                    {
+                        bulkLinkDelegate.StreamLinkInPlace(latDat, site, hydroVars, ii);
+                    }
+                    else
+                    {
+                        bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
+                    }
                 }
 
                 UpdateCachePostCollision(site, hydroVars, lbmParams, propertyCache);
             }
         }
-
-        void PostStep(const site_t iFirstIndex, const site_t iSiteCount,
-                      const LbmParameters* iLbmParams, geometry::FieldData& bLatDat,
-                      lb::MacroscopicPropertyCache& propertyCache)
-        {
-        }
-
     };
 }
 #endif
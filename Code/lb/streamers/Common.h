@@ -9,6 +9,7 @@
 #include <cmath>
 
 #include "geometry/Domain.h"
+#include "geometry/FieldData.h"
 #include "lb/concepts.h"
 #include "lb/HydroVars.h"
 #include "lb/LbmParameters.h"
@@ -129,6 +130,63 @@ namespace hemelb::lb
             }
           }
 
+    /// Which variant of the site update a step needs, given the
+    /// streaming pattern (see geometry::StreamingPattern).
+    enum class StepKind
+    {
+        AB, //!< Read from fOld, stream to neighbours in fNew
+        AAEven, //!< Read own slots, write back to own reversed slots
+        AAOdd //!< Read from neighbours' reversed slots, stream to neighbours
+    };
+
+    inline StepKind GetStepKind(geometry::FieldData const& latDat)
+    {
+        if (latDat.GetStreamingPattern() == geometry::StreamingPattern::AB)
+            return StepKind::AB;
+        return latDat.IsOddStep() ? StepKind::AAOdd : StepKind::AAEven;
+    }
+
+    /**
+     * On the odd step of the AA pattern, the populations arriving at a
+     * site are where the even step left them: in the upstream
+     * neighbour, in the slot of the reversed direction, or (for links
+     * that were bounced back by a wall or iolet) in this site's own
+     * slot. Gather them into a contiguous vector.
+     *
+     * Set CHECK_LINKS to false for sites known to have neither wall nor
+     * iolet links.
+     */
+    template<lattice_type LatticeType, bool CHECK_LINKS>
+    void GatherAAOddStepInputs(const geometry::FieldData& latDat,
+                               const geometry::Site<geometry::FieldData>& site,
+                               FVector<LatticeType>& f)
+    {
+        for (Direction ii = 0; ii < LatticeType::NUMVECTORS; ii++)
+        {
+            const Direction inv = LatticeType::INVERSEDIRECTIONS[ii];
+            if (CHECK_LINKS && (site.HasIolet(inv) || site.HasWall(inv)))
+            {
+                f[ii] = *latDat.GetFOld(site.GetDistributionIndex(ii));
+            }
+            else
+            {
+                f[ii] = *latDat.GetFOld(site.GetStreamedIndex<LatticeType>(inv));
+            }
+        }
+    }
+
+    /**
+     * Tell the collision's kernel that StreamAndCollide has finished a
+     * range of sites, for kernels that tally something per site and
+     * publish it once per range (e.g. EntropicBase::FinishRange).
+     */
+    template<typename CollisionType>
+    void FinishKernelRange(CollisionType& collider)
+    {
+        if constexpr (requires { collider.kernel.FinishRange(); })
+            collider.kernel.FinishRange();
+    }
+
     /**
      * Null implementation of an iolet link delegate.
      */
@@ -138,6 +196,9 @@ namespace hemelb::lb
         using CollisionType = C;
         using VarsType = typename CollisionType::VarsType;
         using LatticeType = typename CollisionType::LatticeType;
+        static constexpr bool supports_aa_pattern = true;
+        static constexpr bool supports_any_layout = true;
+        static constexpr bool supports_threading = true;
         NullLink(CollisionType& collider, InitParams& initParams)
         {
         }
@@ -8,6 +8,7 @@
 
 #include "lb/iolets/BoundaryValues.h"
 #include "lb/iolets/InOutLetVelocity.h"
+#include "lb/streamers/LinkLists.h"
 #include "geometry/neighbouring/RequiredSiteInformation.h"
 #include "geometry/neighbouring/NeighbouringDataManager.h"
 #include "util/Vector3D.h"
@@ -19,6 +20,10 @@ namespace hemelb::lb
      * This class implements the boundary condition described by Guo, Zheng and Shi
      * in 'An Extrapolation Method for Boundary Conditions in Lattice-Boltzmann method'
      * Physics of Fluids, 14/6, June 2002, pp 2007-2010.
+     *
+     * Which branch of the method each wall link takes, and where it
+     * finds the next site out, is decided once when the streamer is
+     * given its site ranges (see PrepareLink).
      */
     template<collision_type C>
     class GuoZhengShiLink
@@ -31,7 +36,11 @@ namespace hemelb::lb
         GuoZhengShiLink(CollisionType& delegatorCollider, InitParams& initParams) :
                 collider(delegatorCollider),
                 neighbouringLatticeData(initParams.latDat->GetNeighbouringData()),
-                bValues(initParams.boundaryObject), bbDelegate(delegatorCollider, initParams)
+                bValues(initParams.boundaryObject),
+                links(*initParams.latDat, initParams.siteRanges,
+                      [this, &initParams](auto const& site, Direction direction) {
+                          return std::optional{PrepareLink(*initParams.latDat, site, direction)};
+                      })
         {
             // Want to loop over each site this streamer is responsible for,
             // as specified in the siteRanges.
@@ -103,6 +112,52 @@ namespace hemelb::lb
             }
         }
 
+        /// How a link is to be treated, decided by PrepareLink.
+        enum class LinkKind : std::uint8_t
+        {
+            // wallDistance >= 0.75: GZS1, using this site alone.
+            Extrapolate,
+            // A wall or a non-velocity iolet blocks the next site out: SBB.
+            BounceBack,
+            // GZS2, also extrapolating from the next site out.
+            NextSite,
+            // Modified GZS2, using the velocity imposed by the iolet next to this site.
+            VelocityIolet
+        };
+
+        /**
+         * Everything about a link that doesn't change from step to
+         * step: its branch, the interpolation coefficients and where to
+         * find the next site out.
+         */
+        struct LinkRecord
+        {
+            site_t site;
+            // Where the result goes, in f_new.
+            site_t target;
+            distribn_t wallDistance;
+            // The first estimate of the velocity at the wall is this times this site's.
+            distribn_t firstEstimate;
+            // The second is this times the next site's.
+            distribn_t secondEstimate;
+            // For NextSite, the contiguous index of the next site if it is
+            // on this rank, otherwise its global non-contiguous ID.
+            site_t nextSite;
+            bool nextSiteIsLocal;
+            // For VelocityIolet.
+            InOutLetVelocity* iolet;
+            LatticePosition nextSitePosition;
+            Direction unstreamed;
+            Direction streamed;
+            LinkKind kind;
+        };
+
+        bool FindLinks(const geometry::Domain& dom, site_t first, site_t count,
+                       std::span<const LinkRecord>& ans) const
+        {
+            return links.Find(dom, first, count, ans);
+        }
+
         /*
          * The outline of this method is as follows:
          *
@@ -120,144 +175,177 @@ namespace hemelb::lb
          * else
          *   Do GZS1
          */
+        template<class DataSource>
+        LinkRecord PrepareLink(const geometry::Domain& domain,
+                               const geometry::Site<DataSource>& site,
+                               const Direction& iPrime) const
+        {
+            Direction i = LatticeType::INVERSEDIRECTIONS[iPrime];
+            // Get the distance to the boundary.
+            double wallDistance = site.template GetWallDistance<LatticeType>(iPrime);
+
+            LinkRecord ans{};
+            ans.site = site.GetIndex();
+            ans.target = site.GetDistributionIndex(i);
+            ans.wallDistance = wallDistance;
+            // Assume that the wall velocity (0) is linearly interpolated along the line
+            // between the nearest fluid site and the solid site inside the wall.
+            // Then 0 = velocityWall * wallDistance + velocityFluid * (1 - wallDistance)
+            // Hence velocityWall = velocityFluid * (1 - 1/wallDistance)
+            ans.firstEstimate = 1. - 1. / wallDistance;
+            // Ignoring the fluid site closest to the wall and interpolating the next
+            // site away and the site within the wall to the point on the wall itself:
+            // 0 = velocityWall * (1 + wallDistance) / 2 + velocityNextFluid * (1 - wallDistance)/2
+            // Rearranging gives velocityWall = velocityNextFluid * (wallDistance - 1)/(wallDistance+1)
+            ans.secondEstimate = (wallDistance - 1.) / (wallDistance + 1.);
+            ans.unstreamed = iPrime;
+            ans.streamed = i;
+            ans.kind = LinkKind::Extrapolate;
+
+            // The authors suggest simply using the wall velocity when there's a large distance
+            // between the fluid site and wall (> 0.75 lattice vector).
+            if (wallDistance >= 0.75)
+              return ans;
+
+            // When this can't be done (i.e. when there's a wall/iolet in the way), fall back to SBB
+            if (site.HasIolet(i))
+            {
+              ans.iolet = bValues == nullptr
+                  ? nullptr
+                  : dynamic_cast<InOutLetVelocity*>(bValues->GetLocalIolet(site.GetIoletId()));
+              if (ans.iolet == nullptr)
+              {
+                ans.kind = LinkKind::BounceBack;
+              }
+              else
+              {
+                // Modified GZS - there is a velocity iolet blocking the neighbouring
+                // site who's data we would use for the second extrapolation.
+                // Use the imposed condition instead.
+                ans.kind = LinkKind::VelocityIolet;
+                ans.nextSitePosition = LatticePosition(site.GetGlobalSiteCoords());
+                ans.nextSitePosition += LatticeType::CD[i];
+              }
+            }
+            else if (site.HasWall(i))
+            {
+              ans.kind = LinkKind::BounceBack;
+            }
+            else
+            {
+              // There is a neighbour site to use for standard GZS to calculate u_w2.
+              ans.kind = LinkKind::NextSite;
+              LatticeVector nextSiteLocation = site.GetGlobalSiteCoords() + LatticeType::VECTORS[i];
+              ans.nextSiteIsLocal = domain.GetProcIdFromGlobalCoords(nextSiteLocation) == domain.GetLocalRank();
+              ans.nextSite = ans.nextSiteIsLocal
+                  ? domain.GetContiguousSiteId(nextSiteLocation)
+                  : domain.GetGlobalNoncontiguousSiteIdFromGlobalCoords(nextSiteLocation);
+            }
+            return ans;
+        }
+
         void StreamLink(const LbmParameters* lbmParams,
                         geometry::FieldData& latDat,
                         const geometry::Site<geometry::FieldData>& site,
                         VarsType& hydroVars,
                         const Direction& iPrime)
         {
-            Direction i = LatticeType::INVERSEDIRECTIONS[iPrime];
-            // Get the distance to the boundary.
-            double wallDistance = site.GetWallDistance<LatticeType>(iPrime);
+            StreamLink(lbmParams, latDat, site, hydroVars, PrepareLink(latDat.GetDomain(), site, iPrime));
+        }
+
+        void StreamLink(const LbmParameters* lbmParams,
+                        geometry::FieldData& latDat,
+                        const geometry::Site<geometry::FieldData>&,
+                        VarsType& hydroVars,
+                        const LinkRecord& link)
+        {
+            if (link.kind == LinkKind::BounceBack)
+            {
+              // Propagate the outgoing post-collisional f into the opposite direction.
+              *latDat.GetFNew(link.target) = hydroVars.GetFPostCollision()[link.unstreamed];
+              return;
+            }
 
             // Set up for GZS - do the extrapolation from this site - u_w1
 
             // Now we work out the hypothetical velocity of the solid site on the other side
             // of the wall.
-            // Assume that the wall velocity (0) is linearly interpolated along the line
-            // between the nearest fluid site and the solid site inside the wall.
-            // Then 0 = velocityWall * wallDistance + velocityFluid * (1 - wallDistance)
-            // Hence velocityWall = velocityFluid * (1 - 1/wallDistance)
             FVector<LatticeType> fWall;
             VarsType hydroVarsWall(fWall);
 
             hydroVarsWall.density = hydroVars.density;
             hydroVarsWall.tau = hydroVars.tau;
-            hydroVarsWall.momentum = hydroVars.momentum * (1. - 1. / wallDistance);
+            hydroVarsWall.momentum = hydroVars.momentum * link.firstEstimate;
 
             // Find the non-equilibrium distribution in the unstreamed direction.
             std::copy(hydroVars.GetFNeqPtr(),
                       hydroVars.GetFNeqPtr() + LatticeType::NUMVECTORS,
                       hydroVarsWall.GetFNeqPtr());
 
-            // The authors suggest simply using the wall velocity when there's a large distance
-            // between the fluid site and wall (> 0.75 lattice vector).
             // When there's a smaller distance, they recommend looking at the next fluid site out
             // and extrapolating from that to obtain another estimate. The wallDistance is then used
             // as an interpolation variable between the two estimates.
             // A similar thing is done with the non-equilibrium distribution estimate. It is either
             // the value in that direction at the nearest site, or an interpolation between the values
             // at the nearest site and the next site away.
-
-            // When this can't be done (i.e. when there's a wall/iolet in the way), fall back to SBB
-            if (wallDistance < 0.75)
+            const distribn_t wallDistance = link.wallDistance;
+            if (link.kind == LinkKind::VelocityIolet)
             {
-              if (site.HasIolet(i))
+              LatticeVelocity neighbourVelocity(link.iolet->GetVelocity(link.nextSitePosition,
+                                                                        bValues->GetTimeStep()));
+
+              // Obtain a second estimate, this time ignoring the fluid site closest to
+              // the wall.
+              LatticeVelocity velocityWallSecondEstimate = neighbourVelocity * link.secondEstimate;
+              // Next, we interpolate between the first and second estimates to improve the estimate.
+              // Extrapolate to obtain the velocity at the wall site.
+              for (int dimension = 0; dimension < 3; dimension++)
               {
-                int boundaryId = site.GetIoletId();
-                auto iolet = dynamic_cast<InOutLetVelocity*>(bValues->GetLocalIolet(boundaryId));
-                if (iolet == nullptr)
-                {
-                  // SBB
-                  return bbDelegate.StreamLink(lbmParams, latDat, site, hydroVars, iPrime);
-                }
-                else
-                {
-                  // Modified GZS - there is a velocity iolet blocking the neighbouring
-                  // site who's data we would use for the second extrapolation.
-                  // Use the imposed condition instead.
-                  LatticePosition sitePos(site.GetGlobalSiteCoords());
-
-                  LatticePosition neighPos(sitePos);
-                  neighPos += LatticeType::CD[i];
-
-                  LatticeVelocity neighbourVelocity(iolet->GetVelocity(neighPos,
-                                                                       bValues->GetTimeStep()));
-
-                  // Obtain a second estimate, this time ignoring the fluid site closest to
-                  // the wall. Interpolating the next site away and the site within the wall
-                  // to the point on the wall itself (velocity 0):
-                  // 0 = velocityWall * (1 + wallDistance) / 2 + velocityNextFluid * (1 - wallDistance)/2
-                  // Rearranging gives velocityWall = velocityNextFluid * (wallDistance - 1)/(wallDistance+1)
-                  LatticeVelocity velocityWallSecondEstimate = neighbourVelocity
-                      * (wallDistance - 1) / (wallDistance + 1);
-                  // Next, we interpolate between the first and second estimates to improve the estimate.
-                  // Extrapolate to obtain the velocity at the wall site.
-                  for (int dimension = 0; dimension < 3; dimension++)
-                  {
-                    hydroVarsWall.momentum[dimension] = wallDistance
-                        * hydroVarsWall.momentum[dimension]
-                        + (1. - wallDistance) * hydroVars.density
-                            * velocityWallSecondEstimate[dimension];
-                  }
-                  // Should interpolate in the same way to get f_neq - skip since not available
-                }
-              }
-              else
-              {
-                if (site.HasWall(i))
-                {
-                  // SBB
-                  return bbDelegate.StreamLink(lbmParams, latDat, site, hydroVars, iPrime);
-                }
-                else
-                {
-                  // There is a neighbour site to use for standard GZS to calculate u_w2.
-                  auto neighbourFOld = GetNeighbourFOld(site, i, latDat);
-                  // Now calculate this field information.
-                  LatticeVelocity neighbourVelocity;
-                  distribn_t neighbourFEq[LatticeType::NUMVECTORS];
-                  // Go ahead and calculate the density, momentum and eqm distribution.
-                  {
-                    distribn_t neighbourDensity;
-                    LatticeVelocity neighbourMomentum;
-                    // Note that nextNodeOutVelocity is passed as the momentum argument, this
-                    // is because it is immediately divided by density when the function returns.
-                    LatticeType::CalculateDensityMomentumFEq(neighbourFOld,
-                                                             neighbourDensity,
-                                                             neighbourMomentum,
-                                                             neighbourVelocity,
-                                                             neighbourFEq);
-                  }
-                  // Obtain a second estimate, this time ignoring the fluid site closest to
-                  // the wall. Interpolating the next site away and the site within the wall
-                  // to the point on the wall itself (velocity 0):
-                  // 0 = velocityWall * (1 + wallDistance) / 2 + velocityNextFluid * (1 - wallDistance)/2
-                  // Rearranging gives velocityWall = velocityNextFluid * (wallDistance - 1)/(wallDistance+1)
-                  LatticeVelocity velocityWallSecondEstimate = neighbourVelocity
-                      * (wallDistance - 1) / (wallDistance + 1);
-                  // Next, we interpolate between the first and second estimates to improve the estimate.
-                  // Extrapolate to obtain the velocity at the wall site.
-                  for (int dimension = 0; dimension < 3; dimension++)
-                  {
-                    hydroVarsWall.momentum[dimension] = wallDistance
-                        * hydroVarsWall.momentum[dimension]
-                        + (1. - wallDistance) * hydroVars.density
-                            * velocityWallSecondEstimate[dimension];
-                  }
-                  // Interpolate in the same way to get f_neq.
-                  distribn_t* fNeqWall = hydroVarsWall.GetFNeqPtr();
-                  for (unsigned j = 0; j < LatticeType::NUMVECTORS; ++j)
-                  {
-                    fNeqWall[j] = wallDistance * fNeqWall[j]
-                        + (1. - wallDistance) * (neighbourFOld[j] - neighbourFEq[j]);
-                  }
-                }
+                hydroVarsWall.momentum[dimension] = wallDistance
+                    * hydroVarsWall.momentum[dimension]
+                    + (1. - wallDistance) * hydroVars.density
+                        * velocityWallSecondEstimate[dimension];
               }
+              // Should interpolate in the same way to get f_neq - skip since not available
             }
-            else
+            else if (link.kind == LinkKind::NextSite)
             {
-              // We don't need any neighbours so this works any way.
+              FVector<LatticeType> neighbourFBuffer;
+              auto neighbourFOld = GetNeighbourFOld(link, latDat, neighbourFBuffer);
+              // Now calculate this field information.
+              LatticeVelocity neighbourVelocity;
+              distribn_t neighbourFEq[LatticeType::NUMVECTORS];
+              // Go ahead and calculate the density, momentum and eqm distribution.
+              {
+                distribn_t neighbourDensity;
+                LatticeVelocity neighbourMomentum;
+                // Note that nextNodeOutVelocity is passed as the momentum argument, this
+                // is because it is immediately divided by density when the function returns.
+                LatticeType::CalculateDensityMomentumFEq(neighbourFOld,
+                                                         neighbourDensity,
+                                                         neighbourMomentum,
+                                                         neighbourVelocity,
+                                                         neighbourFEq);
+              }
+              // Obtain a second estimate, this time ignoring the fluid site closest to
+              // the wall.
+              LatticeVelocity velocityWallSecondEstimate = neighbourVelocity * link.secondEstimate;
+              // Next, we interpolate between the first and second estimates to improve the estimate.
+              // Extrapolate to obtain the velocity at the wall site.
+              for (int dimension = 0; dimension < 3; dimension++)
+              {
+                hydroVarsWall.momentum[dimension] = wallDistance
+                    * hydroVarsWall.momentum[dimension]
+                    + (1. - wallDistance) * hydroVars.density
+                        * velocityWallSecondEstimate[dimension];
+              }
+              // Interpolate in the same way to get f_neq.
+              distribn_t* fNeqWall = hydroVarsWall.GetFNeqPtr();
+              for (unsigned j = 0; j < LatticeType::NUMVECTORS; ++j)
+              {
+                fNeqWall[j] = wallDistance * fNeqWall[j]
+                    + (1. - wallDistance) * (neighbourFOld[j] - neighbourFEq[j]);
+              }
             }
             // Finally, we want to collide and stream, using the chosen collision kernel.
             //
@@ -278,38 +366,35 @@ namespace hemelb::lb
             // Perform collision
             collider.Collide(lbmParams, hydroVarsWall);
             // stream
-            distribn_t* fNew = latDat.GetFNew(site.GetIndex() * LatticeType::NUMVECTORS);
-            fNew[i] = hydroVarsWall.GetFPostCollision()[i];
-
-          }
+            *latDat.GetFNew(link.target) = hydroVarsWall.GetFPostCollision()[link.streamed];
+        }
 
         void PostStepLink(geometry::FieldData&,
                           const geometry::Site<geometry::FieldData>&,
                           const Direction&) {
             // Nothing to do
         }
+
+        bool PostStepLinks(geometry::FieldData&, site_t, site_t) {
+            // Nothing to do
+            return true;
+        }
     private:
-        auto GetNeighbourFOld(const geometry::Site<geometry::FieldData>& site,
-                                    const Direction& i,
-                                    geometry::FieldData& latDat)
+        // The neighbour's values, copied into buffer if need be.
+        typename LatticeType::const_span GetNeighbourFOld(const LinkRecord& link,
+                                                          geometry::FieldData& latDat,
+                                                          FVector<LatticeType>& buffer)
         {
-            auto&& domain = latDat.GetDomain();
-            // Find the neighbour's global location and which proc it's on.
-            LatticeVector neighbourGlobalLocation = site.GetGlobalSiteCoords() + LatticeType::VECTORS[i];
-            proc_t neighbourProcessor = domain.GetProcIdFromGlobalCoords(neighbourGlobalLocation);
-            if (neighbourProcessor == domain.GetLocalRank())
+            if (link.nextSiteIsLocal)
             {
                 // If it's local, get a Site object for it.
-                geometry::Site<geometry::FieldData> nextSiteOut =
-                        latDat.GetSite(domain.GetContiguousSiteId(neighbourGlobalLocation));
-                return nextSiteOut.GetFOld<LatticeType>();
+                geometry::Site<geometry::FieldData> nextSiteOut = latDat.GetSite(link.nextSite);
+                return nextSiteOut.ReadFOld<LatticeType>(buffer);
             }
             else
             {
-                auto neighbourSite = latDat.GetNeighbouringData().GetSite(
-                        domain.GetGlobalNoncontiguousSiteIdFromGlobalCoords(neighbourGlobalLocation)
-                );
-                return neighbourSite.GetFOld<LatticeType>();
+                auto neighbourSite = latDat.GetNeighbouringData().GetSite(link.nextSite);
+                return neighbourSite.template ReadFOld<LatticeType>(buffer);
             }
         }
 
@@ -317,7 +402,7 @@ namespace hemelb::lb
         CollisionType collider;
         const geometry::neighbouring::NeighbouringDomain& neighbouringLatticeData;
         BoundaryValues* bValues;
-        BounceBackLink<CollisionType> bbDelegate;
+        PreparedLinks<LatticeType, LinkRecord> links;
     };
 
 }
@@ -6,12 +6,14 @@
 #ifndef HEMELB_LB_STREAMERS_JUNKYANG_H
 #define HEMELB_LB_STREAMERS_JUNKYANG_H
 
-#include <set>
-
-#include <boost/numeric/ublas/matrix.hpp>
-#include <boost/numeric/ublas/lu.hpp>
-#include <boost/numeric/ublas/io.hpp>
-
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Exception.h"
 #include "hassert.h"
 #include "units.h"
 #include "lb/streamers/Common.h"
@@ -27,6 +29,11 @@ namespace hemelb::lb
        *
        * This class implements the Junk & Yang no-slip boundary condition as described in
        * M. Junk and Z. Yang "One-point boundary condition for the lattice Boltzmann method", Phys Rev E 72 (2005)
+       *
+       * The linear system of each wall site depends only on the geometry, so is assembled and
+       * LU factorised once, at construction. The systems are held in one contiguous arena, in
+       * the order of the sites in the ranges the streamer is given, so that each step only
+       * does the forward and back substitution.
        */
     template<link_streamer IoletLinkImpl>
     class JunkYangFactory
@@ -37,44 +44,79 @@ namespace hemelb::lb
         using LatticeType = typename CollisionType::LatticeType;
         static constexpr bool has_iolet = !std::same_as<IoletLinkImpl, NullLink<CollisionType>>;
     private:
-        using matrix = boost::numeric::ublas::matrix<distribn_t>;
-        using identity_matrix = boost::numeric::ublas::identity_matrix<distribn_t>;
-        using permutation_matrix = boost::numeric::ublas::permutation_matrix<std::size_t>;
-        using c_vector = boost::numeric::ublas::c_vector<distribn_t, LatticeType::NUMVECTORS>;
-        using vector = boost::numeric::ublas::vector<distribn_t>;
+        static constexpr unsigned Q = LatticeType::NUMVECTORS;
+        //! Number of values in a cache line; each site's data in the arena starts on a fresh one.
+        static constexpr std::size_t LINE = 64 / sizeof(distribn_t);
+        struct alignas(64) CacheLine
+        {
+            distribn_t values[LINE];
+        };
+
+        /**
+         * Where to find the system of a wall site. Its data lives in the arena from offset
+         * (counted in values), as
+         *
+         *   - the LU factors of L (incoming x incoming, row major, with the reciprocals of
+         *     the pivots on the diagonal),
+         *   - K (incoming x Q, row major),
+         *   - sigma (Q) and
+         *   - the post-collision distributions in the inverse of the incoming directions
+         *     (incoming),
+         *
+         * where the columns of K and entries of sigma are in the order of directions: the
+         * incoming velocities (those with an inverse direction crossing a wall boundary)
+         * first, followed by the outgoing ones. The last two are filled in by StreamAndCollide
+         * for PostStep.
+         */
+        struct SiteSystem
+        {
+            std::size_t offset = 0;
+            unsigned incoming = 0;
+            std::array<std::uint8_t, Q> directions{};
+            //! Row swapped with each row during the factorisation.
+            std::array<std::uint8_t, Q> pivots{};
+        };
+
     public:
         JunkYangFactory(InitParams& initParams) :
               collider(initParams), bulkLinkDelegate(collider, initParams),
-                  ioletLinkDelegate(collider, initParams), THETA(0.7)/*,
-                  domainData(*initParams.latDat)*/
+                  ioletLinkDelegate(collider, initParams), THETA(0.7)
         {
             auto& dom = *initParams.latDat;
+            // One system per site of the ranges, in order, so a site's system can be found
+            // from its position in its range.
+            std::size_t arenaValues = 0;
             for (auto&& [site_begin, site_end]: initParams.siteRanges)
             {
+              rangeStarts.emplace_back(site_begin, systems.size());
               for (site_t siteIdx = site_begin; siteIdx < site_end; ++siteIdx)
               {
-                geometry::Site<const geometry::Domain> localSite = dom.GetSite(siteIdx);
-//                    domainData.GetSite(siteIdx);
-                // Only consider walls - the initParams .siteRanges should take care of that for us, but check anyway
-                if (localSite.IsWall())
-                {
-                  ConstructVelocitySets(siteIdx, dom);
-                  AssembleKMatrix(siteIdx, dom);
-                  AssembleLMatrix(siteIdx);
-                }
+                // The ranges should only hold walls, but any other site just gets a trivial
+                // system, with no incoming velocities.
+                auto& system = systems.emplace_back();
+                ConstructVelocitySets(dom.GetSite(siteIdx), system);
+                system.offset = arenaValues;
+                auto const n = system.incoming;
+                arenaValues += (n * n + n * Q + Q + n + LINE - 1) / LINE * LINE;
               }
             }
-            FactoriseLMatrices();
-          }
+            std::sort(rangeStarts.begin(), rangeStarts.end());
+            arena.resize(arenaValues / LINE);
 
-        ~JunkYangFactory()
-        {
-            // Free dynamically allocated permutation matrices.
-            for (auto& luPermutationMatrix : luPermutationMatrices)
+            for (auto&& [site_begin, site_end]: initParams.siteRanges)
             {
-                delete luPermutationMatrix.second;
+              for (site_t siteIdx = site_begin; siteIdx < site_end; ++siteIdx)
+              {
+                auto& system = SystemFor(siteIdx);
+                if (system.incoming == 0)
+                  continue;
+                AssembleKMatrix(dom.GetSite(siteIdx), system);
+                AssembleLMatrix(system);
+                if (!FactoriseLMatrix(LU(system), system.incoming, system.pivots))
+                  throw (Exception() << "Junk-Yang L matrix is singular at site " << siteIdx);
+              }
             }
-        }
+          }
 
         void StreamAndCollide(const site_t firstIndex, const site_t siteCount,
                               const LbmParameters* lbmParams,
@@ -84,7 +126,6 @@ namespace hemelb::lb
             for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
             {
               HASSERT(latticeData.GetSite(siteIndex).IsWall());
-              HASSERT(lMatrices.find(siteIndex) != lMatrices.end());
 
               auto&& site = latticeData.GetSite(siteIndex);
 
@@ -118,31 +159,22 @@ namespace hemelb::lb
                 }
               }
 
-              // The following for loops prepare the data required by DoPostStep
-
-              // TODO: Ideally, this should be done in the loop over directions above
-              // but the f's are permuted by the below making it tricky.
-              unsigned index = 0;
-              for (auto incomingVelocityIter = incomingVelocities[siteIndex].begin();
-                  incomingVelocityIter != incomingVelocities[siteIndex].end();
-                  ++incomingVelocityIter, ++index)
+              // Keep what PostStep needs from the collision: sigma (see AssembleRVector)
+              // and the post-collision distributions in the inverse incoming directions.
+              auto const& system = SystemFor(siteIndex);
+              auto const& fPostCollision = hydroVars.GetFPostCollision();
+              distribn_t* sigma = Sigma(system);
+              for (unsigned k = 0; k < Q; ++k)
               {
-                int inverseDirection = LatticeType::INVERSEDIRECTIONS[*incomingVelocityIter];
-
-                fPostCollision[siteIndex](index) =
-                    hydroVars.GetFPostCollision()[*incomingVelocityIter];
-                fPostCollisionInverseDir[siteIndex](index) =
-                    hydroVars.GetFPostCollision()[inverseDirection];
-                fOld[siteIndex](index) = site.GetFOld<LatticeType>()[*incomingVelocityIter];
+                auto const direction = system.directions[k];
+                sigma[k] = fPostCollision[direction]
+                    - (1 - THETA) * *latticeData.GetFOld(site.GetDistributionIndex(direction));
               }
-
-              for (auto outgoingVelocityIter = outgoingVelocities[siteIndex].begin();
-                  outgoingVelocityIter != outgoingVelocities[siteIndex].end();
-                  ++outgoingVelocityIter, ++index)
+              distribn_t* fPostCollisionInverseDir = FPostCollisionInverseDir(system);
+              for (unsigned a = 0; a < system.incoming; ++a)
               {
-                fPostCollision[siteIndex](index) =
-                    hydroVars.GetFPostCollision()[*outgoingVelocityIter];
-                fOld[siteIndex](index) = site.GetFOld<LatticeType>()[*outgoingVelocityIter];
+                fPostCollisionInverseDir[a] =
+                    fPostCollision[LatticeType::INVERSEDIRECTIONS[system.directions[a]]];
               }
 
                 UpdateCachePostCollision(site,
@@ -150,7 +182,7 @@ namespace hemelb::lb
                                          lbmParams,
                                          propertyCache);
             }
-
+            FinishKernelRange(collider);
         }
 
         void PostStep(const site_t firstIndex, const site_t siteCount,
@@ -160,37 +192,33 @@ namespace hemelb::lb
             for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
             {
               HASSERT(latticeData.GetSite(siteIndex).IsWall());
-              HASSERT(lMatrices.find(siteIndex) != lMatrices.end());
-              HASSERT(luPermutationMatrices.find(siteIndex) != luPermutationMatrices.end());
 
-              vector rVector;
-              AssembleRVector(siteIndex, latticeData,rVector);
+              auto&& site = latticeData.GetSite(siteIndex);
+              auto const& system = SystemFor(siteIndex);
+              auto const n = system.incoming;
 
-              // assemble RHS
-              vector systemRHS = fPostCollisionInverseDir[siteIndex] - rVector;
+              // assemble RHS, fPostCollisionInverseDir - r
+              std::array<distribn_t, Q> systemRHS;
+              AssembleRVector(system, site, latticeData, systemRHS);
+              distribn_t const* fPostCollisionInverseDir = FPostCollisionInverseDir(system);
+              for (unsigned a = 0; a < n; ++a)
+                systemRHS[a] = fPostCollisionInverseDir[a] - systemRHS[a];
 
-              // lu_substitue will overwrite the RHS with the solution
-              vector &systemSolution = systemRHS;
-              lu_substitute(lMatrices[siteIndex],
-                            *luPermutationMatrices[siteIndex],
-                            systemSolution);
+              // The substitution overwrites the RHS with the solution
+              std::array<distribn_t, Q>& systemSolution = systemRHS;
+              LUSubstitute(LU(system), n, system.pivots, systemSolution);
 
               // Update the distribution function for incoming velocities with the solution of the linear system
-              unsigned index = 0;
-              for (auto incomingVelocityIter = incomingVelocities[siteIndex].begin();
-                  incomingVelocityIter != incomingVelocities[siteIndex].end();
-                  ++incomingVelocityIter, ++index)
+              for (unsigned a = 0; a < n; ++a)
               {
-                * (latticeData.GetFNew(siteIndex * LatticeType::NUMVECTORS + *incomingVelocityIter)) =
-                    systemSolution[index];
+                *latticeData.GetFNew(site.GetDistributionIndex(system.directions[a])) = systemSolution[a];
               }
 
-              auto&& site = latticeData.GetSite(siteIndex);
-              for (unsigned int outgoingVelocityIter : outgoingVelocities[siteIndex])
-              {
-                  if constexpr (has_iolet) {
-                      if (site.HasIolet(outgoingVelocityIter)) {
-                          ioletLinkDelegate.PostStepLink(latticeData, site, outgoingVelocityIter);
+              if constexpr (has_iolet) {
+                  for (unsigned k = n; k < Q; ++k)
+                  {
+                      if (site.HasIolet(system.directions[k])) {
+                          ioletLinkDelegate.PostStepLink(latticeData, site, system.directions[k]);
                       }
                   }
               }
@@ -208,269 +236,222 @@ namespace hemelb::lb
           //! theta constant in the theta-method used for interpolation (0 for fully explicit, 1 for fully implicit)
           const distribn_t THETA;
 
-          //! Reference to the lattice object used for initialisation
-          //const geometry::Domain& domainData;
+          //! The first site of each range the streamer was constructed with, and the index of its system.
+          std::vector<std::pair<site_t, std::size_t>> rangeStarts;
+          //! The system of each site in the ranges.
+          std::vector<SiteSystem> systems;
+          //! Storage for the matrices and vectors of all the systems.
+          std::vector<CacheLine> arena;
 
-          //! Sets of incoming velocities (those with an inverse direction crossing a wall boundary)
-          std::map<site_t, std::set<Direction> > incomingVelocities;
-          //! Sets of outgoing velocities (the complement of incomingVelocities)
-          std::map<site_t, std::set<Direction> > outgoingVelocities;
-
-          //! Map containing the K matrices used to assemble both the left-hand- and the right-hand-side of the linear systems for each site
-          std::map<site_t, matrix> kMatrices;
-          //! Map containing the linear system left-hand-sides for each site
-          std::map<site_t, matrix > lMatrices;
-          /**
-           * Map containing the permutations generated by the LU factorisation of each linear system. The permutaation matrices are dinamically allocated
-           * because there isn't a default constructor for ublas::permutation_matrix (unlike other ublas data structures) and the size is not known until
-           * run time.
-           */
-          std::map<site_t, permutation_matrix*> luPermutationMatrices;
+          SiteSystem const& SystemFor(site_t siteIndex) const
+          {
+            auto range = std::upper_bound(rangeStarts.begin(), rangeStarts.end(), siteIndex,
+                                          [](site_t s, auto const& start) { return s < start.first; });
+            HASSERT(range != rangeStarts.begin());
+            --range;
+            return systems[range->second + (siteIndex - range->first)];
+          }
+          SiteSystem& SystemFor(site_t siteIndex)
+          {
+            return const_cast<SiteSystem&>(std::as_const(*this).SystemFor(siteIndex));
+          }
 
-          //! Map of postcollision distributions with incoming/outgoing ordering.
-          std::map<site_t, c_vector > fPostCollision;
-          //! Map of postcollision distributions for the inverse directions of those in the incoming set of velocities.
-          std::map<site_t, vector > fPostCollisionInverseDir;
-          //! Map of distributions in the previous time step with incoming/outgoing ordering.
-          std::map<site_t, c_vector > fOld;
+          distribn_t* LU(SiteSystem const& system)
+          {
+            return reinterpret_cast<distribn_t*>(arena.data()) + system.offset;
+          }
+          distribn_t const* LU(SiteSystem const& system) const
+          {
+            return reinterpret_cast<distribn_t const*>(arena.data()) + system.offset;
+          }
+          distribn_t* K(SiteSystem const& system)
+          {
+            return LU(system) + system.incoming * system.incoming;
+          }
+          distribn_t const* K(SiteSystem const& system) const
+          {
+            return LU(system) + system.incoming * system.incoming;
+          }
+          distribn_t* Sigma(SiteSystem const& system)
+          {
+            return K(system) + system.incoming * Q;
+          }
+          distribn_t const* Sigma(SiteSystem const& system) const
+          {
+            return K(system) + system.incoming * Q;
+          }
+          distribn_t* FPostCollisionInverseDir(SiteSystem const& system)
+          {
+            return Sigma(system) + Q;
+          }
 
           /**
-           * Construct the incoming/outgoing velocity sets for site siteLocalIndex
-           *
-           * @param contiguousSiteIndex Contiguous site index (for this core)
+           * Construct the incoming/outgoing velocity sets for site
            */
-          inline void ConstructVelocitySets(site_t contiguousSiteIndex, geometry::Domain const& dom)
+          template <typename SiteType>
+          inline void ConstructVelocitySets(SiteType const& site, SiteSystem& system)
           {
-            auto site = dom.GetSite(contiguousSiteIndex);
-
-            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; direction++)
-            {
-              int inverseDirection = LatticeType::INVERSEDIRECTIONS[direction];
-              if (site.HasWall(inverseDirection))
-              {
-                incomingVelocities[contiguousSiteIndex].insert(direction);
-              }
-              else
-              {
-                outgoingVelocities[contiguousSiteIndex].insert(direction);
-              }
-            }
-            fPostCollisionInverseDir[contiguousSiteIndex].resize(incomingVelocities[contiguousSiteIndex].size());
+            unsigned index = 0;
+            for (Direction direction = 0; direction < Q; direction++)
+              if (site.HasWall(LatticeType::INVERSEDIRECTIONS[direction]))
+                system.directions[index++] = direction;
+            system.incoming = index;
+            for (Direction direction = 0; direction < Q; direction++)
+              if (!site.HasWall(LatticeType::INVERSEDIRECTIONS[direction]))
+                system.directions[index++] = direction;
           }
 
           /**
-           * Assemble the K matrix for site contiguousSiteIndex.
+           * Assemble the K matrix for site.
            *
            * K is a rectangular matrix (num_incoming_vels x LatticeType::NUMVECTORS). Our
            * implementation places the columns corresponding to the set of incoming velocities
-           * first followed by those corresponding to outgoing velocities. This makes easier
-           * handling the subblocks with uBLAS.
-           *
-           * @param contiguousSiteIndex Contiguous site index (for this core)
+           * first followed by those corresponding to outgoing velocities.
            */
-          inline void AssembleKMatrix(site_t contiguousSiteIndex, geometry::Domain const& dom)
+          template <typename SiteType>
+          inline void AssembleKMatrix(SiteType const& site, SiteSystem const& system)
           {
-            geometry::Site<const geometry::Domain> site =
-                dom.GetSite(contiguousSiteIndex);
+            auto squaredNorm = [](Direction i) {
+              return LatticeType::CX[i] * LatticeType::CX[i] + LatticeType::CY[i] * LatticeType::CY[i]
+                  + LatticeType::CZ[i] * LatticeType::CZ[i];
+            };
 
-            unsigned incomingVelsSetSize = incomingVelocities[contiguousSiteIndex].size();
-
-            kMatrices[contiguousSiteIndex].resize(incomingVelsSetSize, LatticeType::NUMVECTORS);
-
-            /*
-             *  Assemble K(:, 0:num_incoming_velocities-1)
-             */
-            unsigned rowIndex = 0;
-            for (auto rowIndexIncomingVelocity = incomingVelocities[contiguousSiteIndex].begin();
-                rowIndexIncomingVelocity != incomingVelocities[contiguousSiteIndex].end();
-                ++rowIndexIncomingVelocity, ++rowIndex)
+            distribn_t* k = K(system);
+            for (unsigned row = 0; row < system.incoming; ++row)
             {
+              Direction const rowDirection = system.directions[row];
               // |c_i|^2, where c_i is the i-th velocity vector
-              const int rowRowdirectionsInnProd = LatticeType::CX[*rowIndexIncomingVelocity]
-                  * LatticeType::CX[*rowIndexIncomingVelocity]
-                  + LatticeType::CY[*rowIndexIncomingVelocity]
-                      * LatticeType::CY[*rowIndexIncomingVelocity]
-                  + LatticeType::CZ[*rowIndexIncomingVelocity]
-                      * LatticeType::CZ[*rowIndexIncomingVelocity];
-
-              unsigned columnIndex = 0;
-              for (auto columnIndexIncomingVelocity = incomingVelocities[contiguousSiteIndex].begin();
-                  columnIndexIncomingVelocity != incomingVelocities[contiguousSiteIndex].end();
-                  ++columnIndexIncomingVelocity, ++columnIndex)
-              {
-                // |c_i|^2, where c_i is the i-th velocity vector
-                const int colColdirectionsInnProd = LatticeType::CX[*columnIndexIncomingVelocity]
-                    * LatticeType::CX[*columnIndexIncomingVelocity]
-                    + LatticeType::CY[*columnIndexIncomingVelocity]
-                        * LatticeType::CY[*columnIndexIncomingVelocity]
-                    + LatticeType::CZ[*columnIndexIncomingVelocity]
-                        * LatticeType::CZ[*columnIndexIncomingVelocity];
-
-                // (c_i \dot c_j)^2, where c_{i,j} are the {i,j}-th velocity vectors
-                const int rowColdirectionsInnProd = LatticeType::CX[*rowIndexIncomingVelocity]
-                    * LatticeType::CX[*columnIndexIncomingVelocity]
-                    + LatticeType::CY[*rowIndexIncomingVelocity]
-                        * LatticeType::CY[*columnIndexIncomingVelocity]
-                    + LatticeType::CZ[*rowIndexIncomingVelocity]
-                        * LatticeType::CZ[*columnIndexIncomingVelocity];
-
-                HASSERT(site.template GetWallDistance<LatticeType>(LatticeType::INVERSEDIRECTIONS[(Direction ) *rowIndexIncomingVelocity])
-                    >= 0);
-                HASSERT(site.template GetWallDistance<LatticeType>(LatticeType::INVERSEDIRECTIONS[(Direction ) *rowIndexIncomingVelocity])
-                    < 1);
-
-                kMatrices[contiguousSiteIndex](rowIndex, columnIndex) =
-                    (-3.0 / 2.0)
-                        * (3.0
-                            - 6
-                                * site.template GetWallDistance<LatticeType>(LatticeType::INVERSEDIRECTIONS[(Direction) *rowIndexIncomingVelocity]))
-                        * LatticeType::EQMWEIGHTS[*rowIndexIncomingVelocity]
-                        * ( (rowColdirectionsInnProd * rowColdirectionsInnProd)
-                            - (rowRowdirectionsInnProd / 3.0)
-                            - LatticeType::VECTORS[*rowIndexIncomingVelocity][ALPHA]
-                                * LatticeType::VECTORS[*rowIndexIncomingVelocity][ALPHA]
-                                * (colColdirectionsInnProd - (DIMENSION / 3.0)));
-
-                HASSERT(fabs(kMatrices[contiguousSiteIndex](rowIndex, columnIndex)) < 1e3);
-              }
+              const int rowRowdirectionsInnProd = squaredNorm(rowDirection);
+              const distribn_t wallDistance =
+                  site.template GetWallDistance<LatticeType>(LatticeType::INVERSEDIRECTIONS[rowDirection]);
+              HASSERT(wallDistance >= 0);
+              HASSERT(wallDistance < 1);
 
-              /*
-               * Assemble K(:, num_incoming_velocities:num_incoming_velocities+num_outgoing_velocities-1)
-               */
-              for (auto columnIndexOutgoingVelocity =
-                  outgoingVelocities[contiguousSiteIndex].begin();
-                  columnIndexOutgoingVelocity != outgoingVelocities[contiguousSiteIndex].end();
-                  ++columnIndexOutgoingVelocity, ++columnIndex)
+              for (unsigned column = 0; column < Q; ++column)
               {
-                // |c_i|^2, where c_i is the i-th velocity vector
-                const int colColdirectionsInnProd = LatticeType::CX[*columnIndexOutgoingVelocity]
-                    * LatticeType::CX[*columnIndexOutgoingVelocity]
-                    + LatticeType::CY[*columnIndexOutgoingVelocity]
-                        * LatticeType::CY[*columnIndexOutgoingVelocity]
-                    + LatticeType::CZ[*columnIndexOutgoingVelocity]
-                        * LatticeType::CZ[*columnIndexOutgoingVelocity];
-
-                // (c_i \dot c_j)^2, where c_{i,j} are the {i,j}-th velocity vectors
-                const int rowColdirectionsInnProd = LatticeType::CX[*rowIndexIncomingVelocity]
-                    * LatticeType::CX[*columnIndexOutgoingVelocity]
-                    + LatticeType::CY[*rowIndexIncomingVelocity]
-                        * LatticeType::CY[*columnIndexOutgoingVelocity]
-                    + LatticeType::CZ[*rowIndexIncomingVelocity]
-                        * LatticeType::CZ[*columnIndexOutgoingVelocity];
-
-                HASSERT(site.template GetWallDistance<LatticeType>(LatticeType::INVERSEDIRECTIONS[(Direction ) *rowIndexIncomingVelocity])
-                    >= 0);
-                HASSERT(site.template GetWallDistance<LatticeType>(LatticeType::INVERSEDIRECTIONS[(Direction ) *rowIndexIncomingVelocity])
-                    < 1);
-
-                kMatrices[contiguousSiteIndex](rowIndex, columnIndex) =
-                    (-3.0 / 2.0)
-                        * (3.0
-                            - 6
-                                * site.template GetWallDistance<LatticeType>(LatticeType::INVERSEDIRECTIONS[(Direction) *rowIndexIncomingVelocity]))
-                        * LatticeType::EQMWEIGHTS[*rowIndexIncomingVelocity]
-                        * ( (rowColdirectionsInnProd * rowColdirectionsInnProd)
-                            - (rowRowdirectionsInnProd / 3.0)
-                            - LatticeType::VECTORS[*rowIndexIncomingVelocity][ALPHA]
-                                * LatticeType::VECTORS[*rowIndexIncomingVelocity][ALPHA]
-                                * (colColdirectionsInnProd - (DIMENSION / 3.0)));
-
-                HASSERT(fabs(kMatrices[contiguousSiteIndex](rowIndex, columnIndex)) < 1e3);
+                Direction const columnDirection = system.directions[column];
+                // |c_j|^2, where c_j is the j-th velocity vector
+                const int colColdirectionsInnProd = squaredNorm(columnDirection);
+                // c_i \dot c_j, where c_{i,j} are the {i,j}-th velocity vectors
+                const int rowColdirectionsInnProd =
+                    LatticeType::CX[rowDirection] * LatticeType::CX[columnDirection]
+                        + LatticeType::CY[rowDirection] * LatticeType::CY[columnDirection]
+                        + LatticeType::CZ[rowDirection] * LatticeType::CZ[columnDirection];
+
+                k[row * Q + column] = (-3.0 / 2.0) * (3.0 - 6 * wallDistance)
+                    * LatticeType::EQMWEIGHTS[rowDirection]
+                    * ( (rowColdirectionsInnProd * rowColdirectionsInnProd)
+                        - (rowRowdirectionsInnProd / 3.0)
+                        - LatticeType::VECTORS[rowDirection][ALPHA]
+                            * LatticeType::VECTORS[rowDirection][ALPHA]
+                            * (colColdirectionsInnProd - (DIMENSION / 3.0)));
+
+                HASSERT(std::fabs(k[row * Q + column]) < 1e3);
               }
-
             }
           }
 
           /**
-           * Assemble the L matrix for site contiguousSiteIndex. L is a square matrix (num_incoming_vels x num_incoming_vels)
-           *
-           * @param contiguousSiteIndex Contiguous site index (for this core)
+           * Assemble the L matrix for site. L is a square matrix (num_incoming_vels x
+           * num_incoming_vels), I + THETA * K(:, 0:num_incoming_vels-1).
            */
-          inline void AssembleLMatrix(site_t siteLocalIndex)
+          inline void AssembleLMatrix(SiteSystem const& system)
           {
-            unsigned incomingVelsSetSize = incomingVelocities[siteLocalIndex].size();
-
-            lMatrices[siteLocalIndex] = identity_matrix(incomingVelsSetSize)
-                + THETA
-                    * subrange(kMatrices[siteLocalIndex],
-                                      0,
-                                      incomingVelsSetSize,
-                                      0,
-                                      incomingVelsSetSize);
+            auto const n = system.incoming;
+            distribn_t* l = LU(system);
+            distribn_t const* k = K(system);
+            for (unsigned row = 0; row < n; ++row)
+              for (unsigned column = 0; column < n; ++column)
+                l[row * n + column] = (row == column ? 1.0 : 0.0) + THETA * k[row * Q + column];
           }
 
           /**
-           * Compute the LU factorisation of all the L matrices
+           * LU factorise the n x n matrix lu in place, with partial pivoting, leaving the
+           * reciprocals of the pivots on the diagonal.
+           *
+           * @return false if the matrix is singular
            */
-          inline void FactoriseLMatrices()
+          static bool FactoriseLMatrix(distribn_t* lu, unsigned n, std::array<std::uint8_t, Q>& pivots)
           {
-            for (auto iter = lMatrices.begin(); iter != lMatrices.end(); ++iter)
+            for (unsigned k = 0; k < n; ++k)
             {
-              luPermutationMatrices[iter->first] =
-                  new permutation_matrix(incomingVelocities[iter->first].size());
-              // If this assertion trips, lMatrices[siteLocalIndex] is singular.
-              HASSERT(lu_factorize(iter->second, *luPermutationMatrices[iter->first]) == 0);
+              unsigned pivot = k;
+              for (unsigned i = k + 1; i < n; ++i)
+                if (std::fabs(lu[i * n + k]) > std::fabs(lu[pivot * n + k]))
+                  pivot = i;
+              pivots[k] = pivot;
+              if (lu[pivot * n + k] == 0)
+                return false;
+              if (pivot != k)
+                std::swap_ranges(lu + k * n, lu + (k + 1) * n, lu + pivot * n);
+
+              const distribn_t inversePivot = 1.0 / lu[k * n + k];
+              for (unsigned i = k + 1; i < n; ++i)
+              {
+                distribn_t& factor = lu[i * n + k];
+                factor *= inversePivot;
+                for (unsigned j = k + 1; j < n; ++j)
+                  lu[i * n + j] -= factor * lu[k * n + j];
+              }
+              lu[k * n + k] = inversePivot;
             }
+            return true;
           }
 
           /**
-           * Assemble the sigma vector required to assemble the system RHS. We are not including
-           * the forcing term used in the paper to drive the flow. This might become necessary
-           * for biocolloids.
-           *
-           * @param contiguousSiteIndex Contiguous site index (for this core)
-           * @param sigmaVector sigma vector
+           * Solve LU x = P b, overwriting b (whose first n entries are used) with x.
            */
-          inline void AssembleSigmaVector(
-              const site_t contiguousSiteIndex,
-              c_vector& sigmaVector) // const
+          static void LUSubstitute(distribn_t const* lu, unsigned n,
+                                   std::array<std::uint8_t, Q> const& pivots,
+                                   std::array<distribn_t, Q>& b)
           {
-            HASSERT(fPostCollision.find(contiguousSiteIndex) != fPostCollision.end());
-            HASSERT(fOld.find(contiguousSiteIndex) != fOld.end());
-            sigmaVector = fPostCollision[contiguousSiteIndex]
-                - (1 - THETA) * fOld[contiguousSiteIndex];
+            for (unsigned i = 0; i < n; ++i)
+              std::swap(b[i], b[pivots[i]]);
+            for (unsigned i = 1; i < n; ++i)
+              for (unsigned j = 0; j < i; ++j)
+                b[i] -= lu[i * n + j] * b[j];
+            for (unsigned i = n; i-- > 0;)
+            {
+              for (unsigned j = i + 1; j < n; ++j)
+                b[i] -= lu[i * n + j] * b[j];
+              b[i] *= lu[i * n + i];
+            }
+          }
+
+          //! Dot product of a row of K with x, unrolled over the Q directions.
+          template <std::size_t... I>
+          static distribn_t DotQ(distribn_t const* row, std::array<distribn_t, Q> const& x,
+                                 std::index_sequence<I...>)
+          {
+            return ((row[I] * x[I]) + ...);
           }
 
           /**
-           * Assemble the r vector required to assemble the system RHS
+           * Assemble the r vector required to assemble the system RHS,
+           *
+           *   r = THETA * K(:, incoming:) fNew(outgoing) + K sigma
            *
-           * @param contiguousSiteIndex Contiguous site index (for this core)
-           * @param rVector r vector
+           * where sigma = fPostCollision - (1 - THETA) * fOld. We are not including the forcing
+           * term used in the paper to drive the flow. This might become necessary for
+           * biocolloids.
            */
-          inline void AssembleRVector(const site_t contiguousSiteIndex,
+          template <typename SiteType>
+          inline void AssembleRVector(SiteSystem const& system, SiteType const& site,
                                       geometry::FieldData const& fieldData,
-                                      vector& rVector) //const
+                                      std::array<distribn_t, Q>& rVector) const
           {
-            c_vector sigmaVector;
-            AssembleSigmaVector(contiguousSiteIndex, sigmaVector);
-
-            unsigned incomingVelsSetSize = incomingVelocities[contiguousSiteIndex].size();
-            unsigned outgoingVelsSetSize = outgoingVelocities[contiguousSiteIndex].size();
-
-            vector fNew(outgoingVelsSetSize);
-
-            /*
-             *  Assemble a vector with the updated values of the distribution function for the outgoing velocities,
-             *  which have already been streamed
-             */
-            HASSERT(fNew.size() == outgoingVelocities[contiguousSiteIndex].size());
-            unsigned index = 0;
-            for (auto outgoingDirIter =
-                outgoingVelocities[contiguousSiteIndex].begin();
-                outgoingDirIter != outgoingVelocities[contiguousSiteIndex].end();
-                ++outgoingDirIter, ++index)
-            {
-              fNew[index] = *fieldData.GetFNew(contiguousSiteIndex * LatticeType::NUMVECTORS
-                  + *outgoingDirIter);
-            }
-
-            rVector = THETA
-                * prod(subrange(kMatrices[contiguousSiteIndex],
-                                              0,
-                                              incomingVelsSetSize,
-                                              incomingVelsSetSize,
-                                              LatticeType::NUMVECTORS),
-                              fNew) + prod(kMatrices[contiguousSiteIndex], sigmaVector);
+            // As a single product with K: sigma, plus THETA times the updated values of the
+            // distribution function for the outgoing velocities, which have already been
+            // streamed.
+            std::array<distribn_t, Q> x;
+            distribn_t const* sigma = Sigma(system);
+            std::copy(sigma, sigma + Q, x.begin());
+            for (unsigned k = system.incoming; k < Q; ++k)
+              x[k] += THETA * *fieldData.GetFNew(site.GetDistributionIndex(system.directions[k]));
+
+            distribn_t const* k = K(system);
+            for (unsigned row = 0; row < system.incoming; ++row)
+              rVector[row] = DotQ(k + row * Q, x, std::make_index_sequence<Q>{});
           }
       };
 }
@@ -6,7 +6,13 @@
 #ifndef HEMELB_LB_STREAMERS_LADDIOLET_H
 #define HEMELB_LB_STREAMERS_LADDIOLET_H
 
+#include <limits>
+#include <tuple>
+#include <vector>
+
 #include "lb/concepts.h"
+#include "lb/iolets/BoundaryValues.h"
+#include "lb/iolets/InOutLetVelocity.h"
 #include "lb/streamers/SimpleBounceBack.h"
 
 namespace hemelb::lb
@@ -24,6 +30,31 @@ namespace hemelb::lb
                 BounceBackLink<CollisionType>(delegatorCollider, initParams),
                 bValues(initParams.boundaryObject)
         {
+            if (bValues == nullptr || initParams.latDat == nullptr)
+                return;
+
+            // Register the half-way point of each of our iolet links with its iolet, so that
+            // as much as possible of the velocity there can be worked out now.
+            auto const& dom = *initParams.latDat;
+            for (auto [first, last]: initParams.siteRanges)
+            {
+                rangeStarts.emplace_back(first, last, velocityPoints.size());
+                for (site_t siteIndex = first; siteIndex < last; ++siteIndex)
+                {
+                    auto const site = dom.GetSite(siteIndex);
+                    for (Direction ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
+                    {
+                        std::size_t point = NO_POINT;
+                        if (site.HasIolet(ii))
+                        {
+                            auto iolet = dynamic_cast<InOutLetVelocity*>(bValues->GetLocalIolet(site.GetIoletId()));
+                            if (iolet != nullptr)
+                                point = iolet->RegisterVelocityPoint(HalfWay(site, ii));
+                        }
+                        velocityPoints.push_back(point);
+                    }
+                }
+            }
         }
 
         void StreamLink(const LbmParameters* lbmParams,
@@ -44,12 +75,11 @@ namespace hemelb::lb
 
             int boundaryId = site.GetIoletId();
             auto iolet = dynamic_cast<InOutLetVelocity*>(bValues->GetLocalIolet(boundaryId));
-            LatticePosition sitePos(site.GetGlobalSiteCoords());
 
-            LatticePosition halfWay(sitePos);
-            halfWay += 0.5 * LatticeType::VECTORS[ii];
-
-            LatticeVelocity wallMom(iolet->GetVelocity(halfWay, bValues->GetTimeStep()));
+            auto const point = FindVelocityPoint(site.GetIndex(), ii);
+            LatticeVelocity wallMom(point == NO_POINT ?
+                                    iolet->GetVelocity(HalfWay(site, ii), bValues->GetTimeStep()) :
+                                    iolet->GetVelocityAtPoint(point, bValues->GetTimeStep()));
             //TODO: Add site.GetGlobalSiteCoords() as a first argument?
 
             if (LatticeType::IsLatticeCompressible())
@@ -60,12 +90,35 @@ namespace hemelb::lb
             distribn_t correction = 2. * LatticeType::EQMWEIGHTS[ii]
                                     * Dot(wallMom, LatticeType::VECTORS[ii]) / Cs2;
 
-            * (latticeData.GetFNew(BounceBackLink<CollisionType>::GetBBIndex(site.GetIndex(),
-                                                                             ii))) =
+            * (latticeData.GetFNew(BounceBackLink<CollisionType>::GetBBIndex(site, ii))) =
                     hydroVars.GetFPostCollision()[ii] - correction;
         }
     private:
+        static constexpr std::size_t NO_POINT = std::numeric_limits<std::size_t>::max();
+
         BoundaryValues* bValues;
+        //! For each of our ranges of sites, its first and last site and where its sites start
+        //! in velocityPoints.
+        std::vector<std::tuple<site_t, site_t, std::size_t>> rangeStarts;
+        //! For each site of our ranges and direction, the point registered with the iolet
+        //! for the link, or NO_POINT.
+        std::vector<std::size_t> velocityPoints;
+
+        template <typename SiteType>
+        static LatticePosition HalfWay(const SiteType& site, Direction ii)
+        {
+            LatticePosition halfWay(site.GetGlobalSiteCoords());
+            halfWay += 0.5 * LatticeType::VECTORS[ii];
+            return halfWay;
+        }
+
+        std::size_t FindVelocityPoint(site_t siteIndex, Direction ii) const
+        {
+            for (auto [first, last, start]: rangeStarts)
+                if (first <= siteIndex && siteIndex < last)
+                    return velocityPoints[start + (siteIndex - first) * LatticeType::NUMVECTORS + ii];
+            return NO_POINT;
+        }
     };
 
 }
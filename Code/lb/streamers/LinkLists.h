@@ -0,0 +1,200 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_LB_STREAMERS_LINKLISTS_H
+#define HEMELB_LB_STREAMERS_LINKLISTS_H
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "geometry/Domain.h"
+#include "lb/concepts.h"
+
+namespace hemelb::lb
+{
+    /// A link from a fluid site that crosses a wall or an iolet.
+    struct SiteLink
+    {
+        site_t site;
+        Direction direction;
+    };
+
+    namespace detail
+    {
+        // The entries of a list ordered by site that are for the sites [first, last).
+        template<typename T>
+        std::span<const T> SliceBySite(std::vector<T> const& links, site_t first, site_t last)
+        {
+            auto bySite = [](T const& link, site_t site) {
+                return link.site < site;
+            };
+            auto begin = std::lower_bound(links.begin(), links.end(), first, bySite);
+            auto end = std::lower_bound(begin, links.end(), last, bySite);
+            return {begin, end};
+        }
+    }
+
+    /**
+     * The wall and iolet links of the sites a streamer is responsible
+     * for, found once at initialisation so that the streamer need not
+     * test every direction of every site on every step.
+     *
+     * There is one pair of lists for each contiguous range of sites
+     * (see InitParams::siteRanges); within a list the links are in
+     * order of site, then direction. A link is put in the iolet list if
+     * it has an iolet and otherwise in the wall list if it has a wall,
+     * matching the order StreamerTypeFactory tests them in.
+     */
+    template<lattice_type LatticeType>
+    class LinkLists
+    {
+    public:
+        struct Range
+        {
+            site_t first;
+            site_t last;
+            std::vector<SiteLink> wallLinks;
+            std::vector<SiteLink> ioletLinks;
+        };
+
+        /// The links of the sites [first, first + count) in one range.
+        struct View
+        {
+            std::span<const SiteLink> wallLinks;
+            std::span<const SiteLink> ioletLinks;
+        };
+
+        LinkLists() = default;
+
+        LinkLists(const geometry::Domain& dom, std::vector<std::pair<site_t, site_t>> const& siteRanges) :
+                domain(&dom)
+        {
+            for (auto [first, last]: siteRanges)
+            {
+                if (first == last)
+                    continue;
+
+                Range& r = ranges.emplace_back(Range{first, last, {}, {}});
+                for (site_t siteIndex = first; siteIndex < last; ++siteIndex)
+                {
+                    auto const site = dom.GetSite(siteIndex);
+                    for (Direction ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
+                    {
+                        if (site.HasIolet(ii))
+                            r.ioletLinks.push_back({siteIndex, ii});
+                        else if (site.HasWall(ii))
+                            r.wallLinks.push_back({siteIndex, ii});
+                    }
+                }
+            }
+        }
+
+        /**
+         * Find the links for the sites [first, first + count) of the
+         * given domain, which must lie within one of the ranges the
+         * lists were built for. Returns false (e.g. for a different
+         * domain, or a range that wasn't given at construction) if
+         * there are none, in which case the caller must test each link.
+         */
+        bool Find(const geometry::Domain& dom, site_t first, site_t count, View& ans) const
+        {
+            if (&dom != domain)
+                return false;
+
+            for (auto const& r: ranges)
+            {
+                if (first < r.first || first + count > r.last)
+                    continue;
+
+                ans.wallLinks = detail::SliceBySite(r.wallLinks, first, first + count);
+                ans.ioletLinks = detail::SliceBySite(r.ioletLinks, first, first + count);
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        const geometry::Domain* domain = nullptr;
+        std::vector<Range> ranges;
+    };
+
+    /**
+     * Records that a wall link streamer makes once at initialisation
+     * for each of its wall links (see prepared_link_streamer), holding
+     * whatever it would otherwise work out from the geometry on every
+     * step. The records are kept per range of sites, in the order of
+     * LinkLists::Range::wallLinks, and Record must have a member
+     * `site_t site`.
+     *
+     * The function that makes a record may return an empty optional to
+     * leave a link out, e.g. when it needs no work on the post step; a
+     * list with every wall link in it can be walked together with the
+     * LinkLists.
+     */
+    template<lattice_type LatticeType, typename Record>
+    class PreparedLinks
+    {
+    public:
+        PreparedLinks() = default;
+
+        template<typename F>
+        PreparedLinks(const geometry::Domain& dom, std::vector<std::pair<site_t, site_t>> const& siteRanges,
+                      F&& prepare) :
+                domain(&dom)
+        {
+            for (auto [first, last]: siteRanges)
+            {
+                if (first == last)
+                    continue;
+
+                Range& r = ranges.emplace_back(Range{first, last, {}});
+                for (site_t siteIndex = first; siteIndex < last; ++siteIndex)
+                {
+                    auto const site = dom.GetSite(siteIndex);
+                    for (Direction ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
+                    {
+                        if (site.HasIolet(ii) || !site.HasWall(ii))
+                            continue;
+                        if (auto record = prepare(site, ii))
+                            r.records.push_back(*record);
+                    }
+                }
+            }
+        }
+
+        /// As LinkLists::Find, for the records.
+        bool Find(const geometry::Domain& dom, site_t first, site_t count, std::span<const Record>& ans) const
+        {
+            if (&dom != domain)
+                return false;
+
+            for (auto const& r: ranges)
+            {
+                if (first < r.first || first + count > r.last)
+                    continue;
+
+                ans = detail::SliceBySite(r.records, first, first + count);
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        struct Range
+        {
+            site_t first;
+            site_t last;
+            std::vector<Record> records;
+        };
+
+        const geometry::Domain* domain = nullptr;
+        std::vector<Range> ranges;
+    };
+}
+
+#endif
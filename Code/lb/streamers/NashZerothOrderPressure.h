@@ -17,6 +17,13 @@ namespace hemelb::lb
         using CollisionType = C;
         using VarsType = typename CollisionType::VarsType;
         using LatticeType = typename CollisionType::LatticeType;
+        static constexpr bool supports_aa_pattern = true;
+        static constexpr bool supports_any_layout = true;
+        // The ghost site's equilibrium is found as if for site 0, so
+        // only if that doesn't change the site's state.
+        static constexpr bool supports_threading = !requires {
+            requires CollisionType::KernelType::feq_updates_site;
+        };
 
         NashZerothOrderPressureLink(CollisionType& delegatorCollider,
                                     InitParams& initParams) :
@@ -55,7 +62,7 @@ namespace hemelb::lb
 
             Direction unstreamed = LatticeType::INVERSEDIRECTIONS[direction];
 
-            *latticeData.GetFNew(site.GetIndex() * LatticeType::NUMVECTORS + unstreamed) =
+            *latticeData.GetFNew(site.GetDistributionIndex(unstreamed)) =
                 ghostHydrovars.GetFEq()[unstreamed];
         }
 
@@ -19,10 +19,14 @@ namespace hemelb::lb
         using CollisionType = C;
         using VarsType = typename CollisionType::VarsType;
         using LatticeType = typename CollisionType::LatticeType;
+        static constexpr bool supports_aa_pattern = true;
+        static constexpr bool supports_any_layout = true;
+        static constexpr bool supports_threading = true;
 
-        static site_t GetBBIndex(site_t siteIndex, int direction)
+        template<class DataSource>
+        static site_t GetBBIndex(const geometry::Site<DataSource>& site, Direction direction)
         {
-            return (siteIndex * LatticeType::NUMVECTORS) + LatticeType::INVERSEDIRECTIONS[direction];
+            return site.GetDistributionIndex(LatticeType::INVERSEDIRECTIONS[direction]);
         }
 
         BounceBackLink(CollisionType& delegatorCollider,
@@ -37,7 +41,7 @@ namespace hemelb::lb
                         const Direction& direction)
         {
             // Propagate the outgoing post-collisional f into the opposite direction.
-            * (latticeData.GetFNew(GetBBIndex(site.GetIndex(), direction))) =
+            * (latticeData.GetFNew(GetBBIndex(site, direction))) =
                     hydroVars.GetFPostCollision()[direction];
         }
         void PostStepLink(geometry::FieldData& latticeData,
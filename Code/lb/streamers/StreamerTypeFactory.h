@@ -6,8 +6,11 @@
 #ifndef HEMELB_LB_STREAMERS_STREAMERTYPEFACTORY_H
 #define HEMELB_LB_STREAMERS_STREAMERTYPEFACTORY_H
 
+#include <bitset>
+
 #include "lb/streamers/Common.h"
 #include "lb/streamers/BulkStreamer.h"
+#include "lb/streamers/LinkLists.h"
 
 namespace hemelb::lb
 {
@@ -32,16 +35,31 @@ namespace hemelb::lb
         // Use these in the if statements below so the compiler can optimise them away if false.
         static constexpr bool can_have_wall = !std::same_as<WallLinkImpl, NullLink<CollisionType>>;
         static constexpr bool can_have_iolet = !std::same_as<IoletLinkImpl, NullLink<CollisionType>>;
+        static constexpr bool has_prepared_walls = prepared_link_streamer<WallLinkImpl>;
+
+        template<typename T>
+        struct link_record { using type = SiteLink; };
+        template<prepared_link_streamer T>
+        struct link_record<T> { using type = typename T::LinkRecord; };
+        using WallRecord = typename link_record<WallLinkImpl>::type;
 
         CollisionType collider;
         BulkLink<CollisionType> bulkLinkDelegate;
         WallLinkImpl wallLinkDelegate;
         IoletLinkImpl ioletLinkDelegate;
+        LinkLists<LatticeType> linkLists;
 
     public:
+        static constexpr bool supports_aa_pattern = aa_link_streamer<WallLinkImpl> && aa_link_streamer<IoletLinkImpl>;
+        static constexpr bool supports_any_layout = any_layout_link_streamer<WallLinkImpl>
+                && any_layout_link_streamer<IoletLinkImpl>;
+        static constexpr bool supports_threading = threadable_link_streamer<WallLinkImpl>
+                && threadable_link_streamer<IoletLinkImpl>;
+
         StreamerTypeFactory(InitParams& initParams) :
                 collider(initParams), bulkLinkDelegate(collider, initParams),
-                wallLinkDelegate(collider, initParams), ioletLinkDelegate(collider, initParams)
+                wallLinkDelegate(collider, initParams), ioletLinkDelegate(collider, initParams),
+                linkLists(*initParams.latDat, initParams.siteRanges)
         {
         }
 
@@ -50,10 +68,148 @@ namespace hemelb::lb
                               geometry::FieldData& latDat,
                               lb::MacroscopicPropertyCache& propertyCache)
         {
+            switch (GetStepKind(latDat))
+            {
+                case StepKind::AB:
+                    DoStreamAndCollide<StepKind::AB>(firstIndex, siteCount, lbmParams, latDat, propertyCache);
+                    break;
+                case StepKind::AAEven:
+                    if constexpr (supports_aa_pattern)
+                        DoStreamAndCollide<StepKind::AAEven>(firstIndex, siteCount, lbmParams, latDat, propertyCache);
+                    break;
+                case StepKind::AAOdd:
+                    if constexpr (supports_aa_pattern)
+                        DoStreamAndCollide<StepKind::AAOdd>(firstIndex, siteCount, lbmParams, latDat, propertyCache);
+                    break;
+            }
+            FinishKernelRange(collider);
+        }
+
+        void PostStep(const site_t firstIndex, const site_t siteCount,
+                      const LbmParameters* lbmParams, geometry::FieldData& latticeData,
+                      lb::MacroscopicPropertyCache& propertyCache)
+        {
+            // A wall link streamer with prepared links does all its
+            // sites at once.
+            bool wallsDone = false;
+            if constexpr (has_prepared_walls)
+                wallsDone = wallLinkDelegate.PostStepLinks(latticeData, firstIndex, siteCount);
+
+            typename LinkLists<LatticeType>::View links;
+            if (linkLists.Find(latticeData.GetDomain(), firstIndex, siteCount, links))
+            {
+                if constexpr (can_have_wall)
+                    if (!wallsDone)
+                        for (auto [siteIndex, direction]: links.wallLinks)
+                            wallLinkDelegate.PostStepLink(latticeData, latticeData.GetSite(siteIndex), direction);
+                if constexpr (can_have_iolet)
+                    for (auto [siteIndex, direction]: links.ioletLinks)
+                        ioletLinkDelegate.PostStepLink(latticeData, latticeData.GetSite(siteIndex), direction);
+                return;
+            }
+
+            for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
+            {
+                geometry::Site<geometry::FieldData> site = latticeData.GetSite(siteIndex);
+                for (unsigned int direction = 0; direction < LatticeType::NUMVECTORS; direction++)
+                {
+                    if (can_have_wall && site.HasWall(direction))
+                    {
+                        if (!wallsDone)
+                            wallLinkDelegate.PostStepLink(latticeData, site, direction);
+                    }
+                    else if (can_have_iolet && site.HasIolet(direction))
+                    {
+                        ioletLinkDelegate.PostStepLink(latticeData, site, direction);
+                    }
+                }
+            }
+
+        }
+
+    private:
+        template<StepKind STEP>
+        void DoStreamAndCollide(const site_t firstIndex, const site_t siteCount,
+                                const LbmParameters* lbmParams,
+                                geometry::FieldData& latDat,
+                                lb::MacroscopicPropertyCache& propertyCache)
+        {
+            FVector<LatticeType> gathered;
+            // Except on odd AA steps a site collides its own values,
+            // which must be copied out unless the layout keeps them together.
+            const bool gatherOwn = !latDat.GetDomain().GetDistributionLayout().IsSiteContiguous();
+
+            // Links with nothing to handle them stream as bulk links,
+            // except into the rubbish site: many threads may be
+            // streaming at once and they must not all write there.
+            const site_t rubbish = latDat.GetDomain().GetDistributionLayout().GetStorageSize();
+
+            // If the wall and iolet links are known in advance, mark
+            // each site's in a mask and stream the other directions
+            // as bulk links without testing each one.
+            typename LinkLists<LatticeType>::View links;
+            const bool useLinkLists = linkLists.Find(latDat.GetDomain(), firstIndex, siteCount, links);
+            auto nextWall = links.wallLinks.begin();
+            auto nextIolet = links.ioletLinks.begin();
+
+            // A wall link streamer that prepared its links gets those
+            // records instead; they are in the same order as the
+            // wall links.
+            std::span<const WallRecord> wallRecords;
+            bool usePreparedWalls = false;
+            if constexpr (has_prepared_walls)
+                usePreparedWalls = useLinkLists
+                        && wallLinkDelegate.FindLinks(latDat.GetDomain(), firstIndex, siteCount, wallRecords)
+                        && wallRecords.size() == links.wallLinks.size();
+
             for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
             {
                 geometry::Site<geometry::FieldData> site = latDat.GetSite(siteIndex);
-                VarsType hydroVars(site);
+
+                // This site's wall and iolet links.
+                auto const wallBegin = nextWall;
+                auto const ioletBegin = nextIolet;
+                if (useLinkLists)
+                {
+                    while (nextWall != links.wallLinks.end() && nextWall->site == siteIndex)
+                        ++nextWall;
+                    while (nextIolet != links.ioletLinks.end() && nextIolet->site == siteIndex)
+                        ++nextIolet;
+                }
+                std::span<const SiteLink> siteWallLinks(wallBegin, nextWall);
+                std::span<const SiteLink> siteIoletLinks(ioletBegin, nextIolet);
+
+                typename LatticeType::const_span f = gathered;
+                if constexpr (STEP == StepKind::AAOdd)
+                {
+                    if (useLinkLists)
+                    {
+                        GatherAAOddStepInputs<LatticeType, false>(latDat, site, gathered);
+                        if constexpr (can_have_wall || can_have_iolet)
+                        {
+                            // Links that were bounced back on the even step left their values here.
+                            for (auto special: {siteWallLinks, siteIoletLinks})
+                                for (auto [_, direction]: special)
+                                {
+                                    const Direction inv = LatticeType::INVERSEDIRECTIONS[direction];
+                                    gathered[inv] = *latDat.GetFOld(site.GetDistributionIndex(inv));
+                                }
+                        }
+                    }
+                    else
+                    {
+                        GatherAAOddStepInputs<LatticeType, can_have_wall || can_have_iolet>(latDat, site, gathered);
+                    }
+                }
+                else if (gatherOwn)
+                {
+                    site.GatherFOld<LatticeType>(gathered);
+                }
+                else
+                {
+                    f = site.ReadFOld<LatticeType>(gathered);
+                }
+                VarsType hydroVars(site, f);
 
                 ///< @todo #126 This value of tau will be updated by some kernels within the collider code (e.g. LBGKNN). It would be nicer if tau is handled in a single place.
                 hydroVars.tau = lbmParams->GetTau();
@@ -62,8 +218,54 @@ namespace hemelb::lb
 
                 collider.Collide(lbmParams, hydroVars);
 
+                if (useLinkLists)
+                {
+                    std::bitset<LatticeType::NUMVECTORS> special;
+                    for (auto specialLinks: {siteWallLinks, siteIoletLinks})
+                        for (auto [_, ii]: specialLinks)
+                            special.set(ii);
+
+                    for (Direction ii = 0; ii < LatticeType::NUMVECTORS; ii++)
+                    {
+                        if (special.test(ii))
+                            continue;
+                        if constexpr (STEP == StepKind::AAEven)
+                            bulkLinkDelegate.StreamLinkInPlace(latDat, site, hydroVars, ii);
+                        else
+                            bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
+                    }
+                    if constexpr (can_have_iolet)
+                        for (auto [_, ii]: siteIoletLinks)
+                            ioletLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
+                    else
+                        for (auto [_, ii]: siteIoletLinks)
+                            StreamUnhandledLink<STEP>(lbmParams, latDat, site, hydroVars, ii, rubbish);
+                    if constexpr (has_prepared_walls)
+                    {
+                        if (usePreparedWalls)
+                        {
+                            auto const offset = wallBegin - links.wallLinks.begin();
+                            for (auto const& link: wallRecords.subspan(offset, siteWallLinks.size()))
+                                wallLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, link);
+                            siteWallLinks = {};
+                        }
+                    }
+                    if constexpr (can_have_wall)
+                        for (auto [_, ii]: siteWallLinks)
+                            wallLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
+                    else
+                        for (auto [_, ii]: siteWallLinks)
+                            StreamUnhandledLink<STEP>(lbmParams, latDat, site, hydroVars, ii, rubbish);
+
+                    UpdateCachePostCollision(site, hydroVars, lbmParams, propertyCache);
+                    continue;
+                }
+
                 for (Direction ii = 0; ii < LatticeType::NUMVECTORS; ii++)
                 {
+                    // Under the AA pattern, wall and iolet links write back
+                    // into this site on both steps, so only the bulk links
+                    // care which step it is.
                     if (can_have_iolet && site.HasIolet(ii))
                     {
                         ioletLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
@@ -72,6 +274,14 @@ namespace hemelb::lb
                     {
                         wallLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
                     }
+                    else if ((!can_have_iolet || !can_have_wall) && (site.HasIolet(ii) || site.HasWall(ii)))
+                    {
+                        StreamUnhandledLink<STEP>(lbmParams, latDat, site, hydroVars, ii, rubbish);
+                    }
+                    else if constexpr (STEP == StepKind::AAEven)
+                    {
+                        bulkLinkDelegate.StreamLinkInPlace(latDat, site, hydroVars, ii);
+                    }
                     else
                     {
                         bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
@@ -85,26 +295,16 @@ namespace hemelb::lb
             }
         }
 
-        void PostStep(const site_t firstIndex, const site_t siteCount,
-                      const LbmParameters* lbmParams, geometry::FieldData& latticeData,
-                      lb::MacroscopicPropertyCache& propertyCache)
+        // A wall or iolet link with a NullLink delegate.
+        template<StepKind STEP>
+        void StreamUnhandledLink(const LbmParameters* lbmParams, geometry::FieldData& latDat,
+                                 const geometry::Site<geometry::FieldData>& site, VarsType& hydroVars,
+                                 Direction ii, site_t rubbish)
         {
-            for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
-            {
-                geometry::Site<geometry::FieldData> site = latticeData.GetSite(siteIndex);
-                for (unsigned int direction = 0; direction < LatticeType::NUMVECTORS; direction++)
-                {
-                    if (can_have_wall && site.HasWall(direction))
-                    {
-                        wallLinkDelegate.PostStepLink(latticeData, site, direction);
-                    }
-                    else if (can_have_iolet && site.HasIolet(direction))
-                    {
-                        ioletLinkDelegate.PostStepLink(latticeData, site, direction);
-                    }
-                }
-            }
-
+            if constexpr (STEP == StepKind::AAEven)
+                bulkLinkDelegate.StreamLinkInPlace(latDat, site, hydroVars, ii);
+            else if (site_t(site.template GetStreamedIndex<LatticeType>(ii)) != rubbish)
+                bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
         }
     };
 }
@@ -182,6 +182,7 @@ namespace hemelb::lb
                                          lbmParams,
                                          propertyCache);
             }
+            FinishKernelRange(collider);
           }
 
           void PostStep(const site_t firstIndex, const site_t siteCount,
@@ -441,7 +442,8 @@ namespace hemelb::lb
 
             auto neigh =
                 latDat.GetNeighbouringData().GetSite(globalIdx);
-            auto fOld = neigh.GetFOld<LatticeType>();
+            FVector<LatticeType> fBuffer;
+            auto fOld = neigh.template ReadFOld<LatticeType>(fBuffer);
             LatticeType::CalculateDensityAndMomentum(fOld, ans.rho, ans.u);
             if (LatticeType::IsLatticeCompressible())
             {
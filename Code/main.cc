@@ -7,7 +7,7 @@
 #include "net/IOCommunicator.h"
 #include "configuration/CommandLine.h"
 #include "debug.h"
-#include "SimulationMaster.h"
+#include "TraitsRegistry.h"
 
 int main(int argc, char *argv[])
 {
@@ -37,11 +37,9 @@ int main(int argc, char *argv[])
       // Start the debugger (if requested)
       debug::Init(options.GetDebug(), argv[0], commWorld);
 
-      // Prepare main simulation object...
-      SimulationMaster<> master(options, hemelbCommunicator);
-
-      // ..and run it.
-      master.RunSimulation();
+      // Prepare the main simulation object, with the Traits the
+      // configuration asks for, and run it.
+      RunConfiguredSimulation(options, hemelbCommunicator);
     }
 
     // Interpose this catch to print usage before propagating the error.
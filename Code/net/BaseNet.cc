@@ -41,6 +41,8 @@ namespace hemelb
       ReceiveAllToAll();
       // Ensure collectives are called before point-to-point, as some implementing mixins implement collectives via point-to-point
       ReceivePointToPoint();
+      for (auto* requests: persistentRequests)
+        requests->StartReceives();
     }
 
     void BaseNet::Send()
@@ -51,6 +53,8 @@ namespace hemelb
       SendAllToAll();
       // Ensure collectives are called before point-to-point, as some implementing mixins implement collectives via point-to-point
       SendPointToPoint();
+      for (auto* requests: persistentRequests)
+        requests->StartSends();
     }
 
     void BaseNet::Wait()
@@ -61,11 +65,19 @@ namespace hemelb
       WaitGatherVs();
       WaitPointToPoint();
       WaitAllToAll();
+      for (auto* requests: persistentRequests)
+        requests->Wait();
+      persistentRequests.clear();
 
       displacementsBuffer.clear();
       countsBuffer.clear();
     }
 
+    void BaseNet::RequestPersistent(PersistentRequests& requests)
+    {
+      persistentRequests.push_back(&requests);
+    }
+
     std::vector<int> & BaseNet::GetDisplacementsBuffer()
     {
       displacementsBuffer.push_back(std::vector<int>());
@@ -14,6 +14,7 @@
 #include "constants.h"
 #include "net/mpi.h"
 #include "net/MpiCommunicator.h"
+#include "net/PersistentRequests.h"
 
 namespace hemelb
 {
@@ -43,6 +44,13 @@ namespace hemelb
          */
         void Dispatch();
 
+        /***
+         * Start these messages along with the others in Receive and
+         * Send, and complete them in Wait. Must be requested again for
+         * each round of communication it is wanted in.
+         */
+        void RequestPersistent(PersistentRequests& requests);
+
         inline const MpiCommunicator &GetCommunicator() const
         {
           return communicator;
@@ -102,6 +110,8 @@ namespace hemelb
          */
         std::vector<std::vector<int> > displacementsBuffer;
         std::vector<std::vector<int> > countsBuffer;
+
+        std::vector<PersistentRequests*> persistentRequests;
     };
   }
 }
@@ -59,6 +59,13 @@ namespace hemelb::net
         void ReadAtAll(MPI_Offset offset, std::span<T, N> buffer,
                        MPI_Status* stat = MPI_STATUS_IGNORE);
 
+        // Start a read, returning the request to wait on.
+        template<typename T, std::size_t N>
+        MPI_Request IReadAt(MPI_Offset offset, std::span<T, N> buffer);
+        // Start a collective read, returning the request to wait on.
+        template<typename T, std::size_t N>
+        MPI_Request IReadAtAll(MPI_Offset offset, std::span<T, N> buffer);
+
         template<typename T, std::size_t N>
         void Write(std::span<T const, N> buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
         template<typename T, std::size_t N>
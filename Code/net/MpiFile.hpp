@@ -27,6 +27,20 @@ namespace hemelb::net
       MpiCall{MPI_File_read_at_all}(*filePtr, offset, buffer.data(), buffer.size(), MpiDataType<T>(), stat);
 
     }
+    template<typename T, std::size_t N>
+    MPI_Request MpiFile::IReadAt(MPI_Offset offset, std::span<T, N> buffer)
+    {
+      MPI_Request req;
+      MpiCall{MPI_File_iread_at}(*filePtr, offset, buffer.data(), buffer.size(), MpiDataType<T>(), &req);
+      return req;
+    }
+    template<typename T, std::size_t N>
+    MPI_Request MpiFile::IReadAtAll(MPI_Offset offset, std::span<T, N> buffer)
+    {
+      MPI_Request req;
+      MpiCall{MPI_File_iread_at_all}(*filePtr, offset, buffer.data(), buffer.size(), MpiDataType<T>(), &req);
+      return req;
+    }
 
     template<typename T, std::size_t N>
     void MpiFile::Write(std::span<T const, N> buffer, MPI_Status* stat)
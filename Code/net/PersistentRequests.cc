@@ -0,0 +1,65 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "net/PersistentRequests.h"
+
+namespace hemelb::net
+{
+    PersistentRequests::PersistentRequests(const MpiCommunicator& comms) :
+        communicator(comms)
+    {
+    }
+
+    PersistentRequests::~PersistentRequests()
+    {
+      int finalized;
+      MPI_Finalized(&finalized);
+      if (finalized)
+        return;
+
+      for (auto* requests: {&receives, &sends})
+        for (auto& req: *requests)
+          MPI_Request_free(&req);
+    }
+
+    void PersistentRequests::RequestSendDatatype(void const* pointer, int count, proc_t rank,
+                                                 MPI_Datatype type)
+    {
+      if (count > 0)
+      {
+        MPI_Request& req = sends.emplace_back(MPI_REQUEST_NULL);
+        MpiCall{MPI_Send_init}(pointer, count, type, rank, TAG, communicator, &req);
+      }
+    }
+
+    void PersistentRequests::RequestReceiveDatatype(void* pointer, int count, proc_t rank,
+                                                    MPI_Datatype type)
+    {
+      if (count > 0)
+      {
+        MPI_Request& req = receives.emplace_back(MPI_REQUEST_NULL);
+        MpiCall{MPI_Recv_init}(pointer, count, type, rank, TAG, communicator, &req);
+      }
+    }
+
+    void PersistentRequests::StartReceives()
+    {
+      if (!receives.empty())
+        MpiCall{MPI_Startall}((int) receives.size(), receives.data());
+    }
+
+    void PersistentRequests::StartSends()
+    {
+      if (!sends.empty())
+        MpiCall{MPI_Startall}((int) sends.size(), sends.data());
+    }
+
+    void PersistentRequests::Wait()
+    {
+      // The requests stay allocated, ready to be started again.
+      MpiCall{MPI_Waitall}((int) receives.size(), receives.data(), MPI_STATUSES_IGNORE);
+      MpiCall{MPI_Waitall}((int) sends.size(), sends.data(), MPI_STATUSES_IGNORE);
+    }
+}
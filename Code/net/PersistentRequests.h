@@ -0,0 +1,78 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_NET_PERSISTENTREQUESTS_H
+#define HEMELB_NET_PERSISTENTREQUESTS_H
+
+#include <vector>
+
+#include "constants.h"
+#include "net/mpi.h"
+
+namespace hemelb::net
+{
+    /**
+     * A set of point-to-point messages with the same buffers, counts,
+     * types and peers every time they are made (e.g. the LB halo
+     * exchange). Each is set up once, with MPI_Send_init/MPI_Recv_init,
+     * and then only restarted, which saves creating fresh requests (and,
+     * for the Coalesce implementation, datatypes) on every step.
+     *
+     * Describe the messages with the Request* functions, which mirror
+     * those of Net, then pass the set to BaseNet::RequestPersistent
+     * whenever it is needed: the Net starts the receives and the sends
+     * along with its own and completes them in Wait.
+     */
+    class PersistentRequests
+    {
+    public:
+        explicit PersistentRequests(const MpiCommunicator& comms);
+        ~PersistentRequests();
+
+        PersistentRequests(PersistentRequests const&) = delete;
+        PersistentRequests& operator=(PersistentRequests const&) = delete;
+
+        template<class T>
+        void RequestSend(T const* pointer, int count, proc_t rank)
+        {
+            RequestSendDatatype(pointer, count, rank, MpiDataType<T>());
+        }
+
+        template<class T>
+        void RequestReceive(T* pointer, int count, proc_t rank)
+        {
+            RequestReceiveDatatype(pointer, count, rank, MpiDataType<T>());
+        }
+
+        // One instance of a derived datatype, as for Net.
+        void RequestSendDatatype(void const* pointer, proc_t rank, MPI_Datatype type)
+        {
+            RequestSendDatatype(pointer, 1, rank, type);
+        }
+
+        void RequestReceiveDatatype(void* pointer, proc_t rank, MPI_Datatype type)
+        {
+            RequestReceiveDatatype(pointer, 1, rank, type);
+        }
+
+        void RequestSendDatatype(void const* pointer, int count, proc_t rank, MPI_Datatype type);
+        void RequestReceiveDatatype(void* pointer, int count, proc_t rank, MPI_Datatype type);
+
+        void StartReceives();
+        void StartSends();
+        void Wait();
+
+    private:
+        // Distinct from the tag of the stored point-to-point
+        // communication, so the two can never be matched to each other.
+        static constexpr int TAG = 11;
+
+        MpiCommunicator communicator;
+        std::vector<MPI_Request> receives;
+        std::vector<MPI_Request> sends;
+    };
+}
+
+#endif
@@ -137,6 +137,22 @@ namespace hemelb
           RequestReceiveImpl(pointer, count, rank, MpiDataType<T>());
         }
 
+        /***
+         * Send or receive one instance of a committed derived datatype
+         * (e.g. one that picks scattered elements out of an array),
+         * starting at pointer. The caller owns the datatype, which must
+         * outlive the communication.
+         */
+        void RequestSendDatatype(void const* pointer, proc_t rank, MPI_Datatype type)
+        {
+          RequestSendImpl(pointer, 1, rank, type);
+        }
+
+        void RequestReceiveDatatype(void* pointer, proc_t rank, MPI_Datatype type)
+        {
+          RequestReceiveImpl(pointer, 1, rank, type);
+        }
+
         /*
          * Blocking gathers are implemented in MPI as a single call for both send/receive
          * But, here we separate send and receive parts, since this interface may one day be used for
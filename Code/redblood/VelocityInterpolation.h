@@ -76,13 +76,14 @@ namespace hemelb::redblood
         distribn_t density;
         auto site = latticeData.GetSite(index);
         LatticeForceVector const &force(site.GetForce());
+        lb::FVector<LatticeType> fBuffer;
 #ifdef HEMELB_USE_KRUEGER_ORDERING
         // Use distribution functions at the beginning of the previous timestep (stored in
         // FNew after the swap at the end of the timestep) in the IBM velocity interpolation.
         // Follows approach in Timm's code
-        auto const fDistribution = latticeData.GetFNew<LatticeType>(index);
+        auto const fDistribution = latticeData.ReadFNew<LatticeType>(index, fBuffer);
 #else
-        auto const fDistribution = site.GetFOld<LatticeType>();
+        auto const fDistribution = site.template ReadFOld<LatticeType>(fBuffer);
 #endif
         LatticeType::CalculateDensityAndMomentum(fDistribution,
                                                  force,
@@ -98,13 +99,14 @@ namespace hemelb::redblood
         using LatticeType = typename KERNEL::LatticeType;
         LatticeMomentum mom;
         distribn_t density;
+        lb::FVector<LatticeType> fBuffer;
 #ifdef HEMELB_USE_KRUEGER_ORDERING
         // Use distribution functions at the beginning of the previous timestep (stored in
         // FNew after the swap at the end of the timestep) in the IBM velocity interpolation.
         // Follows approach in Timm's code
-        auto const fDistribution = latticeData.GetFNew<LatticeType>(index);
+        auto const fDistribution = latticeData.ReadFNew<LatticeType>(index, fBuffer);
 #else
-        auto const fDistribution = domainData.GetSite(index).template GetFOld<LatticeType>();
+        auto const fDistribution = latticeData.GetSite(index).template ReadFOld<LatticeType>(fBuffer);
 #endif
         LatticeType::CalculateDensityAndMomentum(fDistribution,
                                                  density,
@@ -14,6 +14,12 @@ namespace hemelb::reporting {
         build.SetValue("TYPE", build_info::BUILD_TYPE);
         build.SetValue("OPTIMISATION", build_info::OPTIMISATION);
         build.SetBoolValue("USE_SSE3", build_info::USE_SSE3);
+        build.SetBoolValue("USE_BATCHED_COLLISION", build_info::USE_BATCHED_COLLISION);
+        build.SetBoolValue("USE_FUSED_MRT", build_info::USE_FUSED_MRT);
+        build.SetBoolValue("USE_OPENMP", build_info::USE_OPENMP);
+        build.SetBoolValue("USE_INDEXED_HALO_RECEIVE", build_info::USE_INDEXED_HALO_RECEIVE);
+        build.SetBoolValue("USE_PERSISTENT_HALO_COMMS", build_info::USE_PERSISTENT_HALO_COMMS);
+        build.SetBoolValue("USE_COMPACT_STREAMING_INDICES", build_info::USE_COMPACT_STREAMING_INDICES);
         build.SetValue("TIME", build_info::BUILD_TIME);
         build.SetValue("LATTICE_TYPE", build_info::LATTICE);
         build.SetValue("KERNEL_TYPE", build_info::KERNEL);
@@ -25,5 +31,9 @@ namespace hemelb::reporting {
         build.SetValue("GATHERS_IMPLEMENTATION", build_info::GATHERS_IMPLEMENTATION);
         build.SetValue("POINTPOINT_IMPLEMENTATION", build_info::POINTPOINT_IMPLEMENTATION);
         build.SetValue("STENCIL", build_info::STENCIL);
+        build.SetValue("STREAMING_PATTERN", build_info::STREAMING_PATTERN);
+        build.SetValue("DISTRIBUTION_LAYOUT", build_info::DISTRIBUTION_LAYOUT);
+        build.SetValue("DISTRIBUTION_PRECISION", build_info::DISTRIBUTION_PRECISION);
+        build.SetValue("SITE_ORDERING", build_info::SITE_ORDERING);
     }
 }
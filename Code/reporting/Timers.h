@@ -6,7 +6,10 @@
 #ifndef HEMELB_REPORTING_TIMERS_H
 #define HEMELB_REPORTING_TIMERS_H
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
+#include "build_info.h"
 #include "reporting/Reportable.h"
 #include "util/utilityFunctions.h"
 #include "reporting/Policies.h"
@@ -138,9 +141,27 @@ namespace hemelb::reporting
          */
         static const std::string timerNames[TimersBase::numberOfTimers];
 
+        /**
+         * Events counted over the run, e.g. which code path a kernel took
+         */
+        enum CounterName
+        {
+          entropicAlphaAnalytic = 0, //!< Sites whose entropic alpha was the near-equilibrium approximation
+          entropicAlphaBrent, //!< Sites whose entropic alpha needed Brent's method
+          entropicAlphaNewtonRaphson, //!< Sites whose entropic alpha needed Newton-Raphson
+          lastCounter
+        //!< lastCounter, this has to be the last element of the enumeration so it can be used to track cardinality
+        };
+        static const unsigned int numberOfCounters = lastCounter;
+
+        /**
+         * String message label for each counter for reporting
+         */
+        static const std::string counterNames[TimersBase::numberOfCounters];
+
         TimersBase(const net::IOCommunicator& comms) :
             CommsPolicy(comms), timers(numberOfTimers), maxes(numberOfTimers), mins(numberOfTimers),
-                means(numberOfTimers)
+                means(numberOfTimers), counters(numberOfCounters), counterTotals(numberOfCounters)
         {
         }
         ~TimersBase() noexcept override = default;
@@ -208,10 +229,44 @@ namespace hemelb::reporting
         {
           return timers[t];
         }
+        /**
+         * Add to a counter. Safe to call from several OpenMP threads at once.
+         * @param c the counter name
+         * @param n the number of events to add
+         */
+        void AddToCounter(CounterName c, std::uint64_t n)
+        {
+          if constexpr (build_info::USE_OPENMP)
+            std::atomic_ref<std::uint64_t>(counters[c]).fetch_add(n, std::memory_order_relaxed);
+          else
+            counters[c] += n;
+        }
+        /**
+         * The value of a counter on this process
+         * @param c the counter name
+         * @return the number of events counted here
+         */
+        std::uint64_t GetCounter(CounterName c) const
+        {
+          return counters[c];
+        }
+        /**
+         * Sum across all processes.
+         * Following the sharing of counters between processes, the total of each counter.
+         * @return the total of each counter over all processes
+         */
+        const std::vector<std::uint64_t> &CounterTotals() const
+        {
+          return counterTotals;
+        }
         /**
          * Share timing information across timers
          */
         void Reduce();
+        /**
+         * Share counts across counters
+         */
+        void ReduceCounters();
 
         void Report(Dict& dictionary) override;
 
@@ -220,6 +275,8 @@ namespace hemelb::reporting
         std::vector<double> maxes; //! Max across processes
         std::vector<double> mins; //! Min across processes
         std::vector<double> means; //! Average across processes
+        std::vector<std::uint64_t> counters; //! The set of counters
+        std::vector<std::uint64_t> counterTotals; //! Sum across processes
     };
     using Timer = TimerBase<HemeLBClockPolicy>;
     using Timers = TimersBase<HemeLBClockPolicy, MPICommsPolicy>;
@@ -276,6 +333,15 @@ namespace hemelb::reporting
       "Notify cell listeners",
       "Create graph communicator"
     };
+
+    template<class ClockPolicy, class CommsPolicy>
+    const std::string TimersBase<ClockPolicy, CommsPolicy>::counterNames[TimersBase<ClockPolicy,
+        CommsPolicy>::numberOfCounters] =
+
+    { "Entropic alpha approximated near equilibrium",
+      "Entropic alpha by Brent's method",
+      "Entropic alpha by Newton-Raphson"
+    };
 }
 
 #endif //HEMELB_REPORTING_TIMERS_H
@@ -36,6 +36,13 @@ namespace hemelb
       }
     }
 
+    template<class ClockPolicy, class CommsPolicy>
+    void TimersBase<ClockPolicy, CommsPolicy>::ReduceCounters()
+    {
+      CommsPolicy::Reduce(&counters[0], &counterTotals[0], numberOfCounters,
+                          net::MpiDataType<std::uint64_t>(), MPI_SUM, 0);
+    }
+
     template<class ClockPolicy, class CommsPolicy>
     void TimersBase<ClockPolicy, CommsPolicy>::Report(Dict& dictionary)
     {
@@ -50,6 +57,14 @@ namespace hemelb
         timer.SetFormattedValue("MEAN", "%.3g", Means()[ii]);
         timer.SetFormattedValue("MAX", "%.3g", Maxes()[ii]);
       }
+
+      for (unsigned int ii = 0; ii < numberOfCounters; ii++)
+      {
+        Dict counter = dictionary.AddSectionDictionary("COUNTER");
+        counter.SetValue("NAME", counterNames[ii]);
+        counter.SetIntValue("LOCAL", counters[ii]);
+        counter.SetIntValue("TOTAL", counterTotals[ii]);
+      }
     }
 
   }
@@ -2,11 +2,14 @@
 // the HemeLB team and/or their institutions, as detailed in the
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
+#include <fstream>
+#include <iterator>
 #include <memory>
 
 #include <catch2/catch.hpp>
 
 #include "SimulationMaster.h"
+#include "TraitsRegistry.h"
 
 #include "tests/helpers/FolderTestFixture.h"
 #include "tests/helpers/LaddFail.h"
@@ -48,5 +51,51 @@ namespace hemelb
       }
     }
 
+    TEST_CASE_METHOD(helpers::FolderTestFixture, "TraitsRegistry") {
+      CopyResourceToTempdir("four_cube.xml");
+      CopyResourceToTempdir("four_cube.gmy");
+      auto options = hemelb::configuration::CommandLine{"hemelb", "-in", "four_cube.xml"};
+
+      // AoS works with any boundary conditions.
+      REQUIRE(GetTraitsVariant("AoS").usable);
+      REQUIRE_THROWS_AS(GetTraitsVariant("AoSoS"), Exception);
+
+      SECTION("Unknown variants are rejected") {
+        ModifyXMLInput("four_cube.xml", {"simulation", "variant", "value"}, "AoSoS");
+        REQUIRE_THROWS_AS(RunConfiguredSimulation(options, Comms()), Exception);
+      }
+
+      SECTION("Autotuning picks a usable variant and times it with the given options") {
+        LADD_FAIL();
+        fs::create_directory("trials");
+        auto const tuneOptions = options.WithOption("-decomposition_cache", "cache");
+        auto const name = AutotuneTraitsVariant(tuneOptions, Comms(), fs::absolute("trials"), 3);
+        REQUIRE(name != "default");
+        REQUIRE(GetTraitsVariant(name).usable);
+
+        // Each usable variant but the default had a trial of its own...
+        for (auto const& v: GetTraitsVariants())
+          REQUIRE(fs::exists(fs::path("trials") / v.name / "report.txt") == (v.usable && v.name != "default"));
+        // ...and they all shared one decomposition.
+        REQUIRE(std::distance(fs::directory_iterator("cache"), fs::directory_iterator{}) == 1);
+      }
+
+      SECTION("Autotuning runs the simulation once trials are done") {
+        LADD_FAIL();
+        ModifyXMLInput("four_cube.xml", {"simulation", "variant", "value"}, "autotune");
+        ModifyXMLInput("four_cube.xml", {"simulation", "autotune_steps", "value"}, 3);
+        ModifyXMLInput("four_cube.xml", {"simulation", "autotune_steps", "units"}, "lattice");
+        // A directory of the user's that happens to have the name
+        // autotuning would like.
+        fs::create_directory("results_autotune");
+        std::ofstream("results_autotune/mine.txt") << "keep me";
+
+        RunConfiguredSimulation(options, Comms());
+        REQUIRE(fs::exists("results/report.txt"));
+        REQUIRE(fs::exists("results_autotune/mine.txt"));
+        REQUIRE(!fs::exists("results_autotune1"));
+      }
+    }
+
   }
 }
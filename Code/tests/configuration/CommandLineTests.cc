@@ -30,6 +30,19 @@ namespace hemelb
       SECTION("Construct"){
 	auto options = std::make_unique<hemelb::configuration::CommandLine>(argc, argv);
 	REQUIRE(options != nullptr);
+	REQUIRE(!options->GetDecompositionCacheDir());
+      }
+
+      SECTION("WithOption"){
+	auto const options = hemelb::configuration::CommandLine(argc, argv).WithOption("-out", "elsewhere");
+	REQUIRE(options.GetInputFile() == configFile);
+	REQUIRE(options.GetOutputDir() == "elsewhere");
+
+	// Replaces rather than repeats a parameter.
+	auto const other = options.WithOption("-out", "there").WithOption("-decomposition_cache", "cache");
+	REQUIRE(other.GetOutputDir() == "there");
+	REQUIRE(other.GetDecompositionCacheDir() == "cache");
+	REQUIRE(other.ArgumentCount() == 7);
       }
     }
   }
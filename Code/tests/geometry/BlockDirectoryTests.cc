@@ -0,0 +1,48 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <vector>
+#include <catch2/catch.hpp>
+#include "tests/helpers/HasCommsTestFixture.h"
+
+#include "geometry/decomposition/BlockDirectory.h"
+
+namespace hemelb::tests
+{
+    using geometry::decomposition::BlockDirectory;
+
+    // Deal out more blocks than ranks, so each directory rank holds
+    // entries from several owners, and look them all up from every
+    // rank.
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "BlockDirectory - lookup", "[geometry]") {
+        auto const& comms = Comms();
+        auto const size = U64(comms.Size());
+        auto const rank = U64(comms.Rank());
+        U64 const nBlocks = 7 * size + 3;
+
+        std::vector<BlockDirectory::Entry> mine;
+        for (U64 b = rank; b < nBlocks; b += size)
+            mine.push_back({b, rank, 10 * b});
+        BlockDirectory directory(comms, nBlocks, mine);
+
+        // Ask in reverse order, and for one block twice.
+        std::vector<U64> wanted;
+        for (U64 b = nBlocks; b-- > 0;)
+            wanted.push_back(b);
+        wanted.push_back(1);
+
+        auto const found = directory.Lookup(wanted);
+        REQUIRE(found.size() == wanted.size());
+        for (std::size_t i = 0; i < wanted.size(); ++i) {
+            auto [block, owner, first] = found[i];
+            REQUIRE(block == wanted[i]);
+            REQUIRE(owner == wanted[i] % size);
+            REQUIRE(first == 10 * wanted[i]);
+        }
+
+        // Every rank must join a lookup, even one asking for nothing.
+        REQUIRE(directory.Lookup({}).empty());
+    }
+}
@@ -3,13 +3,20 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <array>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <zlib.h>
 
 #include <catch2/catch.hpp>
 
 #include "configuration/SimConfig.h"
 #include "geometry/Domain.h"
 #include "geometry/GeometryReader.h"
+#include "geometry/decomposition/DecompositionCache.h"
+#include "io/formats/geometry.h"
+#include "io/readers/XdrMemReader.h"
 #include "lb/lattices/D3Q15.h"
 #include "reporting/Timers.h"
 #include "resources/Resource.h"
@@ -19,6 +26,11 @@
 #include "tests/helpers/LaddFail.h"
 #include "tests/helpers/EqualitySiteData.h"
 
+// The geometry tool's writer
+#include "BlockWriter.h"
+#include "GenerationError.h"
+#include "GeometryWriter.h"
+
 namespace hemelb
 {
   namespace tests
@@ -75,6 +87,290 @@ namespace hemelb
 
       }
 
+      SECTION("ValidateGeometryByHash") {
+	auto readResult = reader->LoadAndDecompose(simConfig->GetDataFilePath());
+	auto totalProblems = [&]() {
+	  return Comms().AllReduce(reader->ValidateGeometryByHash(readResult), MPI_SUM);
+	};
+	REQUIRE(totalProblems() == 0);
+
+	// Disown every site, so none has an owner, and claim a solid one.
+	for (auto& block: readResult.Blocks)
+	  for (auto& site: block.Sites) {
+	    if (site.targetProcessor == Comms().Rank())
+	      site.targetProcessor = UNKNOWN_PROCESS;
+	  }
+	if (Comms().OnIORank())
+	  readResult.Blocks[0].Sites[0].targetProcessor = Comms().Rank();
+	// Four cube has 64 fluid sites, all in block 0; site 0 is solid.
+	REQUIRE(!readResult.Blocks[0].Sites[0].isFluid);
+	REQUIRE(totalProblems() == 65);
+      }
+
+      SECTION("TestDecompositionCache") {
+	auto const cacheDir = GetTempdir() / "decomposition_cache";
+	auto first = reader->LoadAndDecompose(simConfig->GetDataFilePath(), cacheDir);
+	REQUIRE(std::distance(std::filesystem::directory_iterator(cacheDir),
+			      std::filesystem::directory_iterator()) == 1);
+
+	// A fresh reader must find the cache and give the same answer.
+	geometry::GeometryReader secondReader(lb::D3Q15::GetLatticeInfo(), *timings, Comms());
+	auto second = secondReader.LoadAndDecompose(simConfig->GetDataFilePath(), cacheDir);
+	REQUIRE(first.Blocks.size() == second.Blocks.size());
+	for (std::size_t b = 0; b < first.Blocks.size(); ++b) {
+	  auto const& firstSites = first.Blocks[b].Sites;
+	  auto const& secondSites = second.Blocks[b].Sites;
+	  REQUIRE(firstSites.size() == secondSites.size());
+	  for (std::size_t i = 0; i < firstSites.size(); ++i)
+	    REQUIRE(firstSites[i].targetProcessor == secondSites[i].targetProcessor);
+	}
+      }
+
+    }
+
+    namespace
+    {
+      namespace fs = std::filesystem;
+      using gmy = io::formats::geometry;
+
+      // The checksums the reader makes of a GMY file's preamble and
+      // header (which give a decomposition cache its name) and of its
+      // block data.
+      std::pair<U64, U64> GmyChecksums(fs::path const& gmyPath)
+      {
+	std::vector<char> bytes(fs::file_size(gmyPath));
+	std::ifstream(gmyPath, std::ios::binary).read(bytes.data(), bytes.size());
+
+	io::XdrMemReader preamble(bytes.data(), gmy::PreambleLength);
+	std::uint32_t word, version, nBlocks = 1;
+	preamble.read(word);
+	preamble.read(word);
+	preamble.read(version);
+	for (int i = 0; i < 3; ++i) {
+	  preamble.read(word);
+	  nBlocks *= word;
+	}
+	std::size_t const headerBytes = gmy::PreambleLength + nBlocks
+	    * (version == gmy::VersionNumberV5 ? gmy::HeaderRecordLengthV5 : gmy::HeaderRecordLength);
+
+	auto checksum = [](char const* start, std::size_t n) -> U64 {
+	  return crc32(0, reinterpret_cast<const Bytef*>(start), n);
+	};
+	return {checksum(bytes.data(), headerBytes),
+		checksum(bytes.data() + headerBytes, bytes.size() - headerBytes)};
+      }
+
+      // The fluid sites of the four cube are 1 to 4 in each
+      // direction of its single, 6^3 site, block.
+      geometry::SiteVec FourCubeFluidSites()
+      {
+	geometry::SiteVec ans;
+	for (U64 i = 1; i < 5; ++i)
+	  for (U64 j = 1; j < 5; ++j)
+	    for (U64 k = 1; k < 5; ++k)
+	      ans.push_back({0, (i * 6 + j) * 6 + k});
+	return ans;
+      }
+
+      // Rewrite a version 4 GMY file as version 5, with the given
+      // codec, by decoding it and writing it back with the geometry
+      // tool's writer.
+      void WriteV5Copy(fs::path const& v4Path, fs::path const& v5Path, gmy::Codec codec)
+      {
+	std::vector<char> in(fs::file_size(v4Path));
+	std::ifstream(v4Path, std::ios::binary).read(in.data(), in.size());
+	io::XdrMemReader reader(in.data(), in.size());
+
+	std::uint32_t hlbMagic, gmyMagic, version, blockSize, padding;
+	std::array<std::uint32_t, 3> blockCounts;
+	reader.read(hlbMagic);
+	reader.read(gmyMagic);
+	reader.read(version);
+	REQUIRE(version == gmy::VersionNumber);
+	for (auto& n: blockCounts)
+	  reader.read(n);
+	reader.read(blockSize);
+	reader.read(padding);
+
+	auto const nBlocks = blockCounts[0] * blockCounts[1] * blockCounts[2];
+	std::vector<std::array<std::uint32_t, 3>> v4Header(nBlocks);
+	for (auto& record: v4Header)
+	  for (auto& x: record)
+	    reader.read(x);
+
+	GeometryWriter writer(v5Path.string(), blockSize,
+			      ::Index(blockCounts[0], blockCounts[1], blockCounts[2]),
+			      gmy::VersionNumberV5, codec);
+	std::size_t inPos = gmy::PreambleLength + nBlocks * gmy::HeaderRecordLength;
+	for (std::size_t b = 0; b < nBlocks; ++b) {
+	  auto [fluidSites, compressedBytes, uncompressedBytes] = v4Header[b];
+	  std::unique_ptr<BlockWriter> blockWriter(writer.StartNextBlock());
+	  if (compressedBytes != 0) {
+	    std::vector<char> xdr(uncompressedBytes);
+	    uLongf xdrLength = uncompressedBytes;
+	    REQUIRE(uncompress(reinterpret_cast<Bytef*>(xdr.data()), &xdrLength,
+			       reinterpret_cast<const Bytef*>(&in[inPos]), compressedBytes) == Z_OK);
+	    inPos += compressedBytes;
+
+	    io::XdrMemReader blockReader(xdr.data(), xdrLength);
+	    for (std::uint32_t site = 0; site < blockSize * blockSize * blockSize; ++site) {
+	      std::uint32_t siteType;
+	      blockReader.read(siteType);
+	      if (siteType == std::uint32_t(gmy::SiteType::SOLID)) {
+		blockWriter->WriteSolidSiteRecord();
+		continue;
+	      }
+	      std::vector<LinkData> links(gmy::NumberOfDisplacements);
+	      for (auto& link: links) {
+		std::uint32_t cutType;
+		blockReader.read(cutType);
+		link.Type = gmy::CutType(cutType);
+		if (link.Type == gmy::CutType::WALL) {
+		  blockReader.read(link.Distance);
+		} else if (link.Type != gmy::CutType::NONE) {
+		  blockReader.read(link.IoletId);
+		  blockReader.read(link.Distance);
+		}
+	      }
+	      std::uint32_t wallNormalAvailable;
+	      blockReader.read(wallNormalAvailable);
+	      ::Vector wallNormal(0.0);
+	      if (wallNormalAvailable == std::uint32_t(gmy::WallNormalAvailability::AVAILABLE))
+		for (int i = 0; i < 3; ++i) {
+		  float x;
+		  blockReader.read(x);
+		  wallNormal[i] = x;
+		}
+	      blockWriter->IncrementFluidSitesCount();
+	      blockWriter->WriteFluidSiteRecord(links,
+						wallNormalAvailable == std::uint32_t(gmy::WallNormalAvailability::AVAILABLE),
+						wallNormal);
+	    }
+	  }
+	  blockWriter->Finish();
+	  blockWriter->Write(writer);
+	}
+	writer.Close();
+      }
+
+      // Load the geometry with a hand-made decomposition cache giving
+      // the sites to rank 0, so needing neither ParMETIS nor the XML
+      // configuration.
+      geometry::GmyReadResult LoadFourCubeOnRankZero(fs::path const& gmyPath, fs::path const& cacheDir,
+						     net::IOCommunicator const& comms)
+      {
+	auto [headerChecksum, dataChecksum] = GmyChecksums(gmyPath);
+	auto const nVectors = lb::D3Q15::GetLatticeInfo().GetNumVectors();
+	geometry::decomposition::DecompositionCache cache(cacheDir, gmyPath, headerChecksum, nVectors, comms);
+	cache.Save(dataChecksum, comms.Rank() == 0 ? FourCubeFluidSites() : geometry::SiteVec{});
+
+	reporting::Timers timings(comms);
+	geometry::GeometryReader reader(lb::D3Q15::GetLatticeInfo(), timings, comms);
+	return reader.LoadAndDecompose(gmyPath, cacheDir);
+      }
+    }
+
+    // Uses a hand-made cache, so needs neither ParMETIS nor the XML
+    // configuration.
+    TEST_CASE_METHOD(helpers::FolderTestFixture, "DecompositionCacheTests") {
+      CopyResourceToTempdir("four_cube.gmy");
+      auto const gmyPath = GetTempdir() / "four_cube.gmy";
+      auto const cacheDir = GetTempdir() / "decomposition_cache";
+      auto const nVectors = lb::D3Q15::GetLatticeInfo().GetNumVectors();
+
+      auto [headerChecksum, dataChecksum] = GmyChecksums(gmyPath);
+      auto const allSites = FourCubeFluidSites();
+      auto const mySites = Comms().Rank() == 0 ? allSites : geometry::SiteVec{};
+
+      geometry::decomposition::DecompositionCache cache(cacheDir, gmyPath, headerChecksum, nVectors, Comms());
+
+      SECTION("Round trip") {
+	REQUIRE_FALSE(cache.Load());
+	cache.Save(dataChecksum, mySites);
+	REQUIRE(fs::exists(cache.GetPath()));
+
+	auto loaded = cache.Load();
+	REQUIRE(loaded);
+	REQUIRE(loaded->dataChecksum == dataChecksum);
+	REQUIRE(loaded->sites == mySites);
+
+	// Another lattice must not use it.
+	geometry::decomposition::DecompositionCache other(cacheDir, gmyPath, headerChecksum, nVectors + 4, Comms());
+	REQUIRE_FALSE(other.Load());
+      }
+
+      SECTION("Reader uses the cache") {
+	auto readResult = LoadFourCubeOnRankZero(gmyPath, cacheDir, Comms());
+
+	if (Comms().Rank() == 0) {
+	  for (auto [block, site]: allSites)
+	    REQUIRE(readResult.Blocks[block].Sites[site].targetProcessor == 0);
+	}
+      }
+    }
+
+    TEST_CASE_METHOD(helpers::FolderTestFixture, "GmyV5Tests") {
+      auto const codec = GENERATE(gmy::Codec::NONE, gmy::Codec::ZLIB);
+      CopyResourceToTempdir("four_cube.gmy");
+      auto const v4Path = GetTempdir() / "four_cube.gmy";
+      auto const v5Path = GetTempdir() / "four_cube_v5.gmy";
+      WriteV5Copy(v4Path, v5Path, codec);
+
+      // Every site of the block must be read the same.
+      auto requireSameSites = [](geometry::GmyReadResult const& v4, geometry::GmyReadResult const& v5) {
+	auto const& v4Sites = v4.Blocks[0].Sites;
+	auto const& v5Sites = v5.Blocks[0].Sites;
+	REQUIRE(v4Sites.size() == 216);
+	REQUIRE(v5Sites.size() == v4Sites.size());
+	for (std::size_t i = 0; i < v4Sites.size(); ++i) {
+	  REQUIRE(v5Sites[i].isFluid == v4Sites[i].isFluid);
+	  REQUIRE(v5Sites[i].targetProcessor == v4Sites[i].targetProcessor);
+	  if (!v4Sites[i].isFluid)
+	    continue;
+	  REQUIRE(v5Sites[i].wallNormalAvailable == v4Sites[i].wallNormalAvailable);
+	  if (v4Sites[i].wallNormalAvailable)
+	    REQUIRE(v5Sites[i].wallNormal == v4Sites[i].wallNormal);
+	  REQUIRE(v5Sites[i].links.size() == v4Sites[i].links.size());
+	  for (std::size_t l = 0; l < v4Sites[i].links.size(); ++l) {
+	    auto const& v4Link = v4Sites[i].links[l];
+	    auto const& v5Link = v5Sites[i].links[l];
+	    REQUIRE(v5Link.type == v4Link.type);
+	    REQUIRE(v5Link.ioletId == v4Link.ioletId);
+	    REQUIRE(v5Link.distanceToIntersection == v4Link.distanceToIntersection);
+	  }
+	}
+      };
+
+      SECTION("Streamed with a decomposition cache") {
+	// Checksumming the block data for the cache reads the whole file.
+	auto const v4 = LoadFourCubeOnRankZero(v4Path, GetTempdir() / "cache", Comms());
+	auto const v5 = LoadFourCubeOnRankZero(v5Path, GetTempdir() / "cache", Comms());
+	requireSameSites(v4, v5);
+      }
+
+      SECTION("Random access") {
+	// Otherwise only the blocks wanted are read, by their offsets.
+	LADD_FAIL();
+	reporting::Timers timings(Comms());
+	auto load = [&](fs::path const& gmyPath) {
+	  geometry::GeometryReader reader(lb::D3Q15::GetLatticeInfo(), timings, Comms());
+	  return reader.LoadAndDecompose(gmyPath);
+	};
+	auto const v4 = load(v4Path);
+	auto const v5 = load(v5Path);
+	requireSameSites(v4, v5);
+      }
+    }
+
+    // What the geometry tool's SetOutputFormat allows.
+    TEST_CASE("GmyWriterFormatTests") {
+      REQUIRE_NOTHROW(GeometryWriter::CheckFormat(gmy::VersionNumberV5, gmy::Codec::NONE));
+      REQUIRE_NOTHROW(GeometryWriter::CheckFormat(gmy::VersionNumberV5, gmy::Codec::ZLIB));
+      REQUIRE_NOTHROW(GeometryWriter::CheckFormat(gmy::VersionNumber, gmy::Codec::ZLIB));
+
+      REQUIRE_THROWS_AS(GeometryWriter::CheckFormat(gmy::VersionNumberV5, gmy::Codec(2)), GenerationErrorMessage);
+      REQUIRE_THROWS_AS(GeometryWriter::CheckFormat(gmy::VersionNumber, gmy::Codec::NONE), GenerationErrorMessage);
+      REQUIRE_THROWS_AS(GeometryWriter::CheckFormat(3, gmy::Codec::ZLIB), GenerationErrorMessage);
     }
   }
 }
@@ -3,11 +3,21 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
+#include "build_info.h"
 #include "geometry/Domain.h"
+#include "lb/HydroVars.h"
+#include "lb/lattices/D3Q15.h"
 
 #include "tests/helpers/FourCubeBasedTestFixture.h"
+#include "tests/helpers/FourCubeLatticeData.h"
+#include "tests/helpers/HasCommsTestFixture.h"
 
 namespace hemelb
 {
@@ -34,7 +44,108 @@ namespace hemelb
 	// situation to test this properly.
 	REQUIRE(dom->ProcProvidingSiteByGlobalNoncontiguousId(43) == 0);
       }
+
+      SECTION("TestReadDistributions") {
+	// However the distributions are stored and laid out, they are
+	// read back as distribn_t with only the rounding to the storage
+	// type.
+	auto const layout = GENERATE(DistributionLayout{},
+				     DistributionLayout{DistributionLayout::Kind::SoA},
+				     DistributionLayout{DistributionLayout::Kind::AoSoA, 4});
+	std::unique_ptr<FourCubeLatticeData> data{
+	  FourCubeLatticeData::Create(Comms(), 6, 1, StreamingPattern::AB, layout)
+	};
+
+	distribn_t fOld[lb::D3Q15::NUMVECTORS];
+	distribn_t other[lb::D3Q15::NUMVECTORS];
+	for (Direction i = 0; i < lb::D3Q15::NUMVECTORS; ++i) {
+	  fOld[i] = 0.1 + 1.0 / (i + 3);
+	  other[i] = -1.0;
+	}
+	// The next site's values must not be read in place of site 5's.
+	data->SetFOld<lb::D3Q15>(5, fOld);
+	data->SetFOld<lb::D3Q15>(6, other);
+
+	lb::FVector<lb::D3Q15> buffer;
+	auto const read = data->GetSite(5).ReadFOld<lb::D3Q15>(buffer);
+	for (Direction i = 0; i < lb::D3Q15::NUMVECTORS; ++i)
+	  REQUIRE(read[i] == distribn_t(distribn_storage_t(fOld[i])));
+	REQUIRE(data->GetSite(5).HasContiguousValues(lb::D3Q15::NUMVECTORS) == layout.IsSiteContiguous());
+
+	// Now they're the values from the previous step.
+	data->SwapOldAndNew();
+	auto const readNew = data->ReadFNew<lb::D3Q15>(5, buffer);
+	for (Direction i = 0; i < lb::D3Q15::NUMVECTORS; ++i)
+	  REQUIRE(readNew[i] == distribn_t(distribn_storage_t(fOld[i])));
+      }
+    }
+
+    // The streaming tables hold streaming_index_t, 32-bit offsets with
+    // HEMELB_USE_COMPACT_STREAMING_INDICES (CI also builds with it
+    // on). Streaming through them, or through 32-bit copies of the
+    // indices, must match streaming through 64-bit indices worked out
+    // from the geometry.
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "CompactStreamingIndicesTests") {
+      using Lattice = lb::D3Q15;
+      constexpr auto Q = Lattice::NUMVECTORS;
+
+      SECTION("Streaming matches the 64-bit path") {
+	auto const layout = GENERATE(DistributionLayout{},
+				     DistributionLayout{DistributionLayout::Kind::SoA},
+				     DistributionLayout{DistributionLayout::Kind::AoSoA, 4});
+	std::unique_ptr<FourCubeLatticeData> data{
+	  FourCubeLatticeData::Create(Comms(), 6, 1, StreamingPattern::AB, layout)
+	};
+	auto const& dom = data->GetDomain();
+	auto const nSites = dom.GetLocalFluidSiteCount();
+	// One rank, so everything off the four cube goes to the rubbish slot.
+	auto const rubbish = dom.GetDistributionLayout().GetStorageSize();
+	auto const distributionCount = rubbish + 1;
+	REQUIRE_NOTHROW(CheckStreamingIndexRange<std::uint32_t>(distributionCount, 0));
+
+	std::vector<site_t> wide(nSites * Q);
+	std::vector<std::uint32_t> compact(nSites * Q);
+	for (site_t i = 0; i < nSites; ++i) {
+	  for (Direction d = 0; d < Q; ++d) {
+	    auto const neigh = data->GetSite(i).GetGlobalSiteCoords() + Lattice::VECTORS[d].as<site_t>();
+	    auto& w = wide[i * Q + d];
+	    w = dom.IsValidLatticeSite(neigh) && dom.GetProcIdFromGlobalCoords(neigh) == 0 ?
+	      dom.GetDistributionIndex(dom.GetContiguousSiteId(neigh), d) :
+	      rubbish;
+	    compact[i * Q + d] = std::uint32_t(w);
+	    REQUIRE(site_t(data->GetSite(i).GetStreamedIndex<Lattice>(d)) == w);
+	  }
+	}
+
+	// Stream the same values each way.
+	std::vector<distribn_t> fOld(distributionCount);
+	for (site_t j = 0; j < distributionCount; ++j)
+	  fOld[j] = 1.0 / (j + 2);
+	auto stream = [&](auto&& streamedIndex) {
+	  std::vector<distribn_t> fNew(distributionCount, -1.0);
+	  for (site_t i = 0; i < nSites; ++i)
+	    for (Direction d = 0; d < Q; ++d)
+	      fNew[streamedIndex(i, d)] = fOld[dom.GetDistributionIndex(i, d)];
+	  return fNew;
+	};
+	auto const expected = stream([&](site_t i, Direction d) { return wide[i * Q + d]; });
+	REQUIRE(stream([&](site_t i, Direction d) { return compact[i * Q + d]; }) == expected);
+	REQUIRE(stream([&](site_t i, Direction d) {
+	  return data->GetSite(i).GetStreamedIndex<Lattice>(d);
+	}) == expected);
+      }
+
+      SECTION("Too many distributions for 32-bit indices") {
+	// Offsets run from 0 to the count less one.
+	constexpr site_t limit = site_t(std::numeric_limits<std::uint32_t>::max()) + 1;
+	REQUIRE_NOTHROW(CheckStreamingIndexRange<std::uint32_t>(limit, 0));
+	REQUIRE_THROWS_AS(CheckStreamingIndexRange<std::uint32_t>(limit + 1, 0), Exception);
+	REQUIRE_NOTHROW(CheckStreamingIndexRange<site_t>(limit + 1, 0));
+	if constexpr (build_info::USE_COMPACT_STREAMING_INDICES)
+	  REQUIRE_THROWS_AS(CheckStreamingIndexRange<streaming_index_t>(limit + 1, 0), Exception);
+	else
+	  REQUIRE_NOTHROW(CheckStreamingIndexRange<streaming_index_t>(limit + 1, 0));
+      }
     }
   }
 }
-
@@ -210,6 +210,30 @@ namespace hemelb::tests
         }
     }
 
+    TEST_CASE_METHOD(SimpleTreeFixture, "LookupTree - sites before each leaf", "[geometry]") {
+        // As in the builder test, but with a different number of
+        // fluid sites on each block.
+        std::vector<site_t> fluidSitesPerBlock(990);
+        int ijk = 0;
+        for (int i = 0; i < hi[0]; ++i)
+            for (int j = 0; j < hi[1]; ++j)
+                for (int k = 0; k < hi[2]; ++k) {
+                    fluidSitesPerBlock[ijk] = (i < lo[0] || j < lo[1] || k < lo[2]) ? 0 : 1 + (i + 2*j + 3*k) % 7;
+                    ++ijk;
+                }
+
+        LookupTree tree = build_block_tree(hi, fluidSitesPerBlock);
+        auto const& leaf_sites = tree.levels[tree.n_levels].sites_per_node;
+        REQUIRE(leaf_sites.size() == n_fluid_blocks);
+
+        U64 expected = 0;
+        for (std::size_t leaf = 0; leaf < leaf_sites.size(); ++leaf) {
+            REQUIRE(tree.GetSitesBefore(leaf) == expected);
+            expected += leaf_sites[leaf];
+        }
+        REQUIRE(expected == tree.levels[0].sites_per_node[0]);
+    }
+
     TEST_CASE_METHOD(helpers::FolderTestFixture, "LookupTree - build tree from GMY", "[geometry]") {
         // CopyResourceToTempdir("large_cylinder.xml");
         CopyResourceToTempdir("large_cylinder.gmy");
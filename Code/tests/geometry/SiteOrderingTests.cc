@@ -0,0 +1,105 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdlib>
+#include <map>
+
+#include <catch2/catch.hpp>
+
+#include "geometry/Domain.h"
+#include "geometry/LookupTree.h"
+#include "geometry/SiteOrdering.h"
+#include "lb/lattices/D3Q15.h"
+
+#include "tests/helpers/FourCubeLatticeData.h"
+#include "tests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb::tests
+{
+    using namespace geometry;
+    using Coords = util::Vector3D<site_t>;
+
+    TEST_CASE("SiteOrdering - curves", "[geometry]") {
+        // Order every site of a cube at the origin along each curve.
+        constexpr site_t N = 8;
+        std::map<std::uint64_t, Coords> morton, hilbert;
+        for (site_t x = 0; x < N; ++x)
+            for (site_t y = 0; y < N; ++y)
+                for (site_t z = 0; z < N; ++z) {
+                    morton[MortonIndex({x, y, z})] = {x, y, z};
+                    hilbert[HilbertIndex({x, y, z})] = {x, y, z};
+                }
+
+        SECTION("Both fill the cube before leaving it") {
+            REQUIRE(morton.size() == N * N * N);
+            REQUIRE(morton.rbegin()->first == N * N * N - 1);
+            REQUIRE(hilbert.size() == N * N * N);
+            REQUIRE(hilbert.rbegin()->first == N * N * N - 1);
+        }
+
+        SECTION("Morton matches the octree") {
+            for (auto const& [index, c]: morton)
+                REQUIRE(index == octree::ijk_to_oct(c.as<U16>()));
+        }
+
+        SECTION("Hilbert only steps to adjacent sites") {
+            auto prev = hilbert.begin();
+            for (auto it = std::next(prev); it != hilbert.end(); prev = it++) {
+                auto d = it->second - prev->second;
+                REQUIRE(std::abs(d.x()) + std::abs(d.y()) + std::abs(d.z()) == 1);
+            }
+        }
+
+        SECTION("Ties keep their order") {
+            std::vector<Coords> coords{{1, 0, 0}, {0, 0, 0}, {1, 0, 0}, {0, 0, 0}};
+            REQUIRE(OrderSites(coords, SiteOrdering::Blocks) == std::vector<site_t>{0, 1, 2, 3});
+            REQUIRE(OrderSites(coords, SiteOrdering::Hilbert) == std::vector<site_t>{1, 3, 0, 2});
+        }
+    }
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "SiteOrdering - domain", "[geometry]") {
+        // Renumbering the sites must only change their numbers: each
+        // collision type's range holds the same sites, which stream to
+        // the same places.
+        using LATTICE = lb::D3Q15;
+        auto ordering = GENERATE(SiteOrdering::Morton, SiteOrdering::Hilbert);
+        auto blocks = FourCubeDomain::Create(Comms(), 6, 1, DistributionLayout{}, SiteOrdering::Blocks);
+        auto other = FourCubeDomain::Create(Comms(), 6, 1, DistributionLayout{}, ordering);
+
+        REQUIRE(other->GetLocalFluidSiteCount() == blocks->GetLocalFluidSiteCount());
+        site_t first = 0;
+        bool reordered = false;
+        for (unsigned type = 0; type < COLLISION_TYPES; ++type) {
+            auto const count = other->GetMidDomainCollisionCount(type);
+            REQUIRE(count == blocks->GetMidDomainCollisionCount(type));
+            for (site_t i = first; i < first + count; ++i) {
+                auto const coords = other->GetSite(i).GetGlobalSiteCoords();
+                auto const j = blocks->GetContiguousSiteId(coords);
+                REQUIRE(j >= first);
+                REQUIRE(j < first + count);
+                reordered = reordered || i != j;
+            }
+            first += count;
+        }
+        REQUIRE(reordered);
+
+        auto const Q = LATTICE::NUMVECTORS;
+        auto const rubbish = other->GetDistributionLayout().GetStorageSize();
+        for (site_t i = 0; i < other->GetLocalFluidSiteCount(); ++i) {
+            auto const j = blocks->GetContiguousSiteId(other->GetSite(i).GetGlobalSiteCoords());
+            for (Direction d = 0; d < Q; ++d) {
+                auto const streamed = other->GetSite(i).GetStreamedIndex<LATTICE>(d);
+                auto const expected = blocks->GetSite(j).GetStreamedIndex<LATTICE>(d);
+                if (expected == rubbish) {
+                    REQUIRE(streamed == rubbish);
+                } else {
+                    REQUIRE(streamed % Q == expected % Q);
+                    REQUIRE(other->GetSite(streamed / Q).GetGlobalSiteCoords()
+                            == blocks->GetSite(expected / Q).GetGlobalSiteCoords());
+                }
+            }
+        }
+    }
+}
@@ -186,12 +186,14 @@ namespace hemelb
 
 	// It should arrive in the NeighbouringDataManager, from the values sent from the localFieldData
 
-	netMock.RequireSend(const_cast<distribn_t*> (exampleSite.GetFOld<lb::D3Q15>().data()),
+	auto const exampleFOld = exampleSite.GetFOld<lb::D3Q15>();
+	std::vector<distribn_storage_t> sentFOld(exampleFOld.begin(), exampleFOld.end());
+	netMock.RequireSend(&(sentFOld[0]),
 			    lb::D3Q15::NUMVECTORS,
 			    0,
 			    "IntersectionDataToSelf");
 
-	std::vector<distribn_t> receivedFOld(lb::D3Q15::NUMVECTORS, 53.0);
+	std::vector<distribn_storage_t> receivedFOld(lb::D3Q15::NUMVECTORS, 53.0);
 	netMock.RequireReceive(&(receivedFOld[0]),
 			       lb::D3Q15::NUMVECTORS,
 			       0,
@@ -206,6 +208,48 @@ namespace hemelb
 	}
       }
 
+      SECTION("TestShareFieldDataSoALayout") {
+	// When a site's distributions aren't adjacent in the local
+	// layout, they must still be sent in order of direction.
+	using Layout = geometry::DistributionLayout;
+	std::unique_ptr<FourCubeLatticeData> soaLatDat{
+	  FourCubeLatticeData::Create(Comms(), cubeSizeWithHalo, 1, geometry::StreamingPattern::AB,
+				      Layout{Layout::Kind::SoA})
+	};
+	auto soaData = soaLatDat->GetNeighbouringData();
+	auto soaManager = NeighbouringDataManager{*soaLatDat, soaData, netMock};
+
+	site_t targetGlobalOneDIdx = 43;
+	site_t targetLocalIdx = soaLatDat->GetDomain().GetLocalContiguousIdFromGlobalNoncontiguousId(targetGlobalOneDIdx);
+	std::vector<distribn_t> siteFOld(lb::D3Q15::NUMVECTORS);
+	for (unsigned int direction = 0; direction < lb::D3Q15::NUMVECTORS; direction++)
+	  siteFOld[direction] = 10.0 + direction;
+	soaLatDat->SetFOld<lb::D3Q15>(targetLocalIdx, siteFOld.data());
+
+	std::vector<int> countOfNeeds(1, 1);
+	netMock.RequireSend(&countOfNeeds.front(), 1, 0, "CountToSelf");
+	netMock.RequireReceive(&countOfNeeds.front(), 1, 0, "CountFromSelf");
+	std::vector<site_t> needs(1, targetGlobalOneDIdx);
+	netMock.RequireSend(&needs.front(), 1, 0, "NeedToSelf");
+	netMock.RequireReceive(&needs.front(), 1, 0, "NeedFromSelf");
+
+	soaManager.RegisterNeededSite(targetGlobalOneDIdx);
+	soaManager.ShareNeeds();
+	netMock.ExpectationsAllCompleted();
+
+	// They are sent as stored.
+	std::vector<distribn_storage_t> storedFOld(siteFOld.begin(), siteFOld.end());
+	netMock.RequireSend(&storedFOld[0], lb::D3Q15::NUMVECTORS, 0, "FOldToSelf");
+	netMock.RequireReceive(&storedFOld[0], lb::D3Q15::NUMVECTORS, 0, "FOldFromSelf");
+	soaManager.TransferFieldDependentInformation();
+	netMock.ExpectationsAllCompleted();
+
+	auto&& transferredSite = soaData.GetSite(targetGlobalOneDIdx);
+	for (unsigned int direction = 0; direction < lb::D3Q15::NUMVECTORS; direction++) {
+	  REQUIRE(storedFOld[direction] == transferredSite.GetFOld<lb::D3Q15> ()[direction]);
+	}
+      }
+
       SECTION("TestShareFieldDataOneProcViaIterableAction") {
 	site_t targetGlobalOneDIdx = 43;
 	site_t targetLocalIdx = dom->GetLocalContiguousIdFromGlobalNoncontiguousId(targetGlobalOneDIdx);
@@ -233,11 +277,13 @@ namespace hemelb
 	auto exampleSite = latDat->GetSite(targetLocalIdx);
 	// It should arrive in the NeighbouringDataManager, from the values sent from the localFieldData
 
-	netMock.RequireSend(const_cast<distribn_t*> (exampleSite.GetFOld<lb::D3Q15>().data()),
+	auto const exampleFOld = exampleSite.GetFOld<lb::D3Q15>();
+	std::vector<distribn_storage_t> sentFOld(exampleFOld.begin(), exampleFOld.end());
+	netMock.RequireSend(&(sentFOld[0]),
 			    lb::D3Q15::NUMVECTORS,
 			    0,
 			    "IntersectionDataToSelf");
-	std::vector<distribn_t> receivedFOld(lb::D3Q15::NUMVECTORS, 53.0);
+	std::vector<distribn_storage_t> receivedFOld(lb::D3Q15::NUMVECTORS, 53.0);
 	netMock.RequireReceive(&(receivedFOld[0]),
 			       lb::D3Q15::NUMVECTORS,
 			       0,
@@ -44,7 +44,7 @@ namespace hemelb
       }
 
       SECTION("TestInsertAndRetrieveDistributions") {
-	std::vector<distribn_t> distribution;
+	std::vector<distribn_storage_t> distribution;
 	for (unsigned int direction = 0; direction < lb::D3Q15::NUMVECTORS; direction++)
 	  {
 	    distribution.push_back(exampleSite.GetFOld<lb::D3Q15>()[direction]);
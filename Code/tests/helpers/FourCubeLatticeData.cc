@@ -50,7 +50,9 @@ namespace hemelb::tests
      *
      * @return
      */
-    std::shared_ptr<geometry::Domain> FourCubeDomain::Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit, proc_t rankCount)
+    std::shared_ptr<geometry::Domain> FourCubeDomain::Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit, proc_t rankCount,
+                                                             geometry::DistributionLayout layout,
+                                                             geometry::SiteOrdering ordering)
     {
         using namespace geometry;
         GmyReadResult readResult(Vec16::Ones(),
@@ -156,7 +158,9 @@ namespace hemelb::tests
         auto domain = std::make_shared<FourCubeDomain>(
                 lb::D3Q15::GetLatticeInfo(),
                 readResult,
-                comm
+                comm,
+                layout,
+                ordering
         );
 
       // First, fiddle with the fluid site count, for tests that require this set.
@@ -200,7 +204,11 @@ namespace hemelb::tests
       wallNormalAtSite[site] = boundaryNormal;
     }
 
-    FourCubeLatticeData* FourCubeLatticeData::Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit, proc_t rankCount) {
-      return new FourCubeLatticeData{FourCubeDomain::Create(comm, sitesPerBlockUnit, rankCount)};
+    FourCubeLatticeData* FourCubeLatticeData::Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit, proc_t rankCount,
+                                                     geometry::StreamingPattern pattern,
+                                                     geometry::DistributionLayout layout) {
+      return new FourCubeLatticeData{
+              geometry::FieldData{FourCubeDomain::Create(comm, sitesPerBlockUnit, rankCount, layout), pattern}
+      };
     }
 }
@@ -33,7 +33,9 @@ namespace hemelb::tests
         // The plane (x,y,0) is an inlet (boundary 0).
         // The plane (x,y,3) is an outlet (boundary 1).
         // The planes (0,y,z), (3,y,z), (x,0,z) and (x,3,z) are all walls.
-        static std::shared_ptr<geometry::Domain> Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit =6, proc_t rankCount =1);
+        static std::shared_ptr<geometry::Domain> Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit =6, proc_t rankCount =1,
+                                                        geometry::DistributionLayout layout = geometry::DistributionLayout{},
+                                                        geometry::SiteOrdering ordering = geometry::GetDefaultSiteOrdering());
 
         // Not used in setting up the four cube, but used in other tests
         // to poke changes into the four cube for those tests.
@@ -47,7 +49,9 @@ namespace hemelb::tests
     class FourCubeLatticeData : public geometry::FieldData
     {
       public:
-        static FourCubeLatticeData* Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit =6, proc_t rankCount =1);
+        static FourCubeLatticeData* Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit =6, proc_t rankCount =1,
+                                           geometry::StreamingPattern pattern = geometry::StreamingPattern::AB,
+                                           geometry::DistributionLayout layout = geometry::DistributionLayout{});
       // Used in unit tests for setting the fOld array, in a way that isn't possible in the main
       // part of the codebase.
       // @param site
@@ -56,7 +60,7 @@ namespace hemelb::tests
       void SetFOld(site_t site, distribn_t* fOldIn)
       {
 	for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction) {
-            *GetFOld(site * LatticeType::NUMVECTORS + direction) = fOldIn[direction];
+            *GetFOld(m_domain->GetDistributionIndex(site, direction)) = fOldIn[direction];
           }
         }
 
@@ -13,7 +13,7 @@ namespace hemelb::tests::helpers
     {
     }
 
-    distribn_t const * LatticeDataAccess::GetFNew(site_t index) const
+    distribn_storage_t const * LatticeDataAccess::GetFNew(site_t index) const
     {
         return latDat->GetFNew(index);
     }
@@ -34,7 +34,7 @@ namespace hemelb::tests::helpers
         }
     }
 
-    distribn_t const * GetFNew(geometry::FieldData& latDat, site_t const &index)
+    distribn_storage_t const * GetFNew(geometry::FieldData& latDat, site_t const &index)
     {
         return LatticeDataAccess(&latDat).GetFNew(index);
     }
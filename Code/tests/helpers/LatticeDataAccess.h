@@ -20,8 +20,8 @@ namespace hemelb::tests::helpers
 
     // FNew at given site
     template<class Lattice>
-    distribn_t const * GetFNew(geometry::FieldData& latDat, LatticeVector const &_pos);
-    distribn_t const * GetFNew(geometry::FieldData& latDat, site_t const &index);
+    distribn_storage_t const * GetFNew(geometry::FieldData& latDat, LatticeVector const &_pos);
+    distribn_storage_t const * GetFNew(geometry::FieldData& latDat, site_t const &index);
 
     // Population i set to some distribution
     template<class LATTICE>
@@ -47,15 +47,16 @@ namespace hemelb::tests::helpers
         template<class LATTICE>
         void SetFOld(LatticeVector const &_pos, site_t _dir, distribn_t _value) const;
 
-        // Get FNew for a given site and direction
+        // Get FNew for a given site (as stored, and so only indexable by
+        // direction with the AoS layout)
         template<class LATTICE>
-        distribn_t const * GetFNew(site_t _x, site_t _y, site_t _z) const
+        distribn_storage_t const * GetFNew(site_t _x, site_t _y, site_t _z) const
         {
             return GetFNew<LATTICE>(LatticeVector(_x, _y, _z));
         }
         template<class LATTICE>
-        distribn_t const * GetFNew(LatticeVector const &_pos) const;
-        distribn_t const * GetFNew(site_t index) const;
+        distribn_storage_t const * GetFNew(LatticeVector const &_pos) const;
+        distribn_storage_t const * GetFNew(site_t index) const;
 
         void SetMinWallDistance(PhysicalDistance _mindist);
         void SetWallDistance(PhysicalDistance _mindist);
@@ -85,26 +86,18 @@ namespace hemelb::tests::helpers
     void LatticeDataAccess::SetFOld(LatticeVector const &_pos, site_t _dir,
                                     distribn_t _value) const
     {
-        // Figure location of distribution in memory using const access to FOld.
-        // This way, access is resilient versus (some) changes in memory layout.
+        // Let the site find the distribution in memory, so this works
+        // with any layout.
         geometry::Site<geometry::FieldData> const site(latDat->GetSite(_pos));
-        auto siteFOld = site.GetFOld<LATTICE>();
-        distribn_t const * const firstFOld = &latDat->m_currentDistributions[0];
-        size_t const indexFOld(siteFOld.data() - firstFOld);
-        latDat->m_currentDistributions[indexFOld + _dir] = _value;
+        latDat->m_currentDistributions[site.GetDistributionIndex(_dir)] = _value;
     }
 
     template<class LATTICE>
-    distribn_t const *
+    distribn_storage_t const *
     LatticeDataAccess::GetFNew(LatticeVector const &_pos) const
     {
-        // Figure location of distribution in memory using const access to FOld.
-        // This way, access is resilient versus (some) changes in memory layout.
         auto site = latDat->GetSite(_pos);
-        auto siteFOld = site.GetFOld<LATTICE>();
-        distribn_t const * const firstFOld = &latDat->m_currentDistributions[0];
-        size_t const indexFOld = siteFOld.data() - firstFOld;
-        return latDat->GetFNew(indexFOld);
+        return latDat->GetFNew(site.GetDistributionIndex(0));
     }
 
     inline void ZeroOutFOld(geometry::FieldData* const latDat)
@@ -130,10 +123,8 @@ namespace hemelb::tests::helpers
             auto site = latDat->GetSite(i);
             LatticeVector const pos = site.GetGlobalSiteCoords();
             LatticePosition const pos_real(pos[0], pos[1], pos[2]);
-            distribn_t const * const siteFOld = site.GetFOld<LATTICE>().data();
-            distribn_t const * const firstFOld = &latDat->m_currentDistributions[0];
-            size_t const indexFOld(siteFOld - firstFOld);
-            latDat->m_nextDistributions[indexFOld + _i] = latDat->m_currentDistributions[indexFOld + _i] = _function(pos_real);
+            auto const index = site.GetDistributionIndex(_i);
+            latDat->m_nextDistributions[index] = latDat->m_currentDistributions[index] = _function(pos_real);
         }
     }
 
@@ -159,7 +150,7 @@ namespace hemelb::tests::helpers
     }
 
     template<class LATTICE>
-    distribn_t const * GetFNew(geometry::FieldData& latDat, LatticeVector const &_pos)
+    distribn_storage_t const * GetFNew(geometry::FieldData& latDat, LatticeVector const &_pos)
     {
         return LatticeDataAccess(&latDat).GetFNew<LATTICE>(_pos);
     }
@@ -319,8 +319,10 @@ namespace hemelb::tests
             // Will compare zero and non-zero forces, to make sure they are different
             // Assumes collides works, since tested in TestDoCollide
             LatticeType::FArray withForce, withoutForce;
-            FPostCollision(site.GetFOld<LatticeType>(), site.GetForce(), withForce);
-            FPostCollision(site.GetFOld<LatticeType>(), LatticeForceVector(0, 0, 0), withoutForce);
+            lb::FVector<LatticeType> buffer;
+            auto const fOld = site.template ReadFOld<LatticeType>(buffer);
+            FPostCollision(fOld, site.GetForce(), withForce);
+            FPostCollision(fOld, LatticeForceVector(0, 0, 0), withoutForce);
 
             // Stream that site
             using lb::BulkStreamer;
@@ -348,8 +350,10 @@ namespace hemelb::tests
             // Will compare zero and non-zero forces, to make sure they are different
             // Assumes collides works, since tested in TestDoCollide
             distribn_t withForce[LatticeType::NUMVECTORS], withoutForce[LatticeType::NUMVECTORS];
-            FPostCollision(site.GetFOld<LatticeType>(), site.GetForce(), withForce);
-            FPostCollision(site.GetFOld<LatticeType>(), LatticeForceVector(0, 0, 0), withoutForce);
+            lb::FVector<LatticeType> buffer;
+            auto const fOld = site.template ReadFOld<LatticeType>(buffer);
+            FPostCollision(fOld, site.GetForce(), withForce);
+            FPostCollision(fOld, LatticeForceVector(0, 0, 0), withoutForce);
 
             // Stream that site
             using SBB = lb::StreamerTypeFactory<
@@ -359,7 +363,7 @@ namespace hemelb::tests
             SBB streamer(initParams);
             streamer.StreamAndCollide(site.GetIndex(), 1, &lbmParams, *latDat, *propertyCache);
 
-            distribn_t const * const actual = helpers::GetFNew<LatticeType>(*latDat, position);
+            distribn_storage_t const * const actual = helpers::GetFNew<LatticeType>(*latDat, position);
             bool paranoia(false);
             for (size_t i(0); i < LatticeType::NUMVECTORS; ++i) {
                 if (not site.HasWall(i))
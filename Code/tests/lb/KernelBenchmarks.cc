@@ -0,0 +1,172 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "lb/Kernels.h"
+#include "lb/lattices/D3Q19.h"
+#include "lb/lattices/D3Q27.h"
+#include "lb/kernels/DHumieresD3Q15MRTBasis.h"
+#include "lb/kernels/DHumieresD3Q19MRTBasis.h"
+#include "lb/streamers/BatchedCollision.h"
+#include "log/Logger.h"
+
+#include "tests/helpers/FourCubeBasedTestFixture.h"
+
+namespace hemelb::tests
+{
+    // Timings of the lattice and collision kernels alone, on sites
+    // held in memory. These are hidden; run them with the
+    // kernel-benchmarks target or `hemelb-tests [benchmark]` (in a
+    // release build).
+    namespace {
+        constexpr site_t BENCHMARK_SITES = 1 << 14;
+        constexpr unsigned BENCHMARK_REPEATS = 50;
+
+        template <typename F>
+        double MeasureMlups(F&& updateAllSites) {
+            updateAllSites(); // warm up
+            auto const start = std::chrono::steady_clock::now();
+            for (unsigned r = 0; r < BENCHMARK_REPEATS; ++r)
+                updateAllSites();
+            std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+            return double(BENCHMARK_SITES) * BENCHMARK_REPEATS / elapsed.count() / 1e6;
+        }
+
+        // Distributions a little off equilibrium, different at each site.
+        template <typename LATTICE>
+        std::vector<distribn_t> MakeBenchmarkDistributions() {
+            constexpr auto Q = LATTICE::NUMVECTORS;
+            std::vector<distribn_t> f(BENCHMARK_SITES * Q);
+            for (site_t n = 0; n < BENCHMARK_SITES; ++n)
+                for (Direction i = 0; i < Q; ++i)
+                    f[n * Q + i] = LATTICE::EQMWEIGHTS[i] * (1.0 + 0.01 * std::sin(n + 0.1 * i));
+            return f;
+        }
+
+        template <typename BASIS>
+        void BenchmarkMRT(const char* name, lb::InitParams& initParams, const lb::LbmParameters& lbmParams) {
+            using LATTICE = typename BASIS::Lattice;
+            using KERNEL = lb::MRT<BASIS>;
+            using HYDRO = lb::HydroVars<KERNEL>;
+            constexpr auto Q = LATTICE::NUMVECTORS;
+
+            KERNEL kernel(initParams);
+            auto const f = MakeBenchmarkDistributions<LATTICE>();
+            std::vector<distribn_t> fMoment(f.size()), fFused(f.size());
+
+            auto siteBySite = [&](auto collide, std::vector<distribn_t>& fPost) {
+                return [&, collide]() {
+                    for (site_t n = 0; n < BENCHMARK_SITES; ++n) {
+                        HYDRO hydroVars(&f[n * Q]);
+                        kernel.CalculateDensityMomentumFeq(hydroVars, n);
+                        (kernel.*collide)(hydroVars);
+                        auto const& post = hydroVars.GetFPostCollision();
+                        std::copy(post.begin(), post.end(), &fPost[n * Q]);
+                    }
+                };
+            };
+            double const momentMlups = MeasureMlups(siteBySite(&KERNEL::CollideInMomentSpace, fMoment));
+            double const fusedMlups = MeasureMlups(siteBySite(&KERNEL::CollideFused, fFused));
+            log::Logger::Log<log::Info, log::Singleton>("%s MRT: moment space %.1f MLUPS, fused %.1f MLUPS",
+                                                        name, momentMlups, fusedMlups);
+
+#if __has_include(<experimental/simd>)
+            using V = lb::SiteBatch;
+            constexpr site_t W = V::size();
+            std::vector<distribn_t> fBatched(f.size());
+            double const batchedMlups = MeasureMlups([&]() {
+                std::array<V, Q> fIn, f_eq, fPost;
+                alignas(std::experimental::memory_alignment_v<V>) distribn_t lanes[W];
+                for (site_t first = 0; first < BENCHMARK_SITES; first += W) {
+                    for (Direction i = 0; i < Q; ++i) {
+                        for (site_t k = 0; k < W; ++k)
+                            lanes[k] = f[(first + k) * Q + i];
+                        fIn[i].copy_from(lanes, std::experimental::vector_aligned);
+                    }
+                    V density, momentum_x, momentum_y, momentum_z;
+                    LATTICE::BatchCalculateDensityMomentumFEq(fIn, density, momentum_x, momentum_y, momentum_z, f_eq);
+                    kernel.CollideBatch(&lbmParams, fIn, f_eq, fPost);
+                    for (Direction i = 0; i < Q; ++i) {
+                        fPost[i].copy_to(lanes, std::experimental::vector_aligned);
+                        for (site_t k = 0; k < W; ++k)
+                            fBatched[(first + k) * Q + i] = lanes[k];
+                    }
+                }
+            });
+            log::Logger::Log<log::Info, log::Singleton>("%s MRT: fused, %d sites per batch %.1f MLUPS",
+                                                        name, int(W), batchedMlups);
+#endif
+
+            // Check they all did the same work.
+            for (std::size_t j = 0; j < f.size(); ++j) {
+                REQUIRE(Approx(fMoment[j]).margin(1e-12) == fFused[j]);
+#if __has_include(<experimental/simd>)
+                REQUIRE(Approx(fMoment[j]).margin(1e-12) == fBatched[j]);
+#endif
+            }
+        }
+
+        // The time per site to find the density, momentum and f_eq
+        // alone and then to collide with each of the kernels.
+        template <typename LATTICE>
+        void BenchmarkLattice(const char* name, lb::InitParams& initParams, const lb::LbmParameters& lbmParams,
+                              site_t numSites) {
+            constexpr auto Q = LATTICE::NUMVECTORS;
+            auto const f = MakeBenchmarkDistributions<LATTICE>();
+            std::vector<distribn_t> f_eq(f.size());
+
+            double const equilibriumMlups = MeasureMlups([&]() {
+                for (site_t n = 0; n < BENCHMARK_SITES; ++n) {
+                    distribn_t density;
+                    LatticeMomentum momentum;
+                    LATTICE::CalculateDensityAndMomentum(typename LATTICE::const_span(&f[n * Q], Q), density, momentum);
+                    LATTICE::CalculateFeq(density, momentum, typename LATTICE::mut_span(&f_eq[n * Q], Q));
+                }
+            });
+            log::Logger::Log<log::Info, log::Singleton>("%s density, momentum and f_eq: %.1f ns/site",
+                                                        name, 1e3 / equilibriumMlups);
+
+            auto collide = [&]<typename KERNEL>(const char* kernelName) {
+                KERNEL kernel(initParams);
+                distribn_t checksum = 0.0;
+                double const mlups = MeasureMlups([&]() {
+                    for (site_t n = 0; n < BENCHMARK_SITES; ++n) {
+                        lb::HydroVars<KERNEL> hydroVars(&f[n * Q]);
+                        // Some kernels keep state per site of the domain.
+                        kernel.CalculateDensityMomentumFeq(hydroVars, n % numSites);
+                        kernel.Collide(&lbmParams, hydroVars);
+                        checksum += hydroVars.GetFPostCollision()[0];
+                    }
+                });
+                log::Logger::Log<log::Info, log::Singleton>("%s %s: %.1f ns/site", name, kernelName, 1e3 / mlups);
+                REQUIRE(std::isfinite(checksum));
+            };
+            collide.template operator()<lb::LBGK<LATTICE>>("LBGK");
+            collide.template operator()<lb::TRT<LATTICE>>("TRT");
+            collide.template operator()<lb::EntropicAnsumali<LATTICE>>("EntropicAnsumali");
+            collide.template operator()<lb::EntropicChik<LATTICE>>("EntropicChik");
+            if constexpr (std::is_same_v<LATTICE, lb::D3Q15>)
+                collide.template operator()<lb::MRT<lb::DHumieresD3Q15MRTBasis>>("MRT");
+            if constexpr (std::is_same_v<LATTICE, lb::D3Q19>)
+                collide.template operator()<lb::MRT<lb::DHumieresD3Q19MRTBasis>>("MRT");
+        }
+    }
+
+    TEST_CASE_METHOD(helpers::FourCubeBasedTestFixture<>, "Lattice and kernel cost per site", "[.][benchmark]") {
+        BenchmarkLattice<lb::D3Q15>("D3Q15", initParams, lbmParams, numSites);
+        BenchmarkLattice<lb::D3Q19>("D3Q19", initParams, lbmParams, numSites);
+        BenchmarkLattice<lb::D3Q27>("D3Q27", initParams, lbmParams, numSites);
+    }
+
+    TEST_CASE_METHOD(helpers::FourCubeBasedTestFixture<>, "MRT collision throughput", "[.][benchmark]") {
+        BenchmarkMRT<lb::DHumieresD3Q15MRTBasis>("D3Q15", initParams, lbmParams);
+        BenchmarkMRT<lb::DHumieresD3Q19MRTBasis>("D3Q19", initParams, lbmParams);
+    }
+}
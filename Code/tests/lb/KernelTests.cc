@@ -4,6 +4,9 @@
 // license in the file LICENSE.
 
 #include <sstream>
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#endif
 
 #include "lb/Kernels.h"
 #include "lb/kernels/RheologyModels.h"
@@ -142,6 +145,98 @@ namespace hemelb::tests
       }
     }
 
+    TEMPLATE_TEST_CASE_METHOD(CollisionTester, "KernelTests - entropic alpha approximation and batched collision", "[lb][kernels]",
+                              lb::EntropicAnsumali<lb::D3Q15>,
+                              lb::EntropicChik<lb::D3Q15>) {
+        using Fix = CollisionTester<TestType>;
+        using LATTICE = typename Fix::LATTICE;
+        constexpr auto NV = Fix::NV;
+
+        // Near equilibrium, alpha comes from its series about 2 rather
+        // than solving H(f_alpha) = H(f), to well within the tolerance
+        // of the solvers.
+        typename Fix::DISTS f_near;
+        for (unsigned int ii = 0; ii < NV; ++ii)
+            f_near[ii] = LATTICE::EQMWEIGHTS[ii] * (1.0 + 2.0e-4 * std::sin(ii + 1.0));
+
+        SECTION("close to equilibrium, alpha is approximated") {
+            typename Fix::HYDRO hydroVars(f_near);
+            this->kernel.CalculateDensityMomentumFeq(hydroVars, 0);
+            for (unsigned int ii = 0; ii < NV; ++ii)
+                REQUIRE(std::abs(hydroVars.GetFEq()[ii] - f_near[ii]) / f_near[ii] <= TestType::APPROXIMATION_DEVIATION);
+            this->kernel.Collide(&this->lbmParams, hydroVars);
+
+            typename Fix::DISTS expected;
+            LbTestsHelper::CalculateEntropicCollision<LATTICE>(f_near, hydroVars.GetFEq(),
+                                                               this->lbmParams.GetTau(), this->lbmParams.GetBeta(),
+                                                               expected);
+            for (unsigned int ii = 0; ii < NV; ++ii)
+                REQUIRE(Approx(expected[ii]).margin(this->allowedError) == hydroVars.GetFPostCollision()[ii]);
+        }
+
+        SECTION("how alpha was found is counted when the range is finished") {
+            using Timers = reporting::Timers;
+            // Drop anything this thread has left uncounted (the fixture's
+            // kernel has no timers).
+            this->kernel.FinishRange();
+
+            Timers timings(this->Comms());
+            this->initParams.timings = &timings;
+            TestType counting(this->initParams);
+
+            typename Fix::HYDRO nearVars(f_near);
+            counting.CalculateDensityMomentumFeq(nearVars, 0);
+            counting.Collide(&this->lbmParams, nearVars);
+            typename Fix::HYDRO farVars(this->f_original);
+            counting.CalculateDensityMomentumFeq(farVars, 1);
+            counting.Collide(&this->lbmParams, farVars);
+            REQUIRE(timings.GetCounter(Timers::entropicAlphaAnalytic) == 0);
+            REQUIRE(timings.GetCounter(Timers::entropicAlphaNewtonRaphson) == 0);
+
+            counting.FinishRange();
+            REQUIRE(timings.GetCounter(Timers::entropicAlphaAnalytic) == 1);
+            REQUIRE(timings.GetCounter(Timers::entropicAlphaNewtonRaphson) == 1);
+            REQUIRE(timings.GetCounter(Timers::entropicAlphaBrent) == 0);
+        }
+
+#if __has_include(<experimental/simd>)
+        SECTION("colliding a batch of sites matches colliding them one at a time") {
+            using V = std::experimental::fixed_size_simd<distribn_t, 4>;
+            constexpr std::size_t W = V::size();
+
+            // One site for each way alpha can be found: approximated,
+            // Brent's method and Newton-Raphson (twice).
+            typename Fix::DISTS sites[W];
+            for (unsigned int ii = 0; ii < NV; ++ii)
+            {
+                sites[0][ii] = f_near[ii];
+                sites[1][ii] = LATTICE::EQMWEIGHTS[ii] * (1.0 + 5.0e-3 * std::cos(ii + 1.0));
+                sites[2][ii] = this->f_original[ii];
+                sites[3][ii] = (NV - ii) / 10.0;
+            }
+
+            std::array<V, NV> f, f_eq, fPost;
+            for (unsigned int ii = 0; ii < NV; ++ii)
+                for (std::size_t k = 0; k < W; ++k)
+                    f[ii][k] = sites[k][ii];
+            V density, momentum_x, momentum_y, momentum_z;
+            LATTICE::BatchCalculateDensityMomentumFEq(f, density, momentum_x, momentum_y, momentum_z, f_eq);
+
+            TestType batched(this->initParams);
+            batched.CollideBatch(&this->lbmParams, 0, density, momentum_x, momentum_y, momentum_z, f, f_eq, fPost);
+
+            for (std::size_t k = 0; k < W; ++k)
+            {
+                typename Fix::HYDRO hydroVars(sites[k]);
+                this->kernel.CalculateDensityMomentumFeq(hydroVars, k);
+                this->kernel.Collide(&this->lbmParams, hydroVars);
+                for (unsigned int ii = 0; ii < NV; ++ii)
+                    REQUIRE(Approx(hydroVars.GetFPostCollision()[ii]).margin(this->allowedError) == fPost[ii][k]);
+            }
+        }
+#endif
+    }
+
     TEST_CASE_METHOD(helpers::FourCubeBasedTestFixture<>, "LBGKNNCalculationsAndCollision") {
       using LATTICE = lb::D3Q15;
       static constexpr auto NV = LATTICE::NUMVECTORS;
@@ -293,6 +388,16 @@ namespace hemelb::tests
       }
     }
 
+    TEST_CASE_METHOD(helpers::FourCubeBasedTestFixture<>, "LBGKNN kernels share their rheology table") {
+      // Only the first kernel for each model tabulates it; the
+      // kernels for the other site types reuse that table.
+      lbmParams.RheologyTableTolerance = 1e-6;
+      lb::LBGKNN<lb::CarreauYasudaRheologyModelHumanFit, lb::D3Q15> bulk(initParams), wall(initParams);
+      REQUIRE(initParams.rheologyTables.size() == 1);
+      lb::LBGKNN<lb::CassonRheologyModel, lb::D3Q15> other(initParams);
+      REQUIRE(initParams.rheologyTables.size() == 2);
+    }
+
     template <typename L, typename B>
     struct MRTTestFixture : public helpers::FourCubeBasedTestFixture<> {
         using LATTICE = L;
@@ -353,6 +458,26 @@ namespace hemelb::tests
             for (unsigned int ii = 0; ii < NV; ++ii) {
                 REQUIRE(Approx(expectedPostCollision0[ii]).margin(allowedError) == hydroVars0.GetFPostCollision()[ii]);
             }
+
+            // With the usual, different, relaxation parameters, the
+            // fused operator must give the same as going through
+            // moment space, whether for one site or a batch.
+            KERNEL mrtKernel(initParams);
+            HYDRO hydroVars1(f_original);
+            mrtKernel.CalculateDensityMomentumFeq(hydroVars1, 0);
+            HYDRO hydroVars2(hydroVars1);
+            mrtKernel.CollideInMomentSpace(hydroVars1);
+            mrtKernel.CollideFused(hydroVars2);
+
+            std::array<distribn_t, NV> f, f_eq, fPostBatch;
+            std::copy(f_original, f_original + NV, f.begin());
+            std::copy(hydroVars1.GetFEq().begin(), hydroVars1.GetFEq().end(), f_eq.begin());
+            mrtKernel.CollideBatch(&lbmParams, f, f_eq, fPostBatch);
+
+            for (unsigned int ii = 0; ii < NV; ++ii) {
+                REQUIRE(Approx(hydroVars1.GetFPostCollision()[ii]).margin(allowedError) == hydroVars2.GetFPostCollision()[ii]);
+                REQUIRE(Approx(hydroVars1.GetFPostCollision()[ii]).margin(allowedError) == fPostBatch[ii]);
+            }
         }
     };
 
@@ -78,6 +78,27 @@ namespace hemelb::tests
 	  REQUIRE(direction == LatticeType::INVERSEDIRECTIONS[inverse]);
 	}
 
+      /*
+	static constexpr DirectionPairs PAIRS;
+
+	Require that every direction is either the rest vector or in exactly one pair with its inverse
+      */
+      {
+	std::array<int, LatticeType::NUMVECTORS> seen{};
+	if (LatticeType::PAIRS.rest < LatticeType::NUMVECTORS)
+	  seen[LatticeType::PAIRS.rest]++;
+	for (std::size_t p = 0; p < LatticeType::NUMVECTORS / 2; ++p)
+	  {
+	    auto const i = LatticeType::PAIRS.first[p];
+	    auto const j = LatticeType::PAIRS.second[p];
+	    REQUIRE(j == LatticeType::INVERSEDIRECTIONS[i]);
+	    seen[i]++;
+	    seen[j]++;
+	  }
+	for (auto const n: seen)
+	  REQUIRE(n == 1);
+      }
+
       /*
 	static void CalculateDensityAndMomentum(const distribn_t f[],
 	distribn_t &density,
@@ -14,6 +14,7 @@
 #include "constants.h"
 #include "lb/concepts.h"
 #include "lb/HFunction.h"
+#include "lb/HydroVars.h"
 #include "lb/MacroscopicPropertyCache.h"
 #include "lb/lattices/D3Q15.h"
 
@@ -202,8 +203,9 @@ namespace hemelb::tests::LbTestsHelper
             distribn_t density, feq[Lattice::NUMVECTORS];
             util::Vector3D<distribn_t> momentum;
             util::Vector3D<distribn_t> velocity;
+            lb::FVector<Lattice> fOld;
 
-            Lattice::CalculateDensityMomentumFEq(latDat.GetSite(site).GetFOld<Lattice> (),
+            Lattice::CalculateDensityMomentumFEq(latDat.GetSite(site).template ReadFOld<Lattice> (fOld),
                                                  density,
                                                  momentum,
                                                  velocity,
@@ -6,6 +6,7 @@
 
 #include <catch2/catch.hpp>
 #include "lb/kernels/RheologyModels.h"
+#include "lb/kernels/RheologyTable.h"
 #include "lb/LbmParameters.h"
 
 namespace hemelb
@@ -79,6 +80,45 @@ namespace hemelb
 					  "TruncatedPowerLaw");
       }
     }
+
+    // Check a tabulated model is within tolerance of the model over
+    // many orders of magnitude of shear rate, in and out of the table.
+    template<class RHEO>
+    void CompareTableAgainstModel(RHEO const& rheo, const lb::LbmParameters& lbp, const std::string& modelName) {
+      const double tolerance = 1e-6;
+      auto tau = [&](PhysicalRate shearRate) {
+	return rheo.CalculateTauForShearRate(shearRate, 1.0, lbp);
+      };
+      RheologyTable table(tau, tolerance);
+      REQUIRE(table.GetBits() <= RheologyTable::MAX_BITS);
+
+      for (double logRate = -8.0; logRate < 9.0; logRate += 1.0 / 1024.0) {
+	const PhysicalRate shearRate = std::pow(10.0, logRate);
+	const auto expected = tau(shearRate);
+	const auto actual = table.Evaluate(shearRate, tau);
+	INFO(modelName << " tabulated tau wrong for shear rate " << shearRate);
+	if (shearRate < RheologyTable::MIN_SHEAR_RATE || shearRate >= RheologyTable::MAX_SHEAR_RATE)
+	  REQUIRE(actual == expected);
+	else
+	  REQUIRE(std::abs(actual - expected) <= 2.0 * tolerance * (expected - 0.5));
+      }
+    }
+
+    TEST_CASE("RheologyTableTests") {
+      const lb::LbmParameters lbp{1e-5, 1e-4, DEFAULT_FLUID_DENSITY_Kg_per_m3, 0.004};
+      lb::InitParams ip;
+      ip.lbmParams = &lbp;
+
+      SECTION("CarreauYasuda") {
+	CompareTableAgainstModel(CarreauYasudaRheologyModelHumanFit{ip}, lbp, "CarreauYasuda");
+	CompareTableAgainstModel(CarreauYasudaRheologyModelMouseFit{ip}, lbp, "CarreauYasudaMouse");
+      }
+      SECTION("Casson") {
+	CompareTableAgainstModel(CassonRheologyModel{ip}, lbp, "Casson");
+      }
+      SECTION("TruncatedPowerLaw") {
+	CompareTableAgainstModel(TruncatedPowerLawRheologyModel{ip}, lbp, "TruncatedPowerLaw");
+      }
+    }
   }
 }
-
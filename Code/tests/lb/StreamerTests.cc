@@ -3,6 +3,7 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <cmath>
 #include <iostream>
 
 #include <catch2/catch.hpp>
@@ -10,6 +11,7 @@
 #include "lb/Kernels.h"
 #include "lb/Streamers.h"
 #include "geometry/SiteData.h"
+#include "util/Threading.h"
 
 #include "tests/helpers/FourCubeBasedTestFixture.h"
 #include "tests/lb/LbTestsHelper.h"
@@ -55,7 +57,7 @@ namespace hemelb::tests
 	for (site_t streamedToSite = 0; streamedToSite < dom->GetLocalFluidSiteCount(); ++streamedToSite) {
 	  auto streamedSite = latDat->GetSite(streamedToSite);
 
-	  distribn_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
+	  distribn_storage_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
 
 	  for (auto streamedDirection = 0U; streamedDirection < NUMVECTORS; ++streamedDirection) {
 
@@ -109,7 +111,7 @@ namespace hemelb::tests
 	for (site_t streamedToSite = 0; streamedToSite < dom->GetLocalFluidSiteCount(); ++streamedToSite) {
 	    const auto streamedSite = latDat->GetSite(streamedToSite);
 
-	    distribn_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
+	    distribn_storage_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
 
 	    for (unsigned int streamedDirection = 0; streamedDirection < NUMVECTORS; ++streamedDirection) {
 	      unsigned int oppDirection = LATTICE::INVERSEDIRECTIONS[streamedDirection];
@@ -275,7 +277,7 @@ namespace hemelb::tests
 	for (site_t wallSiteLocalIndex = 0; wallSiteLocalIndex < wallSitesCount; wallSiteLocalIndex++) {
 	  site_t streamedToSite = firstWallSite + wallSiteLocalIndex;
 	  const auto streamedSite = latDat->GetSite(streamedToSite);
-	  distribn_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
+	  distribn_storage_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
 
 	  for (unsigned int streamedDirection = 0; streamedDirection
 		 < NUMVECTORS; ++streamedDirection) {
@@ -563,7 +565,7 @@ namespace hemelb::tests
 	for (site_t wallSiteLocalIndex = 0; wallSiteLocalIndex < wallSitesCount; wallSiteLocalIndex++) {
 	  site_t streamedToSite = firstWallSite + wallSiteLocalIndex;
 	  const auto streamedSite = latDat->GetSite(streamedToSite);
-	  distribn_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
+	  distribn_storage_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
 
 	  for (unsigned int streamedDirection = 0;
 	       streamedDirection < NUMVECTORS; ++streamedDirection) {
@@ -832,5 +834,285 @@ namespace hemelb::tests
 	  }
 	}
       }
+
+	SECTION("AAPatternMatchesAB") {
+	  // The in-place AA pattern must stream the same values as the
+	  // two array AB pattern, on both even and odd steps.
+	  using NashSBB = StreamerTypeFactory<BounceBackLink<COLLISION>, NashZerothOrderPressureLink<COLLISION>>;
+	  static_assert(aa_streamer<NashSBB>);
+	  static_assert(aa_streamer<BulkStreamer<COLLISION>>);
+	  static_assert(!aa_streamer<StreamerTypeFactory<BouzidiFirdaousLallemandLink<COLLISION>, NullLink<COLLISION>>>);
+
+	  auto inletBoundary = BuildIolets(geometry::INLET_TYPE);
+	  initParams.boundaryObject = &inletBoundary;
+	  NashSBB collider(initParams);
+
+	  std::unique_ptr<FourCubeLatticeData> aaLatDat{
+	      FourCubeLatticeData::Create(Comms(), cubeSizeWithHalo, 1, geometry::StreamingPattern::AA)
+	  };
+
+	  LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*latDat);
+	  LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*aaLatDat);
+
+	  distribn_t aaStreamed[NUMVECTORS];
+	  for (int step = 0; step < 3; ++step) {
+	    collider.StreamAndCollide(0, numSites, &lbmParams, *latDat, *propertyCache);
+	    collider.StreamAndCollide(0, numSites, &lbmParams, *aaLatDat, *propertyCache);
+
+	    for (site_t site = 0; site < numSites; ++site) {
+	      aaLatDat->GetStreamedDistributions(site, aaStreamed);
+	      distribn_storage_t const* abStreamed = latDat->GetFNew(site * NUMVECTORS);
+	      for (Direction i = 0; i < NUMVECTORS; ++i) {
+		REQUIRE(aaStreamed[i] == apprx(abStreamed[i]));
+	      }
+	    }
+
+	    latDat->SwapOldAndNew();
+	    aaLatDat->SwapOldAndNew();
+	  }
+	}
+
+	SECTION("LayoutsMatchAoS") {
+	  // Storing the distributions by direction, or by direction
+	  // within blocks of sites, must not change the values streamed.
+	  using NashSBB = StreamerTypeFactory<BounceBackLink<COLLISION>, NashZerothOrderPressureLink<COLLISION>>;
+	  static_assert(any_layout_streamer<NashSBB>);
+	  static_assert(any_layout_streamer<StreamerTypeFactory<BouzidiFirdaousLallemandLink<COLLISION>, NullLink<COLLISION>>>);
+	  static_assert(!any_layout_streamer<StreamerTypeFactory<GuoZhengShiLink<COLLISION>, NullLink<COLLISION>>>);
+
+	  auto inletBoundary = BuildIolets(geometry::INLET_TYPE);
+	  initParams.boundaryObject = &inletBoundary;
+	  NashSBB collider(initParams);
+
+	  using Layout = geometry::DistributionLayout;
+	  auto [pattern, layout] = GENERATE(
+	      std::make_pair(geometry::StreamingPattern::AB, Layout{Layout::Kind::SoA}),
+	      std::make_pair(geometry::StreamingPattern::AB, Layout{Layout::Kind::AoSoA, 4}),
+	      std::make_pair(geometry::StreamingPattern::AA, Layout{Layout::Kind::AoSoA, 8})
+	  );
+	  std::unique_ptr<FourCubeLatticeData> otherLatDat{
+	      FourCubeLatticeData::Create(Comms(), cubeSizeWithHalo, 1, pattern, layout)
+	  };
+	  auto const& otherLayout = otherLatDat->GetDomain().GetDistributionLayout();
+	  REQUIRE(otherLayout.GetStorageSize() >= numSites * NUMVECTORS);
+	  REQUIRE(otherLayout.GetStorageSize() % NUMVECTORS == 0);
+
+	  LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*latDat);
+	  LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*otherLatDat);
+
+	  distribn_t otherStreamed[NUMVECTORS];
+	  for (int step = 0; step < 3; ++step) {
+	    collider.StreamAndCollide(0, numSites, &lbmParams, *latDat, *propertyCache);
+	    collider.StreamAndCollide(0, numSites, &lbmParams, *otherLatDat, *propertyCache);
+
+	    for (site_t site = 0; site < numSites; ++site) {
+	      otherLatDat->GetStreamedDistributions(site, otherStreamed);
+	      distribn_storage_t const* aosStreamed = latDat->GetFNew(site * NUMVECTORS);
+	      for (Direction i = 0; i < NUMVECTORS; ++i) {
+		REQUIRE(otherStreamed[i] == apprx(aosStreamed[i]));
+	      }
+	    }
+
+	    latDat->SwapOldAndNew();
+	    otherLatDat->SwapOldAndNew();
+	  }
+	}
+
+	SECTION("LinkListsMatchPerLinkTests") {
+	  // A streamer told its site ranges finds the wall and iolet
+	  // links in advance; this must not change what it streams.
+	  auto inletBoundary = BuildIolets(geometry::INLET_TYPE);
+	  initParams.boundaryObject = &inletBoundary;
+
+	  // The wall distances are random, so make them the same for both.
+	  auto pattern = GENERATE(geometry::StreamingPattern::AB, geometry::StreamingPattern::AA);
+	  std::srand(1);
+	  std::unique_ptr<FourCubeLatticeData> listsLatDat{
+	      FourCubeLatticeData::Create(Comms(), cubeSizeWithHalo, 1, pattern)
+	  };
+	  std::srand(1);
+	  std::unique_ptr<FourCubeLatticeData> testsLatDat{
+	      FourCubeLatticeData::Create(Comms(), cubeSizeWithHalo, 1, pattern)
+	  };
+
+	  auto check = [&]<typename STREAMER>() {
+	    // Split the sites into two ranges, as LBM does for
+	    // the mid-domain and domain-edge sites.
+	    auto const split = numSites / 3;
+	    InitParams listsParams = initParams;
+	    listsParams.latDat = &listsLatDat->GetDomain();
+	    listsParams.siteRanges = {{0, split}, {split, numSites}};
+	    STREAMER withLists(listsParams);
+	    STREAMER withTests(initParams);
+
+	    LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*listsLatDat);
+	    LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*testsLatDat);
+
+	    for (int step = 0; step < 3; ++step) {
+	      withLists.StreamAndCollide(0, split, &lbmParams, *listsLatDat, *propertyCache);
+	      withLists.StreamAndCollide(split, numSites - split, &lbmParams, *listsLatDat, *propertyCache);
+	      withTests.StreamAndCollide(0, numSites, &lbmParams, *testsLatDat, *propertyCache);
+	      withLists.PostStep(0, split, &lbmParams, *listsLatDat, *propertyCache);
+	      withLists.PostStep(split, numSites - split, &lbmParams, *listsLatDat, *propertyCache);
+	      withTests.PostStep(0, numSites, &lbmParams, *testsLatDat, *propertyCache);
+
+	      distribn_t listsStreamed[NUMVECTORS];
+	      distribn_t testsStreamed[NUMVECTORS];
+	      for (site_t site = 0; site < numSites; ++site) {
+		listsLatDat->GetStreamedDistributions(site, listsStreamed);
+		testsLatDat->GetStreamedDistributions(site, testsStreamed);
+		for (Direction i = 0; i < NUMVECTORS; ++i) {
+		  // GZS extrapolates to nonsense where the random wall distance is 0.
+		  if (std::isnan(testsStreamed[i]))
+		    REQUIRE(std::isnan(listsStreamed[i]));
+		  else
+		    REQUIRE(listsStreamed[i] == apprx(testsStreamed[i]));
+		}
+	      }
+
+	      listsLatDat->SwapOldAndNew();
+	      testsLatDat->SwapOldAndNew();
+	    }
+	  };
+
+	  check.template operator()<StreamerTypeFactory<BounceBackLink<COLLISION>, NashZerothOrderPressureLink<COLLISION>>>();
+	  check.template operator()<StreamerTypeFactory<NullLink<COLLISION>, NashZerothOrderPressureLink<COLLISION>>>();
+	  if (pattern == geometry::StreamingPattern::AB) {
+	    // These also prepare each wall link's coefficients in advance.
+	    static_assert(prepared_link_streamer<BouzidiFirdaousLallemandLink<COLLISION>>);
+	    static_assert(prepared_link_streamer<GuoZhengShiLink<COLLISION>>);
+	    check.template operator()<StreamerTypeFactory<BouzidiFirdaousLallemandLink<COLLISION>, NullLink<COLLISION>>>();
+	    check.template operator()<StreamerTypeFactory<GuoZhengShiLink<COLLISION>, NullLink<COLLISION>>>();
+	  }
+	}
+
+	SECTION("ThreadedMatchesSerial") {
+	  // Splitting the sites between threads (when built with
+	  // OpenMP) must not change the result.
+	  using NashSBB = StreamerTypeFactory<BounceBackLink<COLLISION>, NashZerothOrderPressureLink<COLLISION>>;
+	  static_assert(threadable_streamer<NashSBB>);
+	  static_assert(threadable_streamer<BulkStreamer<COLLISION>>);
+	  static_assert(!threadable_streamer<StreamerTypeFactory<GuoZhengShiLink<COLLISION>, NullLink<COLLISION>>>);
+	  using NNCOLLISION = Normal<LBGKNN<CassonRheologyModel, LATTICE>>;
+	  static_assert(!threadable_streamer<StreamerTypeFactory<BounceBackLink<NNCOLLISION>, NashZerothOrderPressureLink<NNCOLLISION>>>);
+
+	  auto inletBoundary = BuildIolets(geometry::INLET_TYPE);
+	  initParams.boundaryObject = &inletBoundary;
+	  NashSBB collider(initParams);
+
+	  auto pattern = GENERATE(geometry::StreamingPattern::AB, geometry::StreamingPattern::AA);
+	  // Big enough that the sites are split.
+	  site_t const cubeSize = 12;
+	  std::unique_ptr<FourCubeLatticeData> serialLatDat{
+	      FourCubeLatticeData::Create(Comms(), cubeSize, 1, pattern)
+	  };
+	  std::unique_ptr<FourCubeLatticeData> threadedLatDat{
+	      FourCubeLatticeData::Create(Comms(), cubeSize, 1, pattern)
+	  };
+	  LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*serialLatDat);
+	  LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*threadedLatDat);
+	  auto const sites = serialLatDat->GetDomain().GetLocalFluidSiteCount();
+
+	  distribn_t serialStreamed[NUMVECTORS];
+	  distribn_t threadedStreamed[NUMVECTORS];
+	  for (int step = 0; step < 3; ++step) {
+	    collider.StreamAndCollide(0, sites, &lbmParams, *serialLatDat, *propertyCache);
+	    util::ForEachChunk(0, sites, [&](site_t first, site_t count) {
+	      collider.StreamAndCollide(first, count, &lbmParams, *threadedLatDat, *propertyCache);
+	    });
+
+	    for (site_t site = 0; site < sites; ++site) {
+	      serialLatDat->GetStreamedDistributions(site, serialStreamed);
+	      threadedLatDat->GetStreamedDistributions(site, threadedStreamed);
+	      for (Direction i = 0; i < NUMVECTORS; ++i) {
+		REQUIRE(threadedStreamed[i] == serialStreamed[i]);
+	      }
+	    }
+
+	    serialLatDat->SwapOldAndNew();
+	    threadedLatDat->SwapOldAndNew();
+	  }
+	}
+
+#if __has_include(<experimental/simd>)
+	SECTION("BatchedCollisionMatchesScalar") {
+	  // Colliding four sites at a time in SIMD vectors must give
+	  // the same values as one at a time, for any layout and on
+	  // both AA steps. Like BulkStreamer, this is only for sites
+	  // with no wall or iolet links, so use a cube with enough of
+	  // those (they come first). An odd number of sites leaves a
+	  // remainder for the scalar loop.
+	  // LBGKNN keeps a relaxation time per site, which the batches
+	  // must load and update as the scalar loop does.
+	  static_assert(batch_collision<COLLISION>);
+	  static_assert(batch_collision<Normal<TRT<LATTICE>>>);
+	  static_assert(batch_collision<Normal<LBGKNN<CassonRheologyModel, LATTICE>>>);
+	  using Batch = std::experimental::fixed_size_simd<distribn_t, 4>;
+
+	  using Layout = geometry::DistributionLayout;
+	  auto [pattern, layout] = GENERATE(
+	      std::make_pair(geometry::StreamingPattern::AB, Layout{Layout::Kind::AoS}),
+	      std::make_pair(geometry::StreamingPattern::AB, Layout{Layout::Kind::SoA}),
+	      std::make_pair(geometry::StreamingPattern::AA, Layout{Layout::Kind::AoSoA, 4}),
+	      std::make_pair(geometry::StreamingPattern::AA, Layout{Layout::Kind::AoS})
+	  );
+
+	  auto check = [&]<typename C>() {
+	    std::unique_ptr<FourCubeLatticeData> scalarLatDat{
+		FourCubeLatticeData::Create(Comms(), 8, 1, pattern, layout)
+	    };
+	    std::unique_ptr<FourCubeLatticeData> batchLatDat{
+		FourCubeLatticeData::Create(Comms(), 8, 1, pattern, layout)
+	    };
+	    LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*scalarLatDat);
+	    LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*batchLatDat);
+	    // Kernels with per-site state need a domain with these sites.
+	    initParams.latDat = &batchLatDat->GetDomain();
+	    BulkStreamer<C> scalar(initParams);
+	    C collider(initParams);
+
+	    auto const bulkCount = batchLatDat->GetDomain().GetMidDomainCollisionCount(0);
+	    REQUIRE(bulkCount == 64);
+	    auto const siteCount = bulkCount - 1;
+	    auto batchStep = [&]<StepKind STEP>() {
+	      auto const done = StreamAndCollideBatches<STEP, Batch>(collider, 0, siteCount,
+					 &lbmParams, *batchLatDat, *propertyCache);
+	      REQUIRE(done == siteCount / 4 * 4);
+	      // The remainder, one site at a time.
+	      scalar.StreamAndCollide(done, siteCount - done, &lbmParams, *batchLatDat, *propertyCache);
+	    };
+
+	    distribn_t scalarStreamed[NUMVECTORS];
+	    distribn_t batchStreamed[NUMVECTORS];
+	    for (int step = 0; step < 3; ++step) {
+	      scalar.StreamAndCollide(0, siteCount, &lbmParams, *scalarLatDat, *propertyCache);
+	      switch (GetStepKind(*batchLatDat)) {
+		case StepKind::AB:
+		  batchStep.template operator()<StepKind::AB>();
+		  break;
+		case StepKind::AAEven:
+		  batchStep.template operator()<StepKind::AAEven>();
+		  break;
+		case StepKind::AAOdd:
+		  batchStep.template operator()<StepKind::AAOdd>();
+		  break;
+	      }
+
+	      for (site_t site = 0; site < siteCount; ++site) {
+		scalarLatDat->GetStreamedDistributions(site, scalarStreamed);
+		batchLatDat->GetStreamedDistributions(site, batchStreamed);
+		for (Direction i = 0; i < NUMVECTORS; ++i) {
+		  REQUIRE(batchStreamed[i] == apprx(scalarStreamed[i]));
+		}
+	      }
+
+	      scalarLatDat->SwapOldAndNew();
+	      batchLatDat->SwapOldAndNew();
+	    }
+	  };
+	  check.template operator()<COLLISION>();
+	  check.template operator()<Normal<LBGKNN<CassonRheologyModel, LATTICE>>>();
+	}
+#endif
     }
 }
@@ -126,11 +126,13 @@ namespace hemelb::tests
                         LatticeVector pos(i, j, k);
                         site_t siteIdx = dom->GetContiguousSiteId(pos);
                         //geometry::Site < geometry::domain_type > site = latDat->GetSite(siteIdx);
-                        auto fOld = Lattice::mut_span{latDat->GetFNew(siteIdx * Lattice::NUMVECTORS), Lattice::NUMVECTORS};
+                        distribn_t fEq[Lattice::NUMVECTORS];
                         LatticeDensity rho = GetDensity(pos);
                         LatticeVelocity u = GetVelocity(pos);
                         u *= rho;
-                        Lattice::CalculateFeq(rho, u, fOld);
+                        Lattice::CalculateFeq(rho, u, fEq);
+                        for (Direction d = 0; d < Lattice::NUMVECTORS; ++d)
+                            *latDat->GetFNew(dom->GetDistributionIndex(siteIdx, d)) = fEq[d];
                     }
                 }
             }
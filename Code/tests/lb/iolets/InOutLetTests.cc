@@ -3,6 +3,9 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <cstring>
+#include <fstream>
+
 #include <catch2/catch.hpp>
 
 #include "lb/iolets/InOutLets.h"
@@ -290,6 +293,119 @@ namespace hemelb::tests
 
         }
 
+        SECTION("TestVelocityWeightsFile") {
+            MoveToTempdir();
+            using W = lb::VelocityWeight;
+            std::vector<W> const inFileOrder{{{3, 2, 1}, 0.5}, {{1, 2, 3}, 0.25}, {{3, 2, 1}, 0.75}, {{-1, 0, 7}, 1.0}};
+            {
+                std::ofstream text("weights.txt");
+                for (auto const& w: inFileOrder)
+                    text << w.site[0] << " " << w.site[1] << " " << w.site[2] << " " << w.weight << "\n";
+
+                std::ofstream bin("weights.bin", std::ios_base::binary);
+                bin.write(lb::VELOCITY_WEIGHTS_MAGIC, sizeof(lb::VELOCITY_WEIGHTS_MAGIC));
+                std::uint64_t const n = inFileOrder.size();
+                bin.write(reinterpret_cast<char const*>(&n), sizeof(n));
+                for (auto const& w: inFileOrder) {
+                    std::int32_t const xyz[3] = {w.site[0], w.site[1], w.site[2]};
+                    bin.write(reinterpret_cast<char const*>(xyz), sizeof(xyz));
+                    bin.write(reinterpret_cast<char const*>(&w.weight), sizeof(w.weight));
+                }
+            }
+
+            // Both give the sites in order, with the last weight given for a repeated one.
+            std::vector<W> const expected{{{-1, 0, 7}, 1.0}, {{1, 2, 3}, 0.25}, {{3, 2, 1}, 0.75}};
+            for (auto name: {"weights.txt", "weights.bin"}) {
+                auto const actual = lb::ReadVelocityWeights(name);
+                REQUIRE(actual.size() == expected.size());
+                for (std::size_t i = 0; i < expected.size(); ++i) {
+                    REQUIRE(actual[i].site == expected[i].site);
+                    REQUIRE(actual[i].weight == expected[i].weight);
+                }
+            }
+
+            // A binary file cut short, or whose count is corrupt, is rejected
+            // without trying to allocate for the records it claims to have.
+            std::filesystem::copy_file("weights.bin", "truncated.bin");
+            std::filesystem::resize_file("truncated.bin", std::filesystem::file_size("weights.bin") - 1);
+            REQUIRE_THROWS_AS(lb::ReadVelocityWeights("truncated.bin"), Exception);
+
+            std::filesystem::copy_file("weights.bin", "corrupt.bin");
+            {
+                std::fstream corrupt("corrupt.bin", std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+                corrupt.seekp(sizeof(lb::VELOCITY_WEIGHTS_MAGIC));
+                std::uint64_t const n = std::uint64_t(1) << 62;
+                corrupt.write(reinterpret_cast<char const*>(&n), sizeof(n));
+            }
+            REQUIRE_THROWS_AS(lb::ReadVelocityWeights("corrupt.bin"), Exception);
+        }
+
+        SECTION("TestFileDensityWindow") {
+            MoveToTempdir();
+            {
+                std::ofstream trace("pressure.txt");
+                trace << "0 80\n0.3 120\n0.35 95\n0.7 100\n1.0 80\n";
+            }
+            util::UnitConverter units(1e-3, 1e-5, PhysicalPosition::Zero(), DEFAULT_FLUID_DENSITY_Kg_per_m3, 80.0);
+            lb::InOutLetFile file;
+            file.SetFilePath("pressure.txt");
+            file.Initialise(&units);
+
+            // Several windows' worth of steps.
+            auto const total = 2 * lb::InOutLetFile::WINDOW_STEPS + 77;
+            lb::SimulationState state(1e-5, total);
+            file.Reset(state);
+
+            // Steps beyond the window are interpolated directly; check that
+            // tabulating them as the run goes on gives exactly the same.
+            std::vector<LatticeDensity> direct(total + 1);
+            for (LatticeTimeStep t = 0; t <= total; ++t)
+                direct[t] = file.GetDensity(t);
+            REQUIRE(direct.front() == direct.back());
+            for (LatticeTimeStep t = 0; t <= total; ++t) {
+                file.PrepareTimeStep(t);
+                REQUIRE(file.GetDensity(t) == direct[t]);
+            }
+        }
+
+        SECTION("TestWomersleyVelocityAtPoints") {
+            lb::InOutLetWomersleyVelocity womersVel;
+            womersVel.SetPosition(LatticePosition(1, 2, 3));
+            womersVel.SetNormal(util::Vector3D<Dimensionless>(0, 1, 1));
+            womersVel.SetRadius(10.0);
+            womersVel.SetPressureGradientAmplitude(1e-6);
+            womersVel.SetPeriod(100.0);
+            womersVel.SetWomersleyNumber(2.0);
+
+            std::vector<LatticePosition> points{{1, 2, 3}, {4.5, 2, 3}, {1, 7, -2}, {-6, 5.5, 3.5}};
+            for (std::size_t i = 0; i < points.size(); ++i)
+                REQUIRE(womersVel.RegisterVelocityPoint(points[i]) == i);
+
+            // The precomputed profile must give exactly what GetVelocity does,
+            // including after the parameters it depends on change.
+            auto checkPoints = [&]() {
+                for (LatticeTimeStep t: {0UL, 17UL, 50UL, 1234UL})
+                    for (std::size_t i = 0; i < points.size(); ++i)
+                        REQUIRE(womersVel.GetVelocityAtPoint(i, t) == womersVel.GetVelocity(points[i], t));
+            };
+            checkPoints();
+            womersVel.SetWomersleyNumber(5.0);
+            checkPoints();
+            womersVel.SetRadius(8.0);
+            checkPoints();
+            womersVel.SetPosition(LatticePosition(2, 1, 4));
+            checkPoints();
+            womersVel.SetNormal(util::Vector3D<Dimensionless>(1, 0, 1));
+            checkPoints();
+
+            // As must the phase prepared for the (1-indexed) step the
+            // streamers ask about.
+            womersVel.PrepareTimeStep(49);
+            for (std::size_t i = 0; i < points.size(); ++i)
+                REQUIRE(womersVel.GetVelocityAtPoint(i, 50) == womersVel.GetVelocity(points[i], 50));
+            checkPoints();
+        }
+
         SECTION("TestIoletCoordinates") {
             // unit converter - make physical and lattice units the same
             util::UnitConverter units(1, 1, PhysicalPosition::Zero(), DEFAULT_FLUID_DENSITY_Kg_per_m3, 0.0);
@@ -5,7 +5,10 @@
 
 #include <catch2/catch.hpp>
 
+#include <vector>
+
 #include "net/mpi.h"
+#include "net/net.h"
 
 namespace hemelb
 {
@@ -44,6 +47,40 @@ namespace hemelb
 	// Same ranks, but different context.
 	REQUIRE(commWorld2 != commWorld);
       }
+
+      SECTION("Derived datatypes can scatter what is received") {
+	std::vector<double> sent{1.0, 2.0, 3.0};
+	std::vector<double> received(6, 0.0);
+	MPI_Aint displacements[3] = {4 * sizeof(double), 0, 2 * sizeof(double)};
+	MPI_Datatype scatter;
+	MPI_Type_create_hindexed_block(3, 1, displacements, MPI_DOUBLE, &scatter);
+	MPI_Type_commit(&scatter);
+
+	net::Net net(commWorld);
+	net.RequestSend(sent.data(), 3, commWorld.Rank());
+	net.RequestReceiveDatatype(received.data(), commWorld.Rank(), scatter);
+	net.Dispatch();
+	REQUIRE(received == std::vector<double>{2.0, 0.0, 3.0, 0.0, 1.0, 0.0});
+
+	MPI_Type_free(&scatter);
+      }
+
+      SECTION("Persistent requests can be restarted") {
+	std::vector<int> sent{1, 2, 3};
+	std::vector<int> received(3, 0);
+	PersistentRequests requests(commWorld);
+	requests.RequestReceive(received.data(), 3, commWorld.Rank());
+	requests.RequestSend(sent.data(), 3, commWorld.Rank());
+
+	net::Net net(commWorld);
+	for (int round = 0; round < 2; ++round) {
+	  for (auto& x: sent)
+	    x += 10;
+	  net.RequestPersistent(requests);
+	  net.Dispatch();
+	  REQUIRE(received == sent);
+	}
+      }
     }
   }
 }
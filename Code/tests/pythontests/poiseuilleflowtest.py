@@ -23,6 +23,12 @@ class TestPoiseuilleFlowTest(unittest.TestCase):
 
         self.temp_dir = tempfile.mkdtemp("_HemeLB_RegressionTest")
         shutil.copy("../../build/hemelb", self.temp_dir)
+        # Validation mode: to check a build with different numerics
+        # (e.g. HEMELB_DISTRIBUTION_PRECISION=float), point this at a
+        # build with the default options and the results are compared.
+        self.reference = os.environ.get("HEMELB_REFERENCE_EXECUTABLE")
+        if self.reference:
+            shutil.copy(self.reference, os.path.join(self.temp_dir, "hemelb_reference"))
         shutil.copy("resources/poiseuille_flow_test.gmy", self.temp_dir)
         shutil.copy("resources/poiseuille_flow_test.xml", self.temp_dir)
         os.chdir(self.temp_dir)
@@ -94,4 +100,29 @@ class TestPoiseuilleFlowTest(unittest.TestCase):
 
     def test_shear_stress_profile(self):
         pass
+
+    def test_velocity_matches_reference_build(self):
+        if not self.reference:
+            self.skipTest("HEMELB_REFERENCE_EXECUTABLE not set")
+
+        try:
+            subprocess.call("mpirun -np 4 ./hemelb_reference -in poiseuille_flow_test.xml -out reference_results", shell=True)
+        except OSError, e:
+            print >>sys.stderr, "Call to reference HemeLB failed:", e
+
+        filename = "Extracted/velocity_40mm_in.dat"
+        propFile = ExtractedProperty(os.path.join("results", filename))
+        refFile = ExtractedProperty(os.path.join("reference_results", filename))
+        self.assertEqual(list(propFile.times), list(refFile.times))
+
+        for t in refFile.times:
+            sites = sorted((tuple(site.position), site.velocity_40mm_in) for site in propFile.GetByTimeStep(t))
+            refSites = sorted((tuple(site.position), site.velocity_40mm_in) for site in refFile.GetByTimeStep(t))
+            self.assertEqual([pos for pos, vel in sites], [pos for pos, vel in refSites])
+
+            # Allow a small fraction of the peak velocity.
+            tolerance = 1e-3 * max(norm(vel) for pos, vel in refSites)
+            for (pos, vel), (refPos, refVel) in zip(sites, refSites):
+                self.assertTrue(norm(vel - refVel) <= tolerance,
+                                msg="Velocity {0} differs from reference build's {1} at site {2} at time step {3}".format(vel, refVel, pos, t))
     
\ No newline at end of file
@@ -85,6 +85,17 @@ namespace hemelb
 	}
       }
 
+      SECTION("TestCounters") {
+	using TestTimers = decltype(timers);
+	for (unsigned int i = 0; i < Timers::numberOfCounters; i++) {
+	  REQUIRE(0 == timers.GetCounter(TestTimers::CounterName(i)));
+	}
+	timers.AddToCounter(TestTimers::entropicAlphaBrent, 3);
+	timers.AddToCounter(TestTimers::entropicAlphaBrent, 4);
+	REQUIRE(7 == timers.GetCounter(TestTimers::entropicAlphaBrent));
+	REQUIRE(0 == timers.GetCounter(TestTimers::entropicAlphaAnalytic));
+      }
+
     }
 
   }
@@ -0,0 +1,61 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "util/Threading.h"
+
+namespace hemelb::tests
+{
+    using namespace util;
+
+    TEST_CASE("Threading") {
+
+        SECTION("ChunksCoverRangeOnAlignedBoundaries") {
+            auto [first, count] = GENERATE(std::make_pair(site_t(0), site_t(1000)),
+                                           std::make_pair(site_t(13), site_t(501)),
+                                           std::make_pair(site_t(40), site_t(5)),
+                                           std::make_pair(site_t(7), site_t(0)));
+            auto chunkCount = GENERATE(1, 2, 3, 7, 64);
+
+            REQUIRE(GetChunkStart(first, count, 0, chunkCount) == first);
+            REQUIRE(GetChunkStart(first, count, chunkCount, chunkCount) == first + count);
+            for (int chunk = 1; chunk < chunkCount; ++chunk) {
+                auto const start = GetChunkStart(first, count, chunk, chunkCount);
+                REQUIRE(start >= GetChunkStart(first, count, chunk - 1, chunkCount));
+                REQUIRE(start <= first + count);
+                // Either aligned, or the chunk is empty at the end of the range.
+                REQUIRE((start % THREAD_CHUNK_ALIGNMENT == 0 || start == first + count));
+            }
+        }
+
+        SECTION("ForEachChunkVisitsEverySiteOnce") {
+            auto [first, count] = GENERATE(std::make_pair(site_t(0), site_t(100000)),
+                                           std::make_pair(site_t(3), site_t(17)),
+                                           std::make_pair(site_t(5), site_t(0)));
+            std::mutex mutex;
+            std::vector<std::pair<site_t, site_t>> chunks;
+            ForEachChunk(first, count, [&](site_t chunkFirst, site_t chunkCount) {
+                std::lock_guard<std::mutex> lock(mutex);
+                chunks.emplace_back(chunkFirst, chunkCount);
+            });
+
+            REQUIRE(chunks.size() >= 1);
+            REQUIRE(chunks.size() <= std::size_t(std::max(GetThreadCount(), 1)));
+            std::sort(chunks.begin(), chunks.end());
+            site_t next = first;
+            for (auto [chunkFirst, chunkCount]: chunks) {
+                REQUIRE(chunkFirst == next);
+                next += chunkCount;
+            }
+            REQUIRE(next == first + count);
+        }
+    }
+}
@@ -8,6 +8,8 @@
 
 #include <cstdint>
 #include <span>
+#include <type_traits>
+#include "build_info.h"
 #include "util/Vector3D.h"
 
 namespace hemelb
@@ -25,6 +27,17 @@ namespace hemelb
   typedef unsigned Direction;
   typedef uint64_t sitedata_t;
 
+  // The distributions themselves are stored, and sent between
+  // processes, as distribn_storage_t, which may be narrower than
+  // distribn_t (see HEMELB_DISTRIBUTION_PRECISION). Everything computed
+  // from them is done in distribn_t.
+  typedef std::conditional_t<build_info::DISTRIBUTION_PRECISION == "float", float, distribn_t> distribn_storage_t;
+  inline constexpr bool DISTRIBUTIONS_STORED_IN_FULL = std::is_same_v<distribn_storage_t, distribn_t>;
+
+  // Offsets into a process's distribution arrays, as held in the
+  // streaming tables (see HEMELB_USE_COMPACT_STREAMING_INDICES).
+  typedef std::conditional_t<build_info::USE_COMPACT_STREAMING_INDICES, std::uint32_t, site_t> streaming_index_t;
+
   // Span over a contiguous range of distribution-ish values
   template <std::size_t N = std::dynamic_extent>
   using ConstDistSpan = std::span<const distribn_t, N>;
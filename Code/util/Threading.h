@@ -0,0 +1,84 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UTIL_THREADING_H
+#define HEMELB_UTIL_THREADING_H
+
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "units.h"
+
+namespace hemelb::util
+{
+    // Chunks of sites given to different threads start at multiples of
+    // this, so no two threads write to the same AoSoA block (or, for
+    // the other layouts, share many cache lines).
+    inline constexpr site_t THREAD_CHUNK_ALIGNMENT = 8;
+
+    // Don't bother starting the threads for fewer sites than this.
+    inline constexpr site_t MIN_SITES_PER_THREAD = 64;
+
+    /// The number of threads each MPI process uses for the LB update:
+    /// OMP_NUM_THREADS (or the OpenMP default) if built with
+    /// HEMELB_USE_OPENMP, otherwise one.
+    inline int GetThreadCount()
+    {
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+    /// Where the chunk-th of chunkCount chunks of the sites
+    /// [first, first + count) begins.
+    inline site_t GetChunkStart(site_t first, site_t count, int chunk, int chunkCount)
+    {
+        if (chunk <= 0)
+            return first;
+        if (chunk >= chunkCount)
+            return first + count;
+        site_t const start = first + count * chunk / chunkCount;
+        site_t const aligned = (start + THREAD_CHUNK_ALIGNMENT - 1) / THREAD_CHUNK_ALIGNMENT
+                * THREAD_CHUNK_ALIGNMENT;
+        return std::min(aligned, first + count);
+    }
+
+    /**
+     * Split the sites [first, first + count) into contiguous chunks,
+     * one per thread, and call f(chunkFirst, chunkCount) for each on
+     * its own thread. Returns when all are done.
+     *
+     * OpenMP keeps its threads alive between parallel regions, so this
+     * is cheap enough to call several times a time step. Without OpenMP
+     * (or for few sites) f is called once, for all the sites.
+     */
+    template <typename F>
+    void ForEachChunk(site_t first, site_t count, F&& f)
+    {
+#ifdef _OPENMP
+        int const threads = std::min<site_t>(GetThreadCount(), count / MIN_SITES_PER_THREAD);
+        if (threads > 1)
+        {
+#pragma omp parallel num_threads(threads)
+            {
+                int const chunkCount = omp_get_num_threads();
+                int const chunk = omp_get_thread_num();
+                site_t const start = GetChunkStart(first, count, chunk, chunkCount);
+                site_t const end = GetChunkStart(first, count, chunk + 1, chunkCount);
+                if (end > start)
+                    f(start, end - start);
+            }
+            return;
+        }
+#endif
+        f(first, count);
+    }
+}
+
+#endif // HEMELB_UTIL_THREADING_H
@@ -4,6 +4,10 @@
 // license in the file LICENSE.
 
 #include "net/mpi.h"
+#ifdef HAVE_RUSAGE
+#include <sys/resource.h>
+#endif
+
 namespace hemelb
 {
   namespace util
@@ -14,6 +18,17 @@ namespace hemelb
       return MPI_Wtime();
     }
 
+    long PeakMemoryUsage()
+    {
+#ifdef HAVE_RUSAGE
+      rusage usage;
+      getrusage(RUSAGE_SELF, &usage);
+      return usage.ru_maxrss;
+#else
+      return 0;
+#endif
+    }
+
   }
 
 }
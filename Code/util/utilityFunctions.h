@@ -277,6 +277,10 @@ namespace hemelb
 
     // Returns the number of seconds to 6dp elapsed since the Epoch
     double myClock();
+
+    // Returns the peak resident memory of this process so far, in
+    // kilobytes, or zero if the platform can't tell us.
+    long PeakMemoryUsage();
   }
 }
 
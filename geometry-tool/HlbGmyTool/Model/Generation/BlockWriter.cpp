@@ -13,13 +13,22 @@
 #include "GeometryWriter.h"
 #include "Neighbours.h"
 
-BlockWriter::BlockWriter(BufferPool* bp)
-    : writer(NULL), buffer(NULL), bufferPool(bp) {
+using hemelb::io::formats::geometry;
+
+BlockWriter::BlockWriter(BufferPool* bp,
+                         std::uint32_t version,
+                         geometry::Codec codec)
+    : writer(NULL),
+      buffer(NULL),
+      bufferPool(bp),
+      version(version),
+      codec(codec) {
   this->Reset();
 }
 
 void BlockWriter::Reset() {
   this->nFluidSites = 0;
+  this->recordLength = 0;
   this->CompressedBlockLength = 0;
   this->UncompressedBlockLength = 0;
 
@@ -42,15 +51,54 @@ void BlockWriter::IncrementFluidSitesCount() {
   this->nFluidSites++;
 }
 
+void BlockWriter::WriteSolidSiteRecord() {
+  this->WriteRecord(geometry::LittleEndian(
+      static_cast<std::uint32_t>(geometry::SiteType::SOLID)));
+}
+
+void BlockWriter::WriteFluidSiteRecord(std::vector<LinkData> const& links,
+                                       bool wallNormalAvailable,
+                                       Vector const& wallNormal) {
+  // Every field is present, with zeros where version 4 would omit it.
+  geometry::FluidSiteRecordV5 record{};
+  record.siteType = static_cast<std::uint32_t>(geometry::SiteType::FLUID);
+  for (unsigned int i = 0; i < Neighbours::n; ++i) {
+    auto&& link = links[i];
+    record.links[i].cutType = static_cast<std::uint32_t>(link.Type);
+    if (link.Type == geometry::CutType::INLET ||
+        link.Type == geometry::CutType::OUTLET)
+      record.links[i].ioletId = link.IoletId;
+    if (link.Type != geometry::CutType::NONE)
+      record.links[i].distance = static_cast<float>(link.Distance);
+  }
+  if (wallNormalAvailable) {
+    record.wallNormalAvailable =
+        static_cast<std::uint32_t>(geometry::WallNormalAvailability::AVAILABLE);
+    for (unsigned int j = 0; j < 3; ++j)
+      record.wallNormal[j] = static_cast<float>(wallNormal[j]);
+  } else {
+    record.wallNormalAvailable = static_cast<std::uint32_t>(
+        geometry::WallNormalAvailability::NOT_AVAILABLE);
+  }
+  geometry::LittleEndian(record);
+  this->WriteRecord(record);
+}
+
 void BlockWriter::Finish() {
   this->CompressedBlockLength = 0;
   this->UncompressedBlockLength = 0;
 
-  if (this->nFluidSites > 0) {
+  if (this->nFluidSites > 0 && this->codec == geometry::Codec::NONE) {
+    // Stored as is.
+    this->UncompressedBlockLength = this->recordLength;
+    this->CompressedBlockLength = this->recordLength;
+  } else if (this->nFluidSites > 0) {
     int ret;  // zlib return code
 
     // How much data to compress?
-    this->UncompressedBlockLength = this->writer->getCurrentStreamPosition();
+    this->UncompressedBlockLength = this->IsVersion5()
+                                        ? this->recordLength
+                                        : this->writer->getCurrentStreamPosition();
 
     // Set up our compressor
     z_stream stream;
@@ -108,6 +156,17 @@ void BlockWriter::Write(GeometryWriter& gw) {
 
     std::fwrite(this->buffer, 1, this->CompressedBlockLength, gw.bodyFile);
   }
-  *(gw.headerEncoder) << this->nFluidSites << this->CompressedBlockLength
-                      << this->UncompressedBlockLength;
+
+  if (this->IsVersion5()) {
+    geometry::BlockIndexRecordV5 record{gw.bodyPosition, this->nFluidSites,
+                                        this->CompressedBlockLength,
+                                        this->UncompressedBlockLength, 0};
+    geometry::LittleEndian(record);
+    std::memcpy(gw.headerBuffer + gw.headerPosition, &record, sizeof(record));
+    gw.headerPosition += sizeof(record);
+  } else {
+    *(gw.headerEncoder) << this->nFluidSites << this->CompressedBlockLength
+                        << this->UncompressedBlockLength;
+  }
+  gw.bodyPosition += this->CompressedBlockLength;
 }
@@ -7,7 +7,13 @@
 #define HEMELBSETUPTOOL_BLOCKWRITER_H
 
 #include <stddef.h>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <vector>
+#include "Index.h"
+#include "Site.h"
+#include "io/formats/geometry.h"
 #include "io/writers/XdrMemWriter.h"
 
 class GeometryWriter;
@@ -16,11 +22,18 @@ class BufferPool;
  * Extension of a hemelb::io::XdrWriter that notes how many fluid sites, in how
  * much space, have been written. It then pushes this to the GeometryWriter's
  * headerEncoder and writes to the GeometryWriter's body
+ *
+ * For GMY version 5, sites are instead written as fixed-size little-endian
+ * records with WriteRecord and the block is compressed with the file's codec.
  */
 
 class BlockWriter {
  public:
-  BlockWriter(BufferPool* bp);
+  BlockWriter(BufferPool* bp,
+              std::uint32_t version =
+                  hemelb::io::formats::geometry::VersionNumber,
+              hemelb::io::formats::geometry::Codec codec =
+                  hemelb::io::formats::geometry::Codec::ZLIB);
   void Reset();
 
   ~BlockWriter();
@@ -37,10 +50,31 @@ class BlockWriter {
     return *this;
   }
 
+  // Append a version 5 site record, which must already be little-endian.
+  template <typename T>
+  void WriteRecord(T const& record) {
+    std::memcpy(this->buffer + this->recordLength, &record, sizeof(T));
+    this->recordLength += sizeof(T);
+  }
+
+  // Append version 5 records for a solid site and for a fluid site with the
+  // given links (one per displacement) and wall normal.
+  void WriteSolidSiteRecord();
+  void WriteFluidSiteRecord(std::vector<LinkData> const& links,
+                            bool wallNormalAvailable,
+                            Vector const& wallNormal);
+
+  inline bool IsVersion5() const {
+    return this->version == hemelb::io::formats::geometry::VersionNumberV5;
+  }
+
  protected:
   char* buffer;
   hemelb::io::XdrMemWriter* writer;
   BufferPool* bufferPool;
+  std::uint32_t version;
+  hemelb::io::formats::geometry::Codec codec;
+  unsigned int recordLength;
   unsigned int nFluidSites;
   unsigned int CompressedBlockLength;
   unsigned int UncompressedBlockLength;
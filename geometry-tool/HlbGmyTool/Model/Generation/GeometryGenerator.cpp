@@ -24,6 +24,14 @@ GeometryGenerator::GeometryGenerator() {
 
 GeometryGenerator::~GeometryGenerator() {}
 
+void GeometryGenerator::SetOutputFormat(std::uint32_t version,
+                                        std::uint32_t codec) {
+  auto blockCodec = static_cast<geometry::Codec>(codec);
+  GeometryWriter::CheckFormat(version, blockCodec);
+  this->OutputVersion = version;
+  this->OutputCodec = blockCodec;
+}
+
 void GeometryGenerator::PreExecute() {}
 
 void GeometryGenerator::Execute(bool skipNonIntersectingBlocks) {
@@ -39,7 +47,8 @@ void GeometryGenerator::Execute(bool skipNonIntersectingBlocks) {
   Domain domain(this->OriginWorking, this->SiteCounts);
 
   GeometryWriter writer(this->OutputGeometryFile, domain.GetBlockSize(),
-                        domain.GetBlockCounts());
+                        domain.GetBlockCounts(), this->OutputVersion,
+                        this->OutputCodec);
 
   for (BlockIterator blockIt = domain.begin(); blockIt != domain.end();
        ++blockIt) {
@@ -105,11 +114,20 @@ void GeometryGenerator::Execute(bool skipNonIntersectingBlocks) {
 }
 
 void GeometryGenerator::WriteSolidSite(BlockWriter& blockWriter, Site& site) {
+  if (blockWriter.IsVersion5()) {
+    blockWriter.WriteSolidSiteRecord();
+    return;
+  }
   blockWriter << static_cast<unsigned int>(geometry::SiteType::SOLID);
   // That's all in this case.
 }
 
 void GeometryGenerator::WriteFluidSite(BlockWriter& blockWriter, Site& site) {
+  if (blockWriter.IsVersion5()) {
+    blockWriter.WriteFluidSiteRecord(site.Links, site.WallNormalAvailable,
+                                     site.WallNormal);
+    return;
+  }
   blockWriter << static_cast<unsigned int>(geometry::SiteType::FLUID);
 
   // Iterate over the displacements of the neighbourhood
@@ -6,11 +6,13 @@
 #ifndef HEMELBSETUPTOOL_GEOMETRYGENERATOR_H
 #define HEMELBSETUPTOOL_GEOMETRYGENERATOR_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "GenerationError.h"
 #include "Iolet.h"
+#include "io/formats/geometry.h"
 
 class GeometryWriter;
 class Site;
@@ -30,6 +32,11 @@ class GeometryGenerator {
     this->OutputGeometryFile = val;
   }
 
+  // Write GMY version 4 (the default) or version 5, whose blocks are
+  // compressed with the given codec (a geometry::Codec value). Throws
+  // GenerationErrorMessage for a version or codec that can't be written.
+  void SetOutputFormat(std::uint32_t version, std::uint32_t codec);
+
   inline std::vector<Iolet>& GetIolets() { return this->Iolets; }
   inline std::vector<Iolet> const& GetIolets() const { return this->Iolets; }
   inline void SetIolets(std::vector<Iolet> iv) { this->Iolets = iv; }
@@ -66,6 +73,9 @@ class GeometryGenerator {
   void WriteSolidSite(BlockWriter& blockWriter, Site& site);
   void WriteFluidSite(BlockWriter& blockWriter, Site& site);
   // Members set from outside to initialise
+  std::uint32_t OutputVersion = hemelb::io::formats::geometry::VersionNumber;
+  hemelb::io::formats::geometry::Codec OutputCodec =
+      hemelb::io::formats::geometry::Codec::ZLIB;
   double OriginWorking[3];
   unsigned SiteCounts[3];
   std::string OutputGeometryFile;
@@ -6,6 +6,7 @@
 #include "GeometryWriter.h"
 #include "BlockWriter.h"
 #include "BufferPool.h"
+#include "GenerationError.h"
 
 #include "io/formats/formats.h"
 #include "io/formats/geometry.h"
@@ -16,8 +17,16 @@ using hemelb::io::formats::geometry;
 
 GeometryWriter::GeometryWriter(const std::string& OutputGeometryFile,
                                int BlockSize,
-                               Index BlockCounts)
-    : OutputGeometryFile(OutputGeometryFile), BlockSize(BlockSize) {
+                               Index BlockCounts,
+                               std::uint32_t Version,
+                               geometry::Codec BlockCodec)
+    : OutputGeometryFile(OutputGeometryFile),
+      BlockSize(BlockSize),
+      Version(Version),
+      BlockCodec(BlockCodec),
+      headerPosition(0) {
+  CheckFormat(Version, BlockCodec);
+
   this->BlockBufferPool =
       new BufferPool(geometry::GetMaxBlockRecordLength(BlockSize));
 
@@ -37,8 +46,7 @@ GeometryWriter::GeometryWriter(const std::string& OutputGeometryFile,
     encoder << static_cast<unsigned int>(
         hemelb::io::formats::geometry::MagicNumber);
     // Geometry file format version number
-    encoder << static_cast<unsigned int>(
-        hemelb::io::formats::geometry::VersionNumber);
+    encoder << static_cast<unsigned int>(this->Version);
 
     // Blocks in each dimension
     for (unsigned int i = 0; i < 3; ++i)
@@ -47,8 +55,10 @@ GeometryWriter::GeometryWriter(const std::string& OutputGeometryFile,
     // Sites along 1 dimension of a block
     encoder << this->BlockSize;
 
-    // padding
-    encoder << 0U;
+    // Padding in version 4, the block codec in version 5
+    encoder << (this->Version == geometry::VersionNumberV5
+                    ? static_cast<unsigned int>(this->BlockCodec)
+                    : 0U);
     // TODO: Check that buffer length is 32 bytes
 
     // (Dummy) Header
@@ -62,14 +72,18 @@ GeometryWriter::GeometryWriter(const std::string& OutputGeometryFile,
     // We need to write HeaderRecordLength * nBlocks worth of junk bytes.
     // The smallest unit XDR will write is 32 bits, so divide by 4 and
     // write that many zeros
-    unsigned int headerLengthInXdrWords =
-        hemelb::io::formats::geometry::HeaderRecordLength * nBlocks / 4;
+    unsigned int headerRecordLength =
+        this->Version == geometry::VersionNumberV5
+            ? geometry::HeaderRecordLengthV5
+            : geometry::HeaderRecordLength;
+    unsigned int headerLengthInXdrWords = headerRecordLength * nBlocks / 4;
     // Write a dummy header
     for (unsigned int i = 0; i < headerLengthInXdrWords; ++i) {
       encoder << 0;
     }
 
     this->bodyStart = encoder.getCurrentStreamPosition();
+    this->bodyPosition = this->bodyStart;
 
     // Setup the encoder for the header
     this->headerBufferLength = this->bodyStart - this->headerStart;
@@ -83,6 +97,21 @@ GeometryWriter::GeometryWriter(const std::string& OutputGeometryFile,
   this->bodyFile = std::fopen(this->OutputGeometryFile.c_str(), "a");
 }
 
+void GeometryWriter::CheckFormat(std::uint32_t Version,
+                                 geometry::Codec BlockCodec) {
+  if (Version != geometry::VersionNumber &&
+      Version != geometry::VersionNumberV5)
+    throw GenerationErrorMessage("Can only write GMY versions 4 and 5");
+  if (BlockCodec != geometry::Codec::NONE &&
+      BlockCodec != geometry::Codec::ZLIB)
+    throw GenerationErrorMessage(
+        "Unknown GMY block codec " +
+        std::to_string(static_cast<std::uint32_t>(BlockCodec)));
+  if (Version == geometry::VersionNumber &&
+      BlockCodec != geometry::Codec::ZLIB)
+    throw GenerationErrorMessage("GMY version 4 blocks are always zlib");
+}
+
 GeometryWriter::~GeometryWriter() {
   delete this->headerEncoder;
   delete[] this->headerBuffer;
@@ -105,5 +134,6 @@ void GeometryWriter::Close() {
 }
 
 BlockWriter* GeometryWriter::StartNextBlock() {
-  return new BlockWriter(this->BlockBufferPool);
+  return new BlockWriter(this->BlockBufferPool, this->Version,
+                         this->BlockCodec);
 }
@@ -6,11 +6,14 @@
 #ifndef HEMELBSETUPTOOL_GEOMETRYWRITER_H
 #define HEMELBSETUPTOOL_GEOMETRYWRITER_H
 
+#include <cstdint>
 #include <cstdio>
 #include <string>
 
 #include "Index.h"
 
+#include "io/formats/geometry.h"
+
 #include "io/writers/XdrWriter.h"
 using hemelb::io::XdrWriter;
 
@@ -21,10 +24,20 @@ class GeometryWriter {
  public:
   GeometryWriter(const std::string& OutputGeometryFile,
                  int BlockSize,
-                 Index BlockCounts);
+                 Index BlockCounts,
+                 std::uint32_t Version =
+                     hemelb::io::formats::geometry::VersionNumber,
+                 hemelb::io::formats::geometry::Codec BlockCodec =
+                     hemelb::io::formats::geometry::Codec::ZLIB);
 
   ~GeometryWriter();
 
+  // Throw GenerationErrorMessage unless this version and codec can be
+  // written: version 4 blocks are always zlib, version 5 blocks are
+  // stored as is or zlib.
+  static void CheckFormat(std::uint32_t Version,
+                          hemelb::io::formats::geometry::Codec BlockCodec);
+
   void Close();
   BlockWriter* StartNextBlock();
 
@@ -32,11 +45,18 @@ class GeometryWriter {
   std::string OutputGeometryFile;
   int BlockSize;
   Index BlockCounts;
+  // GMY version (4 or 5) and, for version 5, how blocks are compressed.
+  std::uint32_t Version;
+  hemelb::io::formats::geometry::Codec BlockCodec;
 
   int headerStart;
   XdrWriter* headerEncoder;
   unsigned int headerBufferLength;
   char* headerBuffer;
+  // Version 5 headers are written directly into headerBuffer, with the
+  // absolute file offset of each block.
+  unsigned int headerPosition;
+  std::uint64_t bodyPosition;
 
   int bodyStart;
   FILE* bodyFile;
@@ -66,6 +66,7 @@ PYBIND11_MODULE(Generation, mod) {
                &GeometryGenerator::GetOutputGeometryFile)
           .def("SetOutputGeometryFile",
                &GeometryGenerator::SetOutputGeometryFile)
+          .def("SetOutputFormat", &GeometryGenerator::SetOutputFormat)
           .def("GetIolets", py::overload_cast<>(&GeometryGenerator::GetIolets))
           .def("SetIolets", &GeometryGenerator::SetIolets)
           .def("SetOriginWorking", &GeometryGenerator::SetOriginWorking)
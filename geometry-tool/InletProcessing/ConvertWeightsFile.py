@@ -0,0 +1,48 @@
+# This file is part of HemeLB and is Copyright (C)
+# the HemeLB team and/or their institutions, as detailed in the
+# file AUTHORS. This software is provided under the terms of the
+# license in the file LICENSE.
+
+import struct
+
+# Must match VELOCITY_WEIGHTS_MAGIC in Code/lb/iolets/InOutLetFileVelocity.h
+MAGIC = b"HLBVWGT1"
+RECORD = struct.Struct("<iiid")
+
+
+def ConvertInletWeightsFile(fname_in, fname_out):
+    """This function converts a textual weights file, with lines
+
+    <lattice x coord> <lattice y coord> <lattice z coord> <weight>
+
+    to the binary form HemeLB reads much faster: the magic bytes, the
+    number of records as an unsigned 64-bit integer, then for each site
+    its coordinates as 32-bit integers and its weight as a 64-bit float,
+    all little-endian and sorted by site. Where a site appears more than
+    once, the last weight is kept.
+    """
+    weights = {}
+    with open(fname_in) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) < 4:
+                continue
+            site = tuple(int(c) for c in fields[:3])
+            weights[site] = float(fields[3])
+
+    with open(fname_out, "wb") as f:
+        f.write(MAGIC)
+        f.write(struct.pack("<Q", len(weights)))
+        for site in sorted(weights):
+            f.write(RECORD.pack(*site, weights[site]))
+
+
+if __name__ == "__main__":
+    import sys
+
+    if len(sys.argv) < 3:
+        print(
+            "Usage: python <script_name> <input weights.txt file name> <output weights.bin file name>"
+        )
+        sys.exit()
+    ConvertInletWeightsFile(sys.argv[1], sys.argv[2])